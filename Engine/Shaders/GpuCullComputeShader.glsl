@@ -0,0 +1,148 @@
+#version 450
+
+layout(local_size_x = 64) in;
+
+struct CullObject
+{
+    mat4 transform;
+    // Local bounding sphere, a negative radius is never culled
+    vec4 sphere;
+    vec3 extent;
+    uint groupIndex;
+};
+
+struct CullGroup
+{
+    uint indexCount;
+    uint firstIndex;
+    int vertexOffset;
+    uint commandOffset;
+};
+
+struct DrawCommand
+{
+    uint indexCount;
+    uint instanceCount;
+    uint firstIndex;
+    int vertexOffset;
+    uint firstInstance;
+};
+
+layout(std430, set = 0, binding = 0) readonly buffer ObjectBuffer
+{
+    mat4 viewProjection;
+    vec4 frustumPlanes[6];
+    CullObject objects[];
+};
+
+layout(std430, set = 0, binding = 1) readonly buffer GroupBuffer
+{
+    CullGroup groups[];
+};
+
+layout(std430, set = 0, binding = 2) writeonly buffer CommandBuffer
+{
+    DrawCommand commands[];
+};
+
+layout(std430, set = 0, binding = 3) buffer CountBuffer
+{
+    uint counts[];
+};
+
+layout(std430, set = 0, binding = 4) writeonly buffer InstanceBuffer
+{
+    mat4 instances[];
+};
+
+// Hi-Z pyramid of this frame's depth, only sampled once the depth pass ran
+layout(set = 0, binding = 5) uniform sampler2D depthPyramid;
+
+layout(push_constant) uniform PushConstants
+{
+    uint objectCount;
+    uint isOcclusionCulled;
+    vec2 depthSize;
+} pc;
+
+// Reverse-Z, the box is hidden once its nearest depth is farther than the farthest depth under it
+bool IsOccluded(vec3 center, vec3 extent)
+{
+    vec2 minUV = vec2(1.0);
+    vec2 maxUV = vec2(0.0);
+    float nearestDepth = 0.0;
+    for (int i = 0; i < 8; i++)
+    {
+        vec3 corner = center + extent * vec3((i & 1) != 0 ? 1.0 : -1.0, (i & 2) != 0 ? 1.0 : -1.0, (i & 4) != 0 ? 1.0 : -1.0);
+        vec4 clip = viewProjection * vec4(corner, 1.0);
+        // The box crosses the camera plane, its projection is unbounded
+        if (clip.w <= 0.0)
+            return false;
+
+        vec3 ndc = clip.xyz / clip.w;
+        vec2 uv = ndc.xy * 0.5 + 0.5;
+        minUV = min(minUV, uv);
+        maxUV = max(maxUV, uv);
+        nearestDepth = max(nearestDepth, ndc.z);
+    }
+
+    ivec2 maxPixel = ivec2(pc.depthSize) - 1;
+    ivec2 minCoord = min(ivec2(clamp(minUV, 0.0, 1.0) * pc.depthSize), maxPixel);
+    ivec2 maxCoord = min(ivec2(clamp(maxUV, 0.0, 1.0) * pc.depthSize), maxPixel);
+
+    // A texel of level n covers 2^(n+1) pixels, the first level where the rectangle spans at most two texels.
+    // The last level is a single texel
+    ivec2 span = maxCoord - minCoord + 1;
+    int level = min(max(findMSB(max(span.x, span.y) - 1), 0), textureQueryLevels(depthPyramid) - 1);
+
+    ivec2 levelSize = textureSize(depthPyramid, level);
+    minCoord = min(minCoord >> (level + 1), levelSize - 1);
+    maxCoord = min(maxCoord >> (level + 1), levelSize - 1);
+
+    float farthestDepth = min(min(texelFetch(depthPyramid, minCoord, level).r, texelFetch(depthPyramid, ivec2(maxCoord.x, minCoord.y), level).r),
+                              min(texelFetch(depthPyramid, ivec2(minCoord.x, maxCoord.y), level).r, texelFetch(depthPyramid, maxCoord, level).r));
+
+    return nearestDepth < farthestDepth;
+}
+
+bool IsVisible(CullObject object)
+{
+    if (object.sphere.w < 0.0)
+        return true;
+
+    mat4 transform = object.transform;
+    vec3 center = (transform * vec4(object.sphere.xyz, 1.0)).xyz;
+    // Box of the rotated box, the absolute matrix maps half extents to half extents
+    vec3 extent = abs(transform[0].xyz) * object.extent.x + abs(transform[1].xyz) * object.extent.y + abs(transform[2].xyz) * object.extent.z;
+    float scale = max(length(transform[0].xyz), max(length(transform[1].xyz), length(transform[2].xyz)));
+    float radius = object.sphere.w * scale;
+
+    // Same test as the CPU culler, outside once either the sphere or the box is behind one plane
+    for (int i = 0; i < 6; i++)
+    {
+        vec4 plane = frustumPlanes[i];
+        float planeDistance = dot(plane.xyz, center) + plane.w;
+        float reach = min(dot(abs(plane.xyz), extent), radius);
+        if (planeDistance + reach < 0.0)
+            return false;
+    }
+
+    return pc.isOcclusionCulled == 0u || !IsOccluded(center, extent);
+}
+
+void main()
+{
+    uint objectIndex = gl_GlobalInvocationID.x;
+    if (objectIndex >= pc.objectCount)
+        return;
+
+    CullObject object = objects[objectIndex];
+    if (!IsVisible(object))
+        return;
+
+    instances[objectIndex] = viewProjection * object.transform;
+
+    CullGroup group = groups[object.groupIndex];
+    uint slot = atomicAdd(counts[object.groupIndex], 1u);
+    commands[group.commandOffset + slot] = DrawCommand(group.indexCount, 1u, group.firstIndex, group.vertexOffset, objectIndex);
+}
\ No newline at end of file
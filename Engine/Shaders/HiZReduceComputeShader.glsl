@@ -0,0 +1,48 @@
+#version 450
+
+layout(local_size_x = 8, local_size_y = 8) in;
+
+// Depth target or the previous level, bound as a single level view
+layout(set = 0, binding = 0) uniform sampler2D source;
+// Farthest depth in r and nearest in g, reverse-Z keeps the farthest as the minimum
+layout(rg32f, set = 0, binding = 1) uniform writeonly image2D destination;
+
+layout(push_constant) uniform PushConstants
+{
+    ivec2 sourceSize;
+    ivec2 destinationSize;
+    uint isDepthSource;
+} pc;
+
+vec2 Fetch(ivec2 coord)
+{
+    vec4 texel = texelFetch(source, min(coord, pc.sourceSize - 1), 0);
+    return pc.isDepthSource != 0u ? texel.rr : texel.rg;
+}
+
+void main()
+{
+    ivec2 coord = ivec2(gl_GlobalInvocationID.xy);
+    if (any(greaterThanEqual(coord, pc.destinationSize)))
+        return;
+
+    // Levels are halved rounding down, the last texel of an odd source also covers the extra row or column
+    ivec2 sourceCoord = coord * 2;
+    ivec2 footprint = ivec2(2);
+    if (coord.x == pc.destinationSize.x - 1 && (pc.sourceSize.x & 1) != 0)
+        footprint.x = 3;
+    if (coord.y == pc.destinationSize.y - 1 && (pc.sourceSize.y & 1) != 0)
+        footprint.y = 3;
+
+    vec2 depthRange = vec2(1.0, 0.0);
+    for (int y = 0; y < footprint.y; y++)
+    {
+        for (int x = 0; x < footprint.x; x++)
+        {
+            vec2 texel = Fetch(sourceCoord + ivec2(x, y));
+            depthRange = vec2(min(depthRange.x, texel.x), max(depthRange.y, texel.y));
+        }
+    }
+
+    imageStore(destination, coord, vec4(depthRange, 0.0, 0.0));
+}
\ No newline at end of file
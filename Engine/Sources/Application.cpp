@@ -1,94 +1,311 @@
 #include "Application.h"
 #include "Graphic/VulkanDevice.h"
+#include "Graphic/VulkanImage.h"
+#include "Graphic/VulkanImageView.h"
 #include "Graphic/Window.h"
+#include "Graphic/VulkanSurface.h"
 #include "Graphic/VulkanBufferManager.h"
 #include "Graphic/VulkanCommandBufferManager.h"
+#include "Graphic/VulkanRingBuffer.h"
+#include "Graphic/VulkanMemoryAllocator.h"
+#include "Graphic/VulkanMemoryDefragmenter.h"
+#include "Graphic/VulkanAsyncUploader.h"
+#include "Graphic/VulkanDeletionQueue.h"
+#include "Graphic/VulkanTimelineSemaphore.h"
+#include "Graphic/VulkanDescriptorAllocator.h"
 #include "Input/InputSystem.h"
+#include "Job/JobSystem.h"
 #include "Render/RenderSystem.h"
 #include "Render/ForwardRenderer.h"
 #include "Render/Frame.h"
+#include "Render/FramePacer.h"
+#include "Render/FrustumCuller.h"
+#include "Render/GpuCuller.h"
+#include "Render/GraphicPipelineCache.h"
+#include "Render/RenderPassCache.h"
+#include "Render/FramebufferCache.h"
+#include "Render/RenderTargetPool.h"
+#include "Graphic/VulkanPipelineCache.h"
 #include "Scene/Scene.h"
+#include "Debug/CpuProfiler.h"
+#include "Debug/GpuProfiler.h"
 
 #include <stdexcept>
 #include <string>
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <format>
 
 
 namespace ZE {
 
 const std::string AppName("ZEngine");
-const glm::ivec2 size{800, 800};
 
-Application::Application()
-    : _renderer(nullptr)
+Application::Application(const ApplicationConfig& config)
+    : _config(config), _renderer(nullptr)
 {
-    RenderSystem::Initialize();
+#ifdef ZE_CPU_PROFILER
+    CpuProfiler::Initialize();
+    CpuProfiler::Get().SetHitchLogEnabled(_config.logCpuHitches);
+#endif
+    JobSystem::Initialize(_config.jobWorkerCount, _config.isJobAffinityEnabled);
+    RenderSystem::Initialize(_config.headless, std::max(_config.framesInFlight, 1u));
     InputSystem::Initialize();
 
-    _window = std::make_shared<Window>(AppName, size);
-    _window->CreateSurfaceAndSwapchain(RenderSystem::Get().GetDevice());
+    TPtr<VulkanDevice> device = RenderSystem::Get().GetDevice();
 
-    InputSystem::Get().AttachTo(_window);
+    if (!_config.headless)
+    {
+        _window = std::make_shared<Window>(AppName, _config.size);
+        _window->CreateSurfaceAndSwapchain(device, _config.presentMode, _config.swapchainImageCount);
+
+        InputSystem::Get().AttachTo(_window);
+    }
+
+    _framePacer = std::make_shared<FramePacer>(_window != nullptr ? _window->GetSwapchain() : nullptr);
+    _framePacer->SetMaxFrameRate(_config.maxFrameRate);
+    _framePacer->SetMaxQueuedFrames(_config.maxQueuedFrames);
+
+    TPtr<ForwardRenderer> forwardRenderer = std::make_shared<ForwardRenderer>(_config.uploadByteBudget, _config.uploadMillisecondBudget);
+    forwardRenderer->SetGpuCulling(_config.gpuCulling);
+    _renderer = forwardRenderer;
+
+    for (uint32_t i = 0; i < std::max(_config.framesInFlight, 1u); i++)
+    {
+        _frames.push_back(std::make_shared<Frame>(device, i));
+
+        if (_config.headless)
+        {
+            VkExtent3D extent{static_cast<uint32_t>(_config.size.x), static_cast<uint32_t>(_config.size.y), 1};
+            TPtr<VulkanImage> target = std::make_shared<VulkanImage>(device, extent, VkFormat::VK_FORMAT_B8G8R8A8_UNORM, VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, EVulkanMemoryCategory::RenderTarget);
+            _offscreenTargets.push_back(std::make_shared<VulkanImageView>(target));
+        }
+    }
 
-    _renderer = std::make_shared<ForwardRenderer>();
+#ifdef ZE_GPU_PROFILER
+    GpuProfiler::Initialize(device, static_cast<uint32_t>(_frames.size()));
+    GpuProfiler::Get().SetLogEnabled(_config.logGpuTimings);
+    GpuProfiler::Get().SetDrawScopesEnabled(_config.gpuDrawScopes);
+#endif
 }
 
 Application::~Application()
 {
+#ifdef ZE_GPU_PROFILER
+    GpuProfiler::Cleanup();
+#endif
+    _frames.clear();
+    _offscreenTargets.clear();
     _renderer.reset();
+    _framePacer.reset();
 
-    InputSystem::Get().DetachFrom(_window);
+    if (_window != nullptr)
+    {
+        InputSystem::Get().DetachFrom(_window);
 
-    _window->UnregisterInput(InputSystem::Get());
-    _window.reset();
+        _window->UnregisterInput(InputSystem::Get());
+        _window.reset();
+    }
 
     InputSystem::Cleanup();
     RenderSystem::Cleanup();
+    JobSystem::Cleanup();
+#ifdef ZE_CPU_PROFILER
+    CpuProfiler::Cleanup();
+#endif
 }
 
-void Application::Run(TPtr<Scene> scene)
+bool Application::ShouldClose(uint64_t frameCount)
 {
-    scene->Load();
+    if (_config.maxFrames > 0 && frameCount >= _config.maxFrames)
+        return true;
 
-    _renderer->Init(scene);
+    return _window != nullptr && _window->ShouldClose();
+}
 
-    TPtr<Frame> LastFrame;
-    while (!_window->ShouldClose())
+bool Application::RenderOneFrame(TPtr<Scene> scene, uint64_t frameNumber)
+{
+    TPtr<VulkanQueue> graphicQueue = RenderSystem::Get().GetQueue(VulkanQueue::EType::Graphic);
+    VkSemaphore frameTimeline = RenderSystem::Get().GetFrameTimeline()->GetRawSemaphore();
+
+    size_t slot = frameNumber % _frames.size();
+    TPtr<Frame> frame = _frames[slot];
+
+    if (_config.headless)
     {
-        glfwPollEvents();
+        {
+            ZE_CPU_SCOPE("Frame::Begin");
+            frame->Begin(_offscreenTargets[slot]);
+        }
 
+        TPtr<VulkanCommandBuffer> commandBuffer = frame->GetCachedCommandBuffer();
+        _renderer->RenderFrame(commandBuffer, scene, frame);
+
+        VulkanSubmitBatch batch{{commandBuffer}, frame->GetWaitArr(), {{frameTimeline, frame->GetTimelineValue(), VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT}}};
 
+        // Same submission, so the copy is ordered after the final layout transition of the frame
+        if (_config.readback)
+            batch.commandBufferArr.push_back(frame->RecordReadback(frameNumber, _config.readback));
+
+        ZE_CPU_SCOPE("VulkanQueue::Submit");
+        graphicQueue->Submit({batch});
+    }
+    else
+    {
         TPtr<VulkanSwapchain> swapchain = _window->GetSwapchain();
-        TPtr<Frame> frame = make_shared<Frame>(RenderSystem::Get().GetDevice(), swapchain);
-        TPtr<VulkanCommandBuffer> commandBuffer = frame->GetCachedCommandBuffer();
+        {
+            ZE_CPU_SCOPE("Frame::Begin");
+            if (!frame->Begin(swapchain))
+                return false;
+        }
 
-        // vkWaitForFences(vkDevice, 1, &_inFlightFence, VK_TRUE, UINT64_MAX);
-        // vkResetFences(vkDevice, 1, &_inFlightFence);
+        TPtr<VulkanCommandBuffer> commandBuffer = frame->GetCachedCommandBuffer();
 
         _renderer->RenderFrame(commandBuffer, scene, frame);
 
-        std::vector<VkSemaphore> waitSemaphores{frame->GetAvailableSemaphore()};
-        std::vector<VkPipelineStageFlags> waitStages{VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT};
+        VkSemaphore submitSemaphore = frame->GetRenderFinishedSemaphore();
+
+        {
+            ZE_CPU_SCOPE("VulkanQueue::Submit");
+            // Presentation only takes binary semaphores, the frame timeline tracks completion
+            VulkanSubmitBatch batch{{commandBuffer}, frame->GetWaitArr(), {{submitSemaphore, 0, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT}, {frameTimeline, frame->GetTimelineValue(), VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT}}};
+            graphicQueue->Submit({batch});
+        }
+        {
+            ZE_CPU_SCOPE("VulkanQueue::Present");
+            graphicQueue->Present(swapchain, {submitSemaphore}, _framePacer->NextPresentId());
+        }
+    }
+
+    {
+        ZE_CPU_SCOPE("RenderSystem::Tick");
+        RenderSystem::Get().Tick();
+    }
+
+    return true;
+}
+
+void Application::Run(TPtr<Scene> scene)
+{
+    scene->SetFixedTimeStep(_config.fixedTimeStep);
+    scene->Load();
 
-        VkSemaphore submitSemaphore = RenderSystem::Get().GetDevice()->CreateGraphicSemaphore();
-        frame->PutSemaphore(submitSemaphore);
+    _renderer->Init(scene);
 
-        TPtr<VulkanQueue> graphicQueue = RenderSystem::Get().GetQueue(VulkanQueue::EType::Graphic);
-        graphicQueue->Submit(commandBuffer, waitSemaphores, waitStages, {submitSemaphore}, frame->GetFence());
-        graphicQueue->Present(swapchain, {submitSemaphore});
+    std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+    std::chrono::steady_clock::time_point tickTime = startTime;
 
-        if (frame)
+    uint64_t frameCount = 0;
+    while (!ShouldClose(frameCount))
+    {
+#ifdef ZE_CPU_PROFILER
+        CpuProfiler::Get().BeginFrame();
+#endif
+
+        // Before input is polled, so the frame samples it as late as possible
+        _framePacer->WaitForNextFrame();
+
+        if (_window != nullptr)
         {
-            VkFence fence = frame->GetFence();
-            vkWaitForFences(RenderSystem::Get().GetDevice()->GetRawDevice(), 1, &fence, VK_TRUE, UINT64_MAX);
+            ZE_CPU_SCOPE("PollEvents");
+            glfwPollEvents();
         }
-        LastFrame = frame;
 
-        RenderSystem::Get().GetBufferManager()->Tick();
+        if (_config.beginFrame)
+            _config.beginFrame(scene, frameCount);
+
+        // Headless runs step exactly once per frame so their output doesn't depend on timing
+        std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        std::chrono::duration<float> deltaTime = now - tickTime;
+        tickTime = now;
+        scene->Tick(_config.headless ? _config.fixedTimeStep : deltaTime.count());
+
+        bool isRendered = RenderOneFrame(scene, frameCount);
+
+#ifdef ZE_CPU_PROFILER
+        CpuProfiler::Get().EndFrame();
+#endif
+
+        if (isRendered)
+            frameCount++;
     }
 
+    // Deliver the readbacks still in flight, oldest first
+    for (size_t i = 0; i < _frames.size(); i++)
+        _frames[(frameCount + i) % _frames.size()]->FlushReadback();
+
     RenderSystem::Get().GetDevice()->WaitIdle();
 
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - startTime;
+    if (frameCount > 0 && elapsed.count() > 0.0)
+    {
+        std::cout << std::format("{} frames in {:.3f} s, {:.1f} fps, {:.3f} ms/frame", frameCount, elapsed.count(), frameCount / elapsed.count(), elapsed.count() * 1000.0 / frameCount) << std::endl;
+    }
+
+#ifdef ZE_GPU_PROFILER
+    GpuProfiler::Get().Flush();
+#endif
+
     scene->Unload();
 }
 
+void Application::ReportStats(std::ostream& stream)
+{
+    TPtr<GraphicPipelineCache> pipelineCache = RenderSystem::Get().GetPipelineCache();
+    bool isWarmStart = RenderSystem::Get().GetDriverPipelineCache()->IsLoadedFromDisk();
+    stream << std::format("pipeline cache: {} pipelines, {} hits, {} misses, {} evicted, {} start", pipelineCache->GetSize(), pipelineCache->GetHitCount(), pipelineCache->GetMissCount(), pipelineCache->GetEvictionCount(), isWarmStart ? "warm" : "cold") << std::endl;
+    TPtr<RenderPassCache> renderPassCache = RenderSystem::Get().GetRenderPassCache();
+    TPtr<FramebufferCache> framebufferCache = RenderSystem::Get().GetFramebufferCache();
+    stream << std::format("render pass cache: {} render passes, {} hits, {} misses", renderPassCache->GetSize(), renderPassCache->GetHitCount(), renderPassCache->GetMissCount()) << std::endl;
+    stream << std::format("framebuffer cache: {} framebuffers, {} hits, {} misses", framebufferCache->GetSize(), framebufferCache->GetHitCount(), framebufferCache->GetMissCount()) << std::endl;
+    TPtr<RenderTargetPool> renderTargetPool = RenderSystem::Get().GetRenderTargetPool();
+    stream << std::format("render target pool: {} targets, {} allocations, {} reuses", renderTargetPool->GetSize(), renderTargetPool->GetAllocationCount(), renderTargetPool->GetReuseCount()) << std::endl;
+    TPtr<VulkanBufferManager> bufferManager = RenderSystem::Get().GetBufferManager();
+    stream << std::format("staging ring: {:.1f} of {:.1f} MB peak, {} temporary buffers", bufferManager->GetPeakUsedSize() / (1024.0 * 1024.0), bufferManager->GetRingSize() / (1024.0 * 1024.0), bufferManager->GetTemporaryBufferCount()) << std::endl;
+    TPtr<VulkanRingBuffer> uniformRingBuffer = RenderSystem::Get().GetUniformRingBuffer();
+    TPtr<VulkanAsyncUploader> asyncUploader = RenderSystem::Get().GetAsyncUploader();
+    stream << std::format("async uploads: {} submissions, {:.1f} MB", asyncUploader->GetSubmissionCount(), asyncUploader->GetUploadedSize() / (1024.0 * 1024.0)) << std::endl;
+    stream << std::format("uniform ring: {} of {} bytes peak per frame", uniformRingBuffer->GetPeakUsedSize(), uniformRingBuffer->GetRegionSize()) << std::endl;
+    TPtr<VulkanDescriptorAllocator> descriptorAllocator = RenderSystem::Get().GetDescriptorAllocator();
+    stream << std::format("descriptor sets: {} allocations from {} pools", descriptorAllocator->GetAllocationCount(), descriptorAllocator->GetPoolCount()) << std::endl;
+    TPtr<VulkanMemoryAllocator> memoryAllocator = RenderSystem::Get().GetDevice()->GetMemoryAllocator();
+    VulkanMemoryStats memoryStats = memoryAllocator->GetStats();
+    stream << std::format("device memory: {} allocations in {} blocks and {} dedicated, {:.1f} of {:.1f} MB used", memoryStats.allocationCount, memoryStats.blockCount, memoryStats.dedicatedCount, memoryStats.usedSize / (1024.0 * 1024.0), memoryStats.reservedSize / (1024.0 * 1024.0)) << std::endl;
+    for (uint32_t i = 0; i < static_cast<uint32_t>(EVulkanMemoryCategory::Count); i++)
+    {
+        EVulkanMemoryCategory category = static_cast<EVulkanMemoryCategory>(i);
+        VulkanMemoryCategoryStats categoryStats = memoryAllocator->GetCategoryStats(category);
+        stream << std::format("  {}: {} allocations, {:.1f} MB", VulkanMemoryAllocator::GetCategoryName(category), categoryStats.allocationCount, categoryStats.usedSize / (1024.0 * 1024.0)) << std::endl;
+    }
+    for (uint32_t i = 0; i < memoryAllocator->GetHeapCount(); i++)
+    {
+        VulkanMemoryHeapStats heapStats = memoryAllocator->GetHeapStats(i);
+        stream << std::format("  heap {}: {:.1f} MB reserved, {:.1f} of {:.1f} MB budget", i, heapStats.reservedSize / (1024.0 * 1024.0), heapStats.usage / (1024.0 * 1024.0), heapStats.budget / (1024.0 * 1024.0)) << std::endl;
+    }
+    TPtr<VulkanMemoryDefragmenter> memoryDefragmenter = RenderSystem::Get().GetMemoryDefragmenter();
+    stream << std::format("defragmentation: {} buffers moved, {:.1f} MB copied", memoryDefragmenter->GetMoveCount(), memoryDefragmenter->GetMovedSize() / (1024.0 * 1024.0)) << std::endl;
+    if (_window != nullptr)
+        stream << std::format("present mode: {}, {} requested", VulkanSurface::GetPresentModeName(_window->GetSurface()->GetPresentMode()), VulkanSurface::GetPresentModeName(_config.presentMode)) << std::endl;
+    stream << std::format("frame pacing: {:.1f} ms waiting for queued frames, {:.1f} ms in the limiter, present wait {}", _framePacer->GetQueueWaitTime() * 1000.0, _framePacer->GetLimiterWaitTime() * 1000.0, _framePacer->IsPresentWaitEnabled() ? "on" : "off") << std::endl;
+    if (TPtr<ForwardRenderer> forwardRenderer = std::dynamic_pointer_cast<ForwardRenderer>(_renderer))
+    {
+        TPtr<FrustumCuller> frustumCuller = forwardRenderer->GetFrustumCuller();
+        stream << std::format("frustum culling: {} of {} objects culled", frustumCuller->GetCulledCount(), frustumCuller->GetTestedCount()) << std::endl;
+        if (TPtr<GpuCuller> gpuCuller = forwardRenderer->GetGpuCuller())
+            stream << std::format("gpu culling: {} objects in {} draw groups", gpuCuller->GetObjectCount(), gpuCuller->GetDrawGroupCount()) << std::endl;
+    }
+    JobSystem& jobSystem = JobSystem::Get();
+    stream << std::format("jobs: {} workers, {} jobs, {} stolen", jobSystem.GetWorkerCount(), jobSystem.GetJobCount(), jobSystem.GetStealCount()) << std::endl;
+    TPtr<VulkanDeletionQueue> deletionQueue = RenderSystem::Get().GetDeletionQueue();
+    stream << std::format("deletion queue: {} objects destroyed, {} pending", deletionQueue->GetDeletionCount(), deletionQueue->GetPendingCount()) << std::endl;
+
+#ifdef ZE_CPU_PROFILER
+    CpuProfiler::Get().Report(stream);
+#endif
+#ifdef ZE_GPU_PROFILER
+    GpuProfiler::Get().Report(stream);
+#endif
+}
+
 } // namespace ZE
\ No newline at end of file
@@ -2,8 +2,13 @@
 
 #include "CoreDefines.h"
 #include "CoreTypes.h"
+#include "Render/Frame.h"
+
+#include <glm/glm.hpp>
 
 #include <memory>
+#include <functional>
+#include <ostream>
 
 
 namespace ZE {
@@ -11,18 +16,75 @@ namespace ZE {
 class Window;
 class RendererInterface;
 class Scene;
+class VulkanImageView;
+class FramePacer;
+
+// Runs on the main thread before the scene ticks, objects may be added to or removed from the scene
+typedef std::function<void(TPtr<Scene> scene, uint64_t frameNumber)> FrameCallback;
+
+struct ApplicationConfig
+{
+    // Renders into engine owned images, no window, surface or swapchain is created
+    bool headless = false;
+    glm::ivec2 size{800, 800};
+    uint32_t framesInFlight = 2;
+    // Stops after this many frames, 0 runs until the window is closed
+    uint64_t maxFrames = 0;
+    // Headless only, receives every rendered frame once it has completed on the GPU
+    ReadbackCallback readback;
+    FrameCallback beginFrame;
+    // Prints the GPU pass timings of every frame once they are read back
+    bool logGpuTimings = false;
+    // Prints the CPU scopes of every frame slower than twice the median
+    bool logCpuHitches = false;
+    // Adds a timestamp pair around every draw, not only around every pass
+    bool gpuDrawScopes = false;
+    // Per frame limits for building the GPU resources of newly added objects
+    uint64_t uploadByteBudget = 16 * 1024 * 1024;
+    float uploadMillisecondBudget = 2.0f;
+    // Falls back to FIFO when the surface doesn't support it
+    VkPresentModeKHR presentMode = VK_PRESENT_MODE_MAILBOX_KHR;
+    uint32_t swapchainImageCount = 3;
+    // Frames submitted but not displayed yet, lower is less input latency, 0 leaves it to framesInFlight
+    uint32_t maxQueuedFrames = 0;
+    // 0 renders as fast as the present mode allows
+    float maxFrameRate = 0.0f;
+    // Simulation step, independent of the frame rate
+    float fixedTimeStep = 1.0f / 60.0f;
+    // 0 uses one job worker per CPU besides the main thread
+    uint32_t jobWorkerCount = 0;
+    // Pins every job worker to a CPU of its own
+    bool isJobAffinityEnabled = true;
+    // Frustum and Hi-Z occlusion culling and draw generation in compute dispatches, drawn through indirect count draws
+    bool gpuCulling = false;
+};
 
 class Application
 {
 public:
-    Application();
+    Application(const ApplicationConfig& config = ApplicationConfig{});
     ~Application();
 
     void Run(TPtr<Scene> scene);
+    // Counters of the caches, allocators and schedulers accumulated since startup, and the profiler reports
+    void ReportStats(std::ostream& stream);
 
 private:
+    bool ShouldClose(uint64_t frameCount);
+    // Returns false when the frame was skipped, e.g. no swapchain image could be acquired
+    bool RenderOneFrame(TPtr<Scene> scene, uint64_t frameNumber);
+
+private:
+    ApplicationConfig _config;
+
     TPtr<Window> _window;
     TPtr<RendererInterface> _renderer;
+    TPtr<FramePacer> _framePacer;
+
+    // Frames-in-flight ring, the CPU only waits for the slot it is about to reuse
+    TPtrArr<Frame> _frames;
+    // Headless render targets, one per slot so overlapping frames never share an image
+    TPtrArr<VulkanImageView> _offscreenTargets;
 };
 
 }
\ No newline at end of file
@@ -8,6 +8,15 @@
 #endif
 
 
+// Profiling, remove to compile the CPU scope timers / GPU timestamp queries out
+#define ZE_CPU_PROFILER
+#define ZE_GPU_PROFILER
+
+
+#define ZE_CONCAT_INNER(a, b) a##b
+#define ZE_CONCAT(a, b) ZE_CONCAT_INNER(a, b)
+
+
 // Platform
 #if (defined _WIN64) || (defined _WIN32)
     #define ZE_PLATFORM_WINDOWS
@@ -26,7 +35,7 @@
 #elif __ANDROID__
     #define ZE_PLATFORM_ANDROID
 #elif __linux
-    // linux
+    #define ZE_PLATFORM_LINUX
 #elif __unix
     // Unix
 #elif __posix
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+
+namespace ZE {
+
+// FNV-1a, stable across runs so hashes can be persisted
+constexpr uint64_t FNVOffsetBasis = 14695981039346656037ull;
+constexpr uint64_t FNVPrime = 1099511628211ull;
+
+inline uint64_t HashBytes(const void* data, size_t size, uint64_t seed = FNVOffsetBasis)
+{
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    uint64_t hash = seed;
+    for (size_t i = 0; i < size; i++)
+    {
+        hash ^= bytes[i];
+        hash *= FNVPrime;
+    }
+
+    return hash;
+}
+
+// Appends values field by field, so padding and pointers never end up in a key
+class HashWriter
+{
+public:
+    template<typename T>
+    HashWriter& Write(const T& value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "only plain values can be hashed");
+
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&value);
+        _bytes.insert(_bytes.end(), bytes, bytes + sizeof(T));
+        return *this;
+    }
+
+    HashWriter& Write(const std::string& value)
+    {
+        Write(static_cast<uint64_t>(value.size()));
+        _bytes.insert(_bytes.end(), value.begin(), value.end());
+        return *this;
+    }
+
+    uint64_t GetHash() const
+    {
+        return HashBytes(_bytes.data(), _bytes.size());
+    }
+
+    const std::vector<uint8_t>& GetBytes() const
+    {
+        return _bytes;
+    }
+
+    std::vector<uint8_t>&& MoveBytes()
+    {
+        return std::move(_bytes);
+    }
+
+private:
+    std::vector<uint8_t> _bytes;
+};
+
+// Cache key, compares the full bytes so a hash collision can never alias two entries
+struct HashKey
+{
+    HashKey() : hash(0)
+    {
+    }
+
+    HashKey(HashWriter& writer) : hash(writer.GetHash()), bytes(writer.MoveBytes())
+    {
+    }
+
+    bool operator==(const HashKey& other) const
+    {
+        return hash == other.hash && bytes == other.bytes;
+    }
+
+    uint64_t hash;
+    std::vector<uint8_t> bytes;
+};
+
+struct HashKeyHasher
+{
+    size_t operator()(const HashKey& key) const
+    {
+        return static_cast<size_t>(key.hash);
+    }
+};
+
+}
\ No newline at end of file
@@ -0,0 +1,138 @@
+#pragma once
+
+#include "CoreDefines.h"
+#include "CoreTypes.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <mutex>
+#include <ostream>
+
+
+namespace ZE {
+
+struct CpuScopeStats
+{
+    std::string name;
+    uint32_t depth;
+    uint64_t sampleCount;
+
+    // Milliseconds per frame, over the rolling window
+    double p50;
+    double p95;
+    double p99;
+    double max;
+};
+
+// Hierarchical scope timer. Scopes are recorded into thread local buffers and
+// folded into a rolling window of per-frame totals at EndFrame.
+class CpuProfiler
+{
+public:
+    static void Initialize(uint32_t windowSize = 240);
+    static void Cleanup();
+    static CpuProfiler& Get();
+    // nullptr when the profiler is not initialized, scopes are skipped in that case
+    static CpuProfiler* TryGet();
+
+private:
+    CpuProfiler(uint32_t windowSize);
+    ~CpuProfiler();
+
+public:
+    void BeginFrame();
+    void EndFrame();
+
+    void BeginScope(const char* name);
+    void EndScope();
+
+    // A frame slower than factor * p50 of the window is reported as a hitch
+    void SetHitchFactor(double factor);
+    uint64_t GetHitchCount();
+    // Prints the scopes of every hitch as it happens, off by default, hitches are counted either way
+    void SetHitchLogEnabled(bool isEnabled);
+
+    std::vector<CpuScopeStats> GetStats();
+    void Report(std::ostream& stream);
+
+private:
+    struct OpenScope
+    {
+        const char* name;
+        uint64_t key;
+        int64_t start;
+    };
+
+    struct ScopeEvent
+    {
+        const char* name;
+        uint64_t key;
+        uint64_t parentKey;
+        uint32_t depth;
+        int64_t start;
+        int64_t duration;
+    };
+
+    struct ThreadBuffer
+    {
+        std::mutex mutex;
+        std::vector<ScopeEvent> events;
+        std::vector<OpenScope> stack;
+    };
+
+    struct ScopeHistory
+    {
+        std::string name;
+        uint64_t parentKey;
+        uint32_t depth;
+        std::vector<double> samples;
+        size_t head;
+        size_t count;
+    };
+
+    ThreadBuffer& GetThreadBuffer();
+    ScopeHistory& GetHistory(const ScopeEvent& event);
+    void PushSample(ScopeHistory& history, double sample);
+    double Percentile(std::vector<double>& sortedSamples, double percentile);
+    void ReportHitch(double frameTime, double medianFrameTime, std::vector<ScopeEvent>& events);
+
+    static int64_t Now();
+
+private:
+    static CpuProfiler* _instance;
+    static uint64_t _generation;
+
+    uint32_t _windowSize;
+    double _hitchFactor;
+    uint64_t _hitchCount;
+    bool _isHitchLogEnabled;
+    uint64_t _frameNumber;
+    uint64_t _frameKey;
+
+    std::mutex _registryMutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> _threadBuffers;
+
+    std::unordered_map<uint64_t, ScopeHistory> _histories;
+    // First seen order, keeps the report in execution order
+    std::vector<uint64_t> _historyOrder;
+};
+
+class CpuScope
+{
+public:
+    CpuScope(const char* name);
+    ~CpuScope();
+
+private:
+    CpuProfiler* _profiler;
+};
+
+} // namespace ZE
+
+
+#ifdef ZE_CPU_PROFILER
+#define ZE_CPU_SCOPE(name) ZE::CpuScope ZE_CONCAT(_cpuScope, __LINE__)(name)
+#else
+#define ZE_CPU_SCOPE(name)
+#endif
\ No newline at end of file
@@ -0,0 +1,134 @@
+#pragma once
+
+#include "CoreDefines.h"
+#include "CoreTypes.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <ostream>
+
+
+namespace ZE {
+
+class VulkanDevice;
+class VulkanQueryPool;
+class VulkanCommandBuffer;
+
+struct GpuScopeResult
+{
+    std::string name;
+    uint32_t depth;
+    double milliseconds;
+};
+
+// Timestamp query profiler. Each frame slot owns a query pool, the results of a slot
+// are read back without waiting when the slot is recorded again, a ring length later.
+class GpuProfiler
+{
+public:
+    static void Initialize(TPtr<VulkanDevice> device, uint32_t slotCount, uint32_t maxScopes = 128);
+    static void Cleanup();
+    static GpuProfiler& Get();
+    // nullptr when the profiler is not initialized, scopes are skipped in that case
+    static GpuProfiler* TryGet();
+
+private:
+    GpuProfiler(TPtr<VulkanDevice> device, uint32_t slotCount, uint32_t maxScopes);
+    ~GpuProfiler();
+
+public:
+    // Must be recorded outside of any render pass, it resets the slot's queries
+    void BeginFrame(TPtr<VulkanCommandBuffer> commandBuffer, uint32_t slotIndex);
+    void EndFrame();
+    // Reads back every slot still pending, the device has to be idle
+    void Flush();
+
+    void BeginScope(TPtr<VulkanCommandBuffer> commandBuffer, const char* name);
+    void EndScope(TPtr<VulkanCommandBuffer> commandBuffer);
+
+    // Timestamps are unsupported on the graphic queue when false, every call is a no-op then
+    bool IsSupported();
+
+    // Per draw scopes are costly on tilers, off by default
+    void SetDrawScopesEnabled(bool isEnabled);
+    bool IsDrawScopesEnabled();
+
+    void SetLogEnabled(bool isEnabled);
+
+    // Latest frame whose timestamps have been read back
+    uint64_t GetLastFrameNumber();
+    const std::vector<GpuScopeResult>& GetLastResults();
+
+    // Average of every resolved frame
+    void Report(std::ostream& stream);
+
+private:
+    struct PendingScope
+    {
+        const char* name;
+        uint32_t depth;
+        uint32_t beginQuery;
+        uint32_t endQuery;
+    };
+
+    struct Slot
+    {
+        TPtr<VulkanQueryPool> queryPool;
+        std::vector<PendingScope> scopes;
+        uint32_t queryCount;
+        uint64_t frameNumber;
+        bool isPending;
+    };
+
+    struct ScopeAverage
+    {
+        std::string name;
+        uint32_t depth;
+        double total;
+        uint64_t count;
+    };
+
+    void Resolve(Slot& slot);
+
+private:
+    static GpuProfiler* _instance;
+
+    bool _isSupported;
+    bool _isDrawScopesEnabled;
+    bool _isLogEnabled;
+    double _timestampPeriod;
+    uint64_t _timestampMask;
+    uint32_t _maxQueries;
+
+    std::vector<Slot> _slots;
+    Slot* _currentSlot;
+    std::vector<size_t> _scopeStack;
+
+    uint64_t _frameNumber;
+    uint64_t _lastFrameNumber;
+    std::vector<GpuScopeResult> _lastResults;
+    std::vector<ScopeAverage> _averages;
+};
+
+class GpuScope
+{
+public:
+    GpuScope(TPtr<VulkanCommandBuffer> commandBuffer, const char* name, bool isDrawScope = false);
+    ~GpuScope();
+
+private:
+    GpuProfiler* _profiler;
+    TPtr<VulkanCommandBuffer> _commandBuffer;
+};
+
+} // namespace ZE
+
+
+#ifdef ZE_GPU_PROFILER
+#define ZE_GPU_SCOPE(commandBuffer, name) ZE::GpuScope ZE_CONCAT(_gpuScope, __LINE__)(commandBuffer, name)
+#define ZE_GPU_DRAW_SCOPE(commandBuffer, name) ZE::GpuScope ZE_CONCAT(_gpuScope, __LINE__)(commandBuffer, name, true)
+#else
+#define ZE_GPU_SCOPE(commandBuffer, name)
+#define ZE_GPU_DRAW_SCOPE(commandBuffer, name)
+#endif
\ No newline at end of file
@@ -0,0 +1,323 @@
+#include "CpuProfiler.h"
+#include "CoreHash.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <format>
+#include <functional>
+#include <iostream>
+#include <assert.h>
+
+
+namespace ZE {
+
+CpuProfiler* CpuProfiler::_instance{nullptr};
+uint64_t CpuProfiler::_generation{0};
+
+namespace {
+
+const char* FrameScopeName = "Frame";
+
+struct ThreadBufferBinding
+{
+    uint64_t generation = 0;
+    void* buffer = nullptr;
+};
+
+thread_local ThreadBufferBinding threadBufferBinding;
+
+uint64_t HashScope(uint64_t parentKey, const char* name)
+{
+    // Seeded with the parent so equal names under different parents stay apart
+    uint64_t hash = HashBytes(name, std::strlen(name), FNVOffsetBasis ^ parentKey);
+
+    return hash == 0 ? 1 : hash;
+}
+
+} // namespace
+
+void CpuProfiler::Initialize(uint32_t windowSize)
+{
+    assert(_instance == nullptr);
+
+    if (_instance != nullptr)
+        return;
+
+    _generation++;
+    _instance = new CpuProfiler(windowSize);
+}
+
+void CpuProfiler::Cleanup()
+{
+    assert(_instance);
+
+    if (_instance == nullptr)
+        return;
+
+    delete _instance;
+    _instance = nullptr;
+}
+
+CpuProfiler& CpuProfiler::Get()
+{
+    assert(_instance);
+
+    return *_instance;
+}
+
+CpuProfiler* CpuProfiler::TryGet()
+{
+    return _instance;
+}
+
+CpuProfiler::CpuProfiler(uint32_t windowSize)
+    : _windowSize(std::max(windowSize, 1u)), _hitchFactor(2.0), _hitchCount(0), _isHitchLogEnabled(false), _frameNumber(0), _frameKey(HashScope(0, FrameScopeName))
+{
+}
+
+CpuProfiler::~CpuProfiler()
+{
+}
+
+int64_t CpuProfiler::Now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+CpuProfiler::ThreadBuffer& CpuProfiler::GetThreadBuffer()
+{
+    if (threadBufferBinding.generation != _generation || threadBufferBinding.buffer == nullptr)
+    {
+        std::lock_guard<std::mutex> lock(_registryMutex);
+
+        _threadBuffers.push_back(std::make_unique<ThreadBuffer>());
+        threadBufferBinding.generation = _generation;
+        threadBufferBinding.buffer = _threadBuffers.back().get();
+    }
+
+    return *static_cast<ThreadBuffer*>(threadBufferBinding.buffer);
+}
+
+void CpuProfiler::BeginFrame()
+{
+    BeginScope(FrameScopeName);
+}
+
+void CpuProfiler::EndFrame()
+{
+    EndScope();
+
+    std::vector<ScopeEvent> events;
+    {
+        std::lock_guard<std::mutex> lock(_registryMutex);
+        for (std::unique_ptr<ThreadBuffer>& buffer : _threadBuffers)
+        {
+            std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+            events.insert(events.end(), buffer->events.begin(), buffer->events.end());
+            buffer->events.clear();
+        }
+    }
+
+    // A scope entered several times in one frame counts once, with the summed time
+    std::unordered_map<uint64_t, double> frameTotals;
+    for (const ScopeEvent& event : events)
+    {
+        GetHistory(event);
+        frameTotals[event.key] += event.duration / 1000000.0;
+    }
+
+    auto frameIter = frameTotals.find(_frameKey);
+    if (frameIter != frameTotals.end())
+    {
+        ScopeHistory& frameHistory = _histories[_frameKey];
+
+        // Need a reasonably filled window before a median means anything
+        if (frameHistory.count >= std::min<size_t>(_windowSize, 30))
+        {
+            std::vector<double> samples(frameHistory.samples.begin(), frameHistory.samples.begin() + frameHistory.count);
+            std::sort(samples.begin(), samples.end());
+            double median = Percentile(samples, 0.5);
+
+            if (frameIter->second > median * _hitchFactor)
+                ReportHitch(frameIter->second, median, events);
+        }
+    }
+
+    for (auto& [key, total] : frameTotals)
+        PushSample(_histories[key], total);
+
+    _frameNumber++;
+}
+
+void CpuProfiler::BeginScope(const char* name)
+{
+    ThreadBuffer& buffer = GetThreadBuffer();
+
+    uint64_t parentKey = buffer.stack.empty() ? 0 : buffer.stack.back().key;
+    buffer.stack.push_back({name, HashScope(parentKey, name), Now()});
+}
+
+void CpuProfiler::EndScope()
+{
+    int64_t end = Now();
+    ThreadBuffer& buffer = GetThreadBuffer();
+
+    if (buffer.stack.empty())
+        return;
+
+    OpenScope scope = buffer.stack.back();
+    buffer.stack.pop_back();
+
+    ScopeEvent event;
+    event.name = scope.name;
+    event.key = scope.key;
+    event.parentKey = buffer.stack.empty() ? 0 : buffer.stack.back().key;
+    event.depth = static_cast<uint32_t>(buffer.stack.size());
+    event.start = scope.start;
+    event.duration = end - scope.start;
+
+    std::lock_guard<std::mutex> lock(buffer.mutex);
+    buffer.events.push_back(event);
+}
+
+void CpuProfiler::SetHitchFactor(double factor)
+{
+    _hitchFactor = factor;
+}
+
+uint64_t CpuProfiler::GetHitchCount()
+{
+    return _hitchCount;
+}
+
+void CpuProfiler::SetHitchLogEnabled(bool isEnabled)
+{
+    _isHitchLogEnabled = isEnabled;
+}
+
+CpuProfiler::ScopeHistory& CpuProfiler::GetHistory(const ScopeEvent& event)
+{
+    auto iter = _histories.find(event.key);
+    if (iter != _histories.end())
+        return iter->second;
+
+    ScopeHistory history;
+    history.name = event.name;
+    history.parentKey = event.parentKey;
+    history.depth = event.depth;
+    history.samples.resize(_windowSize, 0.0);
+    history.head = 0;
+    history.count = 0;
+
+    _historyOrder.push_back(event.key);
+    return _histories.emplace(event.key, std::move(history)).first->second;
+}
+
+void CpuProfiler::PushSample(ScopeHistory& history, double sample)
+{
+    history.samples[history.head] = sample;
+    history.head = (history.head + 1) % history.samples.size();
+    history.count = std::min(history.count + 1, history.samples.size());
+}
+
+double CpuProfiler::Percentile(std::vector<double>& sortedSamples, double percentile)
+{
+    if (sortedSamples.empty())
+        return 0.0;
+
+    size_t rank = static_cast<size_t>(std::ceil(percentile * sortedSamples.size()));
+    return sortedSamples[std::clamp<size_t>(rank, 1, sortedSamples.size()) - 1];
+}
+
+void CpuProfiler::ReportHitch(double frameTime, double medianFrameTime, std::vector<ScopeEvent>& events)
+{
+    _hitchCount++;
+
+    if (!_isHitchLogEnabled)
+        return;
+
+    std::cout << std::format("[CpuProfiler] hitch in frame {}: {:.3f} ms (p50 {:.3f} ms)", _frameNumber, frameTime, medianFrameTime) << std::endl;
+
+    std::sort(events.begin(), events.end(), [](const ScopeEvent& a, const ScopeEvent& b) {
+        return a.start < b.start;
+    });
+
+    for (const ScopeEvent& event : events)
+    {
+        if (event.key == _frameKey)
+            continue;
+
+        std::cout << std::format("    {}{} {:.3f} ms", std::string(event.depth * 2, ' '), event.name, event.duration / 1000000.0) << std::endl;
+    }
+}
+
+std::vector<CpuScopeStats> CpuProfiler::GetStats()
+{
+    std::unordered_map<uint64_t, std::vector<uint64_t>> children;
+    std::vector<uint64_t> roots;
+    for (uint64_t key : _historyOrder)
+    {
+        uint64_t parentKey = _histories[key].parentKey;
+        if (parentKey == 0 || _histories.find(parentKey) == _histories.end())
+            roots.push_back(key);
+        else
+            children[parentKey].push_back(key);
+    }
+
+    std::vector<CpuScopeStats> statsArr;
+
+    std::function<void(uint64_t)> visit = [&](uint64_t key) {
+        ScopeHistory& history = _histories[key];
+
+        std::vector<double> samples(history.samples.begin(), history.samples.begin() + history.count);
+        std::sort(samples.begin(), samples.end());
+
+        CpuScopeStats stats;
+        stats.name = history.name;
+        stats.depth = history.depth;
+        stats.sampleCount = history.count;
+        stats.p50 = Percentile(samples, 0.50);
+        stats.p95 = Percentile(samples, 0.95);
+        stats.p99 = Percentile(samples, 0.99);
+        stats.max = samples.empty() ? 0.0 : samples.back();
+        statsArr.push_back(stats);
+
+        for (uint64_t child : children[key])
+            visit(child);
+    };
+
+    for (uint64_t root : roots)
+        visit(root);
+
+    return statsArr;
+}
+
+void CpuProfiler::Report(std::ostream& stream)
+{
+    stream << std::format("{:<40} {:>8} {:>8} {:>8} {:>8} {:>8}", "Scope (ms)", "p50", "p95", "p99", "max", "samples") << std::endl;
+
+    for (const CpuScopeStats& stats : GetStats())
+    {
+        std::string name = std::string(stats.depth * 2, ' ') + stats.name;
+        stream << std::format("{:<40} {:>8.3f} {:>8.3f} {:>8.3f} {:>8.3f} {:>8}", name, stats.p50, stats.p95, stats.p99, stats.max, stats.sampleCount) << std::endl;
+    }
+
+    stream << std::format("hitches: {}", _hitchCount) << std::endl;
+}
+
+CpuScope::CpuScope(const char* name)
+    : _profiler(CpuProfiler::TryGet())
+{
+    if (_profiler != nullptr)
+        _profiler->BeginScope(name);
+}
+
+CpuScope::~CpuScope()
+{
+    if (_profiler != nullptr)
+        _profiler->EndScope();
+}
+
+} // namespace ZE
\ No newline at end of file
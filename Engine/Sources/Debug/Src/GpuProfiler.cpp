@@ -0,0 +1,271 @@
+#include "GpuProfiler.h"
+#include "Graphic/VulkanGPU.h"
+#include "Graphic/VulkanDevice.h"
+#include "Graphic/VulkanQueryPool.h"
+#include "Graphic/VulkanCommandBuffer.h"
+
+#include <algorithm>
+#include <format>
+#include <iostream>
+#include <assert.h>
+
+
+namespace ZE {
+
+GpuProfiler* GpuProfiler::_instance{nullptr};
+
+void GpuProfiler::Initialize(TPtr<VulkanDevice> device, uint32_t slotCount, uint32_t maxScopes)
+{
+    assert(_instance == nullptr);
+
+    if (_instance != nullptr)
+        return;
+
+    _instance = new GpuProfiler(device, slotCount, maxScopes);
+}
+
+void GpuProfiler::Cleanup()
+{
+    assert(_instance);
+
+    if (_instance == nullptr)
+        return;
+
+    delete _instance;
+    _instance = nullptr;
+}
+
+GpuProfiler& GpuProfiler::Get()
+{
+    assert(_instance);
+
+    return *_instance;
+}
+
+GpuProfiler* GpuProfiler::TryGet()
+{
+    return _instance;
+}
+
+GpuProfiler::GpuProfiler(TPtr<VulkanDevice> device, uint32_t slotCount, uint32_t maxScopes)
+    : _isSupported(false), _isDrawScopesEnabled(false), _isLogEnabled(false), _timestampPeriod(1.0), _timestampMask(0),
+      _maxQueries(maxScopes * 2), _currentSlot(nullptr), _frameNumber(0), _lastFrameNumber(0)
+{
+    TPtr<VulkanGPU> GPU = device->GetGPU();
+
+    std::vector<VkQueueFamilyProperties> queueFamilyProperties = GPU->GetQueueFamilyProperties();
+    uint32_t validBits = queueFamilyProperties[device->GetGraphicQueueFamilyIndex()].timestampValidBits;
+
+    _isSupported = validBits > 0;
+    if (!_isSupported)
+        return;
+
+    _timestampMask = validBits >= 64 ? UINT64_MAX : ((uint64_t(1) << validBits) - 1);
+    _timestampPeriod = GPU->GetProperties().limits.timestampPeriod;
+
+    _slots.resize(std::max(slotCount, 1u));
+    for (Slot& slot : _slots)
+    {
+        slot.queryPool = std::make_shared<VulkanQueryPool>(device, VK_QUERY_TYPE_TIMESTAMP, _maxQueries);
+        slot.queryCount = 0;
+        slot.frameNumber = 0;
+        slot.isPending = false;
+    }
+}
+
+GpuProfiler::~GpuProfiler()
+{
+    _slots.clear();
+}
+
+void GpuProfiler::BeginFrame(TPtr<VulkanCommandBuffer> commandBuffer, uint32_t slotIndex)
+{
+    if (!_isSupported)
+        return;
+
+    Slot& slot = _slots[slotIndex % _slots.size()];
+
+    // The frame slot has been waited on before being recorded again, so this doesn't stall
+    if (slot.isPending)
+        Resolve(slot);
+
+    slot.queryPool->Reset(commandBuffer, 0, _maxQueries);
+    slot.scopes.clear();
+    slot.queryCount = 0;
+    slot.frameNumber = _frameNumber++;
+
+    _currentSlot = &slot;
+    _scopeStack.clear();
+}
+
+void GpuProfiler::EndFrame()
+{
+    if (_currentSlot == nullptr)
+        return;
+
+    _currentSlot->isPending = true;
+    _currentSlot = nullptr;
+}
+
+void GpuProfiler::Flush()
+{
+    std::vector<Slot*> pendingSlots;
+    for (Slot& slot : _slots)
+    {
+        if (slot.isPending)
+            pendingSlots.push_back(&slot);
+    }
+
+    std::sort(pendingSlots.begin(), pendingSlots.end(), [](const Slot* a, const Slot* b) {
+        return a->frameNumber < b->frameNumber;
+    });
+
+    for (Slot* slot : pendingSlots)
+        Resolve(*slot);
+}
+
+void GpuProfiler::BeginScope(TPtr<VulkanCommandBuffer> commandBuffer, const char* name)
+{
+    if (_currentSlot == nullptr)
+        return;
+
+    // Out of queries, the scope is dropped but its children still nest correctly
+    if (_currentSlot->queryCount + 2 > _maxQueries)
+    {
+        _scopeStack.push_back(SIZE_MAX);
+        return;
+    }
+
+    PendingScope scope;
+    scope.name = name;
+    scope.depth = static_cast<uint32_t>(_scopeStack.size());
+    scope.beginQuery = _currentSlot->queryCount++;
+    scope.endQuery = _currentSlot->queryCount++;
+
+    _currentSlot->queryPool->WriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, scope.beginQuery);
+
+    _scopeStack.push_back(_currentSlot->scopes.size());
+    _currentSlot->scopes.push_back(scope);
+}
+
+void GpuProfiler::EndScope(TPtr<VulkanCommandBuffer> commandBuffer)
+{
+    if (_currentSlot == nullptr || _scopeStack.empty())
+        return;
+
+    size_t index = _scopeStack.back();
+    _scopeStack.pop_back();
+
+    if (index == SIZE_MAX)
+        return;
+
+    _currentSlot->queryPool->WriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, _currentSlot->scopes[index].endQuery);
+}
+
+void GpuProfiler::Resolve(Slot& slot)
+{
+    slot.isPending = false;
+
+    std::vector<uint64_t> timestamps;
+    if (!slot.queryPool->GetResults(0, slot.queryCount, timestamps))
+        return;
+
+    _lastFrameNumber = slot.frameNumber;
+    _lastResults.clear();
+
+    for (const PendingScope& scope : slot.scopes)
+    {
+        uint64_t ticks = (timestamps[scope.endQuery] - timestamps[scope.beginQuery]) & _timestampMask;
+
+        GpuScopeResult result;
+        result.name = scope.name;
+        result.depth = scope.depth;
+        result.milliseconds = ticks * _timestampPeriod / 1000000.0;
+        _lastResults.push_back(result);
+
+        auto iter = std::find_if(_averages.begin(), _averages.end(), [&result](const ScopeAverage& average) {
+            return average.depth == result.depth && average.name == result.name;
+        });
+        if (iter == _averages.end())
+            iter = _averages.insert(_averages.end(), ScopeAverage{result.name, result.depth, 0.0, 0});
+
+        iter->total += result.milliseconds;
+        iter->count++;
+    }
+
+    if (_isLogEnabled)
+    {
+        std::string line = std::format("[GpuProfiler] frame {}:", _lastFrameNumber);
+        for (const GpuScopeResult& result : _lastResults)
+        {
+            if (result.depth == 0)
+                line += std::format(" {} {:.3f} ms", result.name, result.milliseconds);
+        }
+        std::cout << line << std::endl;
+    }
+}
+
+bool GpuProfiler::IsSupported()
+{
+    return _isSupported;
+}
+
+void GpuProfiler::SetDrawScopesEnabled(bool isEnabled)
+{
+    _isDrawScopesEnabled = isEnabled;
+}
+
+bool GpuProfiler::IsDrawScopesEnabled()
+{
+    return _isDrawScopesEnabled;
+}
+
+void GpuProfiler::SetLogEnabled(bool isEnabled)
+{
+    _isLogEnabled = isEnabled;
+}
+
+uint64_t GpuProfiler::GetLastFrameNumber()
+{
+    return _lastFrameNumber;
+}
+
+const std::vector<GpuScopeResult>& GpuProfiler::GetLastResults()
+{
+    return _lastResults;
+}
+
+void GpuProfiler::Report(std::ostream& stream)
+{
+    if (!_isSupported)
+    {
+        stream << "GPU timestamps are not supported on the graphic queue" << std::endl;
+        return;
+    }
+
+    stream << std::format("{:<40} {:>8} {:>8}", "GPU scope (ms)", "avg", "samples") << std::endl;
+
+    for (const ScopeAverage& average : _averages)
+    {
+        std::string name = std::string(average.depth * 2, ' ') + average.name;
+        stream << std::format("{:<40} {:>8.3f} {:>8}", name, average.total / average.count, average.count) << std::endl;
+    }
+}
+
+GpuScope::GpuScope(TPtr<VulkanCommandBuffer> commandBuffer, const char* name, bool isDrawScope)
+    : _profiler(GpuProfiler::TryGet()), _commandBuffer(commandBuffer)
+{
+    if (_profiler != nullptr && isDrawScope && !_profiler->IsDrawScopesEnabled())
+        _profiler = nullptr;
+
+    if (_profiler != nullptr)
+        _profiler->BeginScope(_commandBuffer, name);
+}
+
+GpuScope::~GpuScope()
+{
+    if (_profiler != nullptr)
+        _profiler->EndScope(_commandBuffer);
+}
+
+} // namespace ZE
\ No newline at end of file
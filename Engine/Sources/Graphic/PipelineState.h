@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
 #include <vulkan/vulkan_core.h>
 
@@ -24,6 +25,7 @@ struct RHIShaderState
 {
     VkShaderStageFlagBits stage;
     VkShaderModule shaderModule;
+    uint64_t codeHash;
     std::string name;
 };
 
@@ -34,11 +36,11 @@ struct RHIRasterizationState
 
 struct RHIPipelineState
 {
-    RHIPipelineState() : vertexInputBinding{}, vertexInputState{}, rasterizeationState{}, inputAssemblyState{}, depthStencilState{}, colorBlendState{}, layout(VK_NULL_HANDLE)
+    RHIPipelineState() : vertexInputState{}, rasterizeationState{}, inputAssemblyState{}, depthStencilState{}, colorBlendState{}, layout(VK_NULL_HANDLE), layoutHash(0)
     {
     }
 
-    VkVertexInputBindingDescription vertexInputBinding;
+    std::vector<VkVertexInputBindingDescription> vertexInputBindings;
     VkPipelineVertexInputStateCreateInfo vertexInputState;
     VkPipelineRasterizationStateCreateInfo rasterizeationState;
     VkPipelineInputAssemblyStateCreateInfo inputAssemblyState;
@@ -47,5 +49,8 @@ struct RHIPipelineState
     std::vector<VkPipelineColorBlendAttachmentState> colorBlendAttachments;
     VkPipelineColorBlendStateCreateInfo colorBlendState;
     std::vector<VkPipelineShaderStageCreateInfo> shaderStages;
+    // Content of the modules and the layout, handle values may be reused once their objects are destroyed
+    std::vector<uint64_t> shaderCodeHashes;
     VkPipelineLayout layout;
+    uint64_t layoutHash;
 };
\ No newline at end of file
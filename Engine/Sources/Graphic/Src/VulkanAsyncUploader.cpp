@@ -0,0 +1,154 @@
+#include "VulkanAsyncUploader.h"
+#include "VulkanTimelineSemaphore.h"
+#include "VulkanDevice.h"
+#include "VulkanQueue.h"
+#include "VulkanBuffer.h"
+#include "VulkanBufferManager.h"
+#include "VulkanCommandPool.h"
+#include "VulkanCommandBuffer.h"
+#include "VulkanImage.h"
+
+
+namespace ZE {
+
+VulkanAsyncUploader::VulkanAsyncUploader(TPtr<VulkanDevice> device, TPtr<VulkanBufferManager> bufferManager, TPtr<VulkanQueue> transferQueue, TPtr<VulkanQueue> graphicQueue)
+    : _device(device), _bufferManager(bufferManager), _transferQueue(transferQueue), _submittedValue(0), _acquiredValue(0), _submissionCount(0), _uploadedSize(0)
+{
+    _commandPool = std::make_shared<VulkanCommandPool>(device, transferQueue->GetFamilyIndex(), VK_COMMAND_POOL_CREATE_TRANSIENT_BIT | VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT);
+    _timelineSemaphore = std::make_shared<VulkanTimelineSemaphore>(device, 0);
+
+    // Staging memory is allocated for each submission's value, not for the frame the batch is flushed in
+    _batch = std::make_shared<VulkanUploadBatch>(nullptr);
+    _batch->SetQueueFamilyTransfer(transferQueue->GetFamilyIndex(), graphicQueue->GetFamilyIndex());
+}
+
+VulkanAsyncUploader::~VulkanAsyncUploader()
+{
+    _timelineSemaphore->Wait(_submittedValue);
+
+    _submissionQueue.clear();
+    _freeCommandBufferArr.clear();
+    _batch.reset();
+    _commandPool.reset();
+    _timelineSemaphore.reset();
+}
+
+TPtr<VulkanUploadBatch> VulkanAsyncUploader::GetBatch()
+{
+    return _batch;
+}
+
+uint64_t VulkanAsyncUploader::Submit()
+{
+    if (_batch->IsEmpty())
+        return 0;
+
+    Submission submission{};
+    submission.value = ++_submittedValue;
+    submission.isAcquired = false;
+
+    VkDeviceSize size = _batch->GetPendingSize();
+    StagingAllocation staging = _bufferManager->AllocateStaging(size, 0, _timelineSemaphore, submission.value);
+
+    if (_freeCommandBufferArr.empty())
+    {
+        submission.commandBuffer = std::make_shared<VulkanCommandBuffer>(_commandPool);
+    }
+    else
+    {
+        submission.commandBuffer = _freeCommandBufferArr.back();
+        _freeCommandBufferArr.pop_back();
+    }
+
+    submission.commandBuffer->Begin();
+    _batch->Flush(submission.commandBuffer, staging);
+    submission.commandBuffer->End();
+    submission.acquire = _batch->TakeAcquire();
+
+    // Whatever is released before the submission landed is destroyed after it
+    for (TPtr<VulkanBuffer> buffer : submission.acquire.bufferArr)
+        buffer->SetTimelineUse(_timelineSemaphore, submission.value);
+    for (TPtr<VulkanImage> image : submission.acquire.imageArr)
+        image->SetTimelineUse(_timelineSemaphore, submission.value);
+
+    VulkanSubmitBatch batch;
+    batch.commandBufferArr.push_back(submission.commandBuffer);
+    batch.signalArr.push_back({_timelineSemaphore->GetRawSemaphore(), submission.value, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT});
+    _transferQueue->Submit({batch});
+
+    _submissionQueue.push_back(std::move(submission));
+    _submissionCount++;
+    _uploadedSize += size;
+
+    return _submittedValue;
+}
+
+uint64_t VulkanAsyncUploader::RecordAcquire(TPtr<VulkanCommandBuffer> commandBuffer)
+{
+    uint64_t completedValue = _timelineSemaphore->GetCompletedValue();
+
+    std::vector<VulkanUploadAcquire> acquireArr;
+    uint64_t acquiredValue = _acquiredValue;
+    for (Submission& submission : _submissionQueue)
+    {
+        // The transfer queue completes in order
+        if (submission.value > completedValue)
+            break;
+
+        if (submission.isAcquired)
+            continue;
+
+        acquireArr.push_back(std::move(submission.acquire));
+        submission.isAcquired = true;
+        acquiredValue = submission.value;
+    }
+
+    if (acquiredValue == _acquiredValue)
+        return 0;
+
+    VulkanUploadBatch::RecordAcquire(commandBuffer, acquireArr);
+    _acquiredValue = acquiredValue;
+
+    return _acquiredValue;
+}
+
+bool VulkanAsyncUploader::IsReady(uint64_t value)
+{
+    return value <= _acquiredValue;
+}
+
+uint64_t VulkanAsyncUploader::GetAcquiredValue()
+{
+    return _acquiredValue;
+}
+
+void VulkanAsyncUploader::Wait(uint64_t value)
+{
+    _timelineSemaphore->Wait(value);
+}
+
+void VulkanAsyncUploader::Tick()
+{
+    while (!_submissionQueue.empty() && _submissionQueue.front().isAcquired)
+    {
+        _freeCommandBufferArr.push_back(_submissionQueue.front().commandBuffer);
+        _submissionQueue.pop_front();
+    }
+}
+
+TPtr<VulkanTimelineSemaphore> VulkanAsyncUploader::GetTimelineSemaphore()
+{
+    return _timelineSemaphore;
+}
+
+uint32_t VulkanAsyncUploader::GetSubmissionCount()
+{
+    return _submissionCount;
+}
+
+VkDeviceSize VulkanAsyncUploader::GetUploadedSize()
+{
+    return _uploadedSize;
+}
+
+} // namespace ZE
\ No newline at end of file
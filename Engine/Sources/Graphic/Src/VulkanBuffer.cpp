@@ -3,16 +3,19 @@
 #include "VulkanCommandBuffer.h"
 #include "VulkanCommandPool.h"
 #include "VulkanDevice.h"
+#include "VulkanMemoryAllocator.h"
+#include "VulkanBufferManager.h"
 
 #include <stdexcept>
+#include <utility>
 
 
 namespace ZE {
 
 VulkanBuffer::VulkanBuffer(TPtr<VulkanDevice> device, uint32_t size, VkBufferUsageFlags usage,
-                           VkMemoryPropertyFlags properties)
+                           VkMemoryPropertyFlags properties, EVulkanMemoryCategory category, EVulkanMemoryUsage memoryUsage)
     : _device(device), _size(size), _usage(usage), _properties(properties), _vkBuffer(VK_NULL_HANDLE),
-      _vkMemory(VK_NULL_HANDLE)
+      _allocation{}, _timelineValue(0)
 {
     VkDevice vkDevice = _device->GetRawDevice();
 
@@ -32,17 +35,11 @@ VulkanBuffer::VulkanBuffer(TPtr<VulkanDevice> device, uint32_t size, VkBufferUsa
     VkMemoryRequirements memRequirements;
     vkGetBufferMemoryRequirements(vkDevice, _vkBuffer, &memRequirements);
 
-    VkMemoryAllocateInfo allocInfo{};
-    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-    allocInfo.allocationSize = memRequirements.size;
-    allocInfo.memoryTypeIndex = _device->GetGPU()->FindMemoryType(memRequirements.memoryTypeBits, properties);
+    TPtr<VulkanMemoryAllocator> memoryAllocator = _device->GetMemoryAllocator();
+    uint32_t memoryTypeIndex = memoryAllocator->FindMemoryType(memRequirements.memoryTypeBits, properties);
+    _allocation = memoryAllocator->Allocate(memRequirements, memoryTypeIndex, memoryUsage, category);
 
-    if (vkAllocateMemory(vkDevice, &allocInfo, nullptr, &_vkMemory) != VK_SUCCESS)
-    {
-        throw std::runtime_error("failed to allocate buffer memory!");
-    }
-
-    if (vkBindBufferMemory(vkDevice, _vkBuffer, _vkMemory, 0) != VK_SUCCESS)
+    if (vkBindBufferMemory(vkDevice, _vkBuffer, _allocation.memory, _allocation.offset) != VK_SUCCESS)
     {
         throw std::runtime_error("failed to bind buffer memory!");
     }
@@ -50,57 +47,64 @@ VulkanBuffer::VulkanBuffer(TPtr<VulkanDevice> device, uint32_t size, VkBufferUsa
 
 VulkanBuffer::~VulkanBuffer()
 {
-    VkDevice vkDevice = _device->GetRawDevice();
-
-    if (_vkBuffer != VK_NULL_HANDLE)
-        vkDestroyBuffer(vkDevice, _vkBuffer, nullptr);
+    // Frames in flight may still read the buffer
+    _device->DeferDestruction([device = _device, vkBuffer = _vkBuffer, allocation = _allocation]() mutable {
+        if (vkBuffer != VK_NULL_HANDLE)
+            vkDestroyBuffer(device->GetRawDevice(), vkBuffer, nullptr);
 
-    if (_vkMemory != VK_NULL_HANDLE)
-        vkFreeMemory(vkDevice, _vkMemory, nullptr);
+        device->GetMemoryAllocator()->Free(allocation);
+    }, _timelineSemaphore, _timelineValue);
 
-    _vkMemory = VK_NULL_HANDLE;
     _vkBuffer = VK_NULL_HANDLE;
 }
 
-void VulkanBuffer::CopyFromBuffer(TPtr<VulkanCommandBuffer> commandBuffer, TPtr<VulkanBuffer> otherBuffer, VkDeviceSize size)
+void VulkanBuffer::CopyFromBuffer(TPtr<VulkanCommandBuffer> commandBuffer, TPtr<VulkanBuffer> otherBuffer, VkDeviceSize size, VkDeviceSize srcOffset)
 {
     VkCommandBuffer vkCommandBuffer = commandBuffer->GetRawCommandBuffer();
 
     VkBufferCopy copyRegion{};
+    copyRegion.srcOffset = srcOffset;
     copyRegion.size = size;
     vkCmdCopyBuffer(vkCommandBuffer, otherBuffer->GetRawBuffer(), _vkBuffer, 1, &copyRegion);
 }
 
-void VulkanBuffer::TransferData(TPtr<VulkanCommandBuffer> commandBuffer, TPtr<VulkanBuffer> stagingBuffer, const void* data, uint32_t size)
+void VulkanBuffer::TransferData(TPtr<VulkanCommandBuffer> commandBuffer, TPtr<VulkanBufferManager> bufferManager, const void* data, uint32_t size)
 {
     if (_properties & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)
     {
-        void* mappedAddress = nullptr;
-        vkMapMemory(_device->GetRawDevice(), _vkMemory, 0, size, 0, &mappedAddress);
-        memcpy(mappedAddress, data, size);
-        vkUnmapMemory(_device->GetRawDevice(), _vkMemory);
+        memcpy(MapMemory(0, size), data, size);
     }
     else if (_properties & VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT)
     {
-        void* mappedAddress = stagingBuffer->MapMemory(0, size);
-        memcpy(mappedAddress, data, size);
-        stagingBuffer->UnmapMemory();
-
-        CopyFromBuffer(commandBuffer, stagingBuffer, size);
+        StagingAllocation staging = bufferManager->Stage(data, size);
+        CopyFromBuffer(commandBuffer, staging.buffer, size, staging.offset);
     }
 }
 
 void* VulkanBuffer::MapMemory(VkDeviceSize offset, VkDeviceSize size)
 {
-    void* address = nullptr;
-    vkMapMemory(_device->GetRawDevice(), _vkMemory, offset, size, 0, &address);
+    if (_allocation.mappedAddress == nullptr)
+        throw std::runtime_error("buffer memory is not host visible!");
 
-    return address;
+    return static_cast<uint8_t*>(_allocation.mappedAddress) + offset;
 }
 
 void VulkanBuffer::UnmapMemory()
 {
-    vkUnmapMemory(_device->GetRawDevice(), _vkMemory);
+}
+
+void VulkanBuffer::SwapStorage(VulkanBuffer& other)
+{
+    std::swap(_vkBuffer, other._vkBuffer);
+    std::swap(_allocation, other._allocation);
+    std::swap(_timelineSemaphore, other._timelineSemaphore);
+    std::swap(_timelineValue, other._timelineValue);
+}
+
+void VulkanBuffer::SetTimelineUse(TPtr<VulkanTimelineSemaphore> semaphore, uint64_t value)
+{
+    _timelineSemaphore = semaphore;
+    _timelineValue = value;
 }
 
 uint32_t VulkanBuffer::GetSize()
@@ -108,14 +112,24 @@ uint32_t VulkanBuffer::GetSize()
     return _size;
 }
 
+VkBufferUsageFlags VulkanBuffer::GetUsage()
+{
+    return _usage;
+}
+
+VkMemoryPropertyFlags VulkanBuffer::GetMemoryProperties()
+{
+    return _properties;
+}
+
 VkBuffer VulkanBuffer::GetRawBuffer()
 {
     return _vkBuffer;
 }
 
-VkDeviceMemory VulkanBuffer::GetRawMemory()
+const VulkanMemoryAllocation& VulkanBuffer::GetAllocation()
 {
-    return _vkMemory;
+    return _allocation;
 }
 
 } // namespace ZE
\ No newline at end of file
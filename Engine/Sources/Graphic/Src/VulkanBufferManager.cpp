@@ -1,94 +1,148 @@
 #include "VulkanBufferManager.h"
 #include "VulkanDevice.h"
+#include "VulkanGPU.h"
 #include "VulkanBuffer.h"
 #include "VulkanCommandBuffer.h"
+#include "VulkanTimelineSemaphore.h"
 
 #include <algorithm>
-#include <iterator>
+#include <cstring>
+#include <unordered_map>
 
 
 namespace ZE {
 
-VulkanBufferManager::VulkanBufferManager(TPtr<VulkanDevice> device)
-    : _device(device)
+VulkanBufferManager::VulkanBufferManager(TPtr<VulkanDevice> device, VkDeviceSize ringSize, TPtr<VulkanTimelineSemaphore> frameTimeline)
+    : _device(device), _frameTimeline(frameTimeline), _mappedAddress(nullptr), _ringSize(ringSize), _head(0), _tail(0),
+      _frameValue(frameTimeline->GetCompletedValue() + 1), _peakUsedSize(0), _temporaryBufferCount(0)
 {
+    // Keeps buffer to image copies on the fast path, image copies also need texel aligned offsets
+    _minAlignment = std::max<VkDeviceSize>(device->GetGPU()->GetProperties().limits.optimalBufferCopyOffsetAlignment, 16);
+
+    _ringBuffer = std::make_shared<VulkanBuffer>(device, static_cast<uint32_t>(_ringSize), VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, EVulkanMemoryCategory::Staging);
+    _mappedAddress = static_cast<uint8_t*>(_ringBuffer->MapMemory(0, _ringSize));
 }
 
 VulkanBufferManager::~VulkanBufferManager()
 {
+    _temporaryBufferQueue.clear();
+    _ringBuffer.reset();
 }
 
-TPtr<VulkanBuffer> VulkanBufferManager::AcquireStagingBuffer(uint32_t size)
+StagingAllocation VulkanBufferManager::AllocateStaging(VkDeviceSize size, VkDeviceSize alignment)
 {
-    TPtr<VulkanBuffer> stagingBuffer{nullptr};
+    return AllocateStaging(size, alignment, _frameTimeline, _frameValue);
+}
 
-    for (auto iter = _freeStagingBuffer.begin(); iter != _freeStagingBuffer.end(); iter++)
-    {
-        if ((*iter)->GetSize() >= size)
-        {
-            stagingBuffer = *iter;
-            _freeStagingBuffer.erase(iter);
-            break;
-        }
-    }
+StagingAllocation VulkanBufferManager::AllocateStaging(VkDeviceSize size, VkDeviceSize alignment, TPtr<VulkanTimelineSemaphore> semaphore, uint64_t value)
+{
+    alignment = std::max(alignment, _minAlignment);
 
-    if (stagingBuffer == nullptr)
-    {
-        stagingBuffer = std::make_shared<VulkanBuffer>(_device, size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
-    }
+    VkDeviceSize offset;
+    if (size <= _ringSize / 4 && TryAllocateFromRing(size, alignment, semaphore, value, offset))
+        return StagingAllocation{_ringBuffer, offset, _mappedAddress + offset};
 
-    _usedStagingBuffer.push_back(stagingBuffer);
+    // Huge uploads, or the ring is still full of pending submissions
+    TPtr<VulkanBuffer> buffer = std::make_shared<VulkanBuffer>(_device, static_cast<uint32_t>(size), VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, EVulkanMemoryCategory::Staging, EVulkanMemoryUsage::Transient);
+    _temporaryBufferQueue.push_back({buffer, semaphore, value});
+    _temporaryBufferCount++;
 
-    return stagingBuffer;
+    return StagingAllocation{buffer, 0, buffer->MapMemory(0, size)};
 }
 
-void VulkanBufferManager::ReleaseStagingBuffer(TPtr<VulkanBuffer> buffer, TPtr<VulkanCommandBuffer> commandBuffer)
+StagingAllocation VulkanBufferManager::Stage(const void* data, VkDeviceSize size, VkDeviceSize alignment)
 {
-    if (commandBuffer == nullptr)
-        _freeStagingBuffer.push_back(buffer);
-    else
+    StagingAllocation allocation = AllocateStaging(size, alignment);
+    memcpy(allocation.mappedAddress, data, size);
+
+    return allocation;
+}
+
+void VulkanBufferManager::Tick(uint64_t frameValue)
+{
+    _frameValue = frameValue;
+
+    // Values of one semaphore complete in order, one query per semaphore covers everything older
+    std::unordered_map<VulkanTimelineSemaphore*, uint64_t> completedValueMap;
+    auto isCompleted = [&completedValueMap](const TPtr<VulkanTimelineSemaphore>& semaphore, uint64_t value) {
+        auto it = completedValueMap.find(semaphore.get());
+        if (it == completedValueMap.end())
+            it = completedValueMap.insert(std::make_pair(semaphore.get(), semaphore->GetCompletedValue())).first;
+
+        return value <= it->second;
+    };
+
+    while (!_segmentQueue.empty() && isCompleted(_segmentQueue.front().semaphore, _segmentQueue.front().value))
     {
-        _pendingList.push_back({buffer, commandBuffer, commandBuffer->GetExecuteCount()});
+        _tail = _segmentQueue.front().end;
+        _segmentQueue.pop_front();
     }
 
-    _usedStagingBuffer.remove(buffer);
+    std::erase_if(_temporaryBufferQueue, [&isCompleted](const TemporaryBuffer& temporaryBuffer) { return isCompleted(temporaryBuffer.semaphore, temporaryBuffer.value); });
 }
 
-void VulkanBufferManager::Tick()
+bool VulkanBufferManager::TryAllocateFromRing(VkDeviceSize size, VkDeviceSize alignment, TPtr<VulkanTimelineSemaphore> semaphore, uint64_t value, VkDeviceSize& offset)
 {
-    auto removeFilterFunc = [](StagingBufferEntry& entry) {
-        if (entry.weakCommandBuffer.expired())
-            return true;
-        else
-        {
-            TPtr<VulkanCommandBuffer> commandBuffer = entry.weakCommandBuffer.lock();
-            if (entry.frameCount < commandBuffer->GetExecuteCount())
-                return true;
-            else
-                return false;
-        }
-    };
+    bool isEmpty = _segmentQueue.empty();
+    if (isEmpty)
+    {
+        _head = 0;
+        _tail = 0;
+    }
 
-    auto firstIter = std::find_if(_pendingList.begin(), _pendingList.end(), removeFilterFunc);
-    if (firstIter != _pendingList.end())
+    VkDeviceSize alignedHead = (_head + alignment - 1) / alignment * alignment;
+    if (isEmpty || _head > _tail)
+    {
+        // Free space is [head, end) then [0, tail)
+        if (alignedHead + size <= _ringSize)
+            offset = alignedHead;
+        else if (size <= _tail)
+            offset = 0;
+        else
+            return false;
+    }
+    else if (_head < _tail && alignedHead + size <= _tail)
+    {
+        offset = alignedHead;
+    }
+    else
     {
-        _freeStagingBuffer.push_back(firstIter->buffer);
-
-        for (auto iter = firstIter; ++iter != _pendingList.end();)
-        {
-            if (removeFilterFunc(*iter))
-            {
-                _freeStagingBuffer.push_back(iter->buffer);
-            }
-            else
-            {
-                *firstIter = std::move(*iter);
-                firstIter++;
-            }
-        }
-
-        _pendingList.erase(firstIter, _pendingList.end());
+        return false;
     }
+
+    _head = offset + size;
+
+    if (!_segmentQueue.empty() && _segmentQueue.back().semaphore == semaphore && _segmentQueue.back().value == value)
+        _segmentQueue.back().end = _head;
+    else
+        _segmentQueue.push_back({_head, semaphore, value});
+
+    _peakUsedSize = std::max(_peakUsedSize, GetUsedSize());
+
+    return true;
+}
+
+VkDeviceSize VulkanBufferManager::GetUsedSize()
+{
+    if (_segmentQueue.empty())
+        return 0;
+
+    return _head > _tail ? _head - _tail : _ringSize - _tail + _head;
+}
+
+VkDeviceSize VulkanBufferManager::GetRingSize()
+{
+    return _ringSize;
+}
+
+VkDeviceSize VulkanBufferManager::GetPeakUsedSize()
+{
+    return _peakUsedSize;
+}
+
+uint32_t VulkanBufferManager::GetTemporaryBufferCount()
+{
+    return _temporaryBufferCount;
 }
 
-} // namespace ZE
+} // namespace ZE
\ No newline at end of file
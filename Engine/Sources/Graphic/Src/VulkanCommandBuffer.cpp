@@ -9,13 +9,13 @@
 
 namespace ZE {
 
-VulkanCommandBuffer::VulkanCommandBuffer(TPtr<VulkanCommandPool> commandPool)
-    : _commandPool(commandPool), _vkCommandBuffer(VK_NULL_HANDLE), _vkFence(VK_NULL_HANDLE), _status(EStatus::Initial), _executeCount(0)
+VulkanCommandBuffer::VulkanCommandBuffer(TPtr<VulkanCommandPool> commandPool, VkCommandBufferLevel level)
+    : _commandPool(commandPool), _vkCommandBuffer(VK_NULL_HANDLE), _level(level), _vkFence(VK_NULL_HANDLE), _status(EStatus::Initial), _executeCount(0)
 {
     VkCommandBufferAllocateInfo allocInfo{};
     allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
     allocInfo.commandPool = _commandPool->GetRawCommandPool();
-    allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    allocInfo.level = level;
     allocInfo.commandBufferCount = 1;
 
     _vkCommandBuffer;
@@ -57,6 +57,29 @@ void VulkanCommandBuffer::Begin()
     _executeCount++;
 }
 
+void VulkanCommandBuffer::BeginSecondary(TPtr<VulkanRenderPass> renderPass, TPtr<VulkanFramebuffer> framebuffer)
+{
+    if (_level != VK_COMMAND_BUFFER_LEVEL_SECONDARY)
+        throw std::runtime_error("only secondary command buffers can continue a render pass!");
+
+    VkCommandBufferInheritanceInfo inheritanceInfo{};
+    inheritanceInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+    inheritanceInfo.renderPass = renderPass->GetRawRenderPass();
+    inheritanceInfo.subpass = 0;
+    // Optional, knowing it up front lets the driver skip a patch pass at execution
+    inheritanceInfo.framebuffer = framebuffer != nullptr ? framebuffer->GetRawFramebuffer() : VK_NULL_HANDLE;
+
+    VkCommandBufferBeginInfo beginInfo{};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+    beginInfo.pInheritanceInfo = &inheritanceInfo;
+
+    vkBeginCommandBuffer(_vkCommandBuffer, &beginInfo);
+
+    _status = EStatus::Recording;
+    _executeCount++;
+}
+
 void VulkanCommandBuffer::End()
 {
     vkEndCommandBuffer(_vkCommandBuffer);
@@ -64,7 +87,7 @@ void VulkanCommandBuffer::End()
     _status = EStatus::Executable;
 }
 
-void VulkanCommandBuffer::BeginRenderPass(TPtr<VulkanRenderPass> renderPass, TPtr<VulkanFramebuffer> framebuffer, const VkRect2D& renderArea, const std::vector<VkClearValue>& clearColors)
+void VulkanCommandBuffer::BeginRenderPass(TPtr<VulkanRenderPass> renderPass, TPtr<VulkanFramebuffer> framebuffer, const VkRect2D& renderArea, const std::vector<VkClearValue>& clearColors, VkSubpassContents contents)
 {
     VkRenderPassBeginInfo renderPassInfo{};
     renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
@@ -75,7 +98,7 @@ void VulkanCommandBuffer::BeginRenderPass(TPtr<VulkanRenderPass> renderPass, TPt
     renderPassInfo.clearValueCount = clearColors.size();
     renderPassInfo.pClearValues = clearColors.data();
 
-    vkCmdBeginRenderPass(_vkCommandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+    vkCmdBeginRenderPass(_vkCommandBuffer, &renderPassInfo, contents);
 }
 
 void VulkanCommandBuffer::EndRenderPass()
@@ -83,6 +106,19 @@ void VulkanCommandBuffer::EndRenderPass()
     vkCmdEndRenderPass(_vkCommandBuffer);
 }
 
+void VulkanCommandBuffer::ExecuteCommands(const TPtrArr<VulkanCommandBuffer>& commandBufferArr)
+{
+    if (commandBufferArr.empty())
+        return;
+
+    std::vector<VkCommandBuffer> vkCommandBufferArr;
+    vkCommandBufferArr.reserve(commandBufferArr.size());
+    for (const TPtr<VulkanCommandBuffer>& commandBuffer : commandBufferArr)
+        vkCommandBufferArr.push_back(commandBuffer->GetRawCommandBuffer());
+
+    vkCmdExecuteCommands(_vkCommandBuffer, static_cast<uint32_t>(vkCommandBufferArr.size()), vkCommandBufferArr.data());
+}
+
 uint32_t VulkanCommandBuffer::GetExecuteCount()
 {
     return _executeCount;
@@ -6,7 +6,7 @@
 
 namespace ZE {
 
-VulkanCommandPool::VulkanCommandPool(TPtr<VulkanDevice> device, uint32_t queueFamilyIndex)
+VulkanCommandPool::VulkanCommandPool(TPtr<VulkanDevice> device, uint32_t queueFamilyIndex, VkCommandPoolCreateFlags flags)
     : _device(device), _queueFamilyIndex(queueFamilyIndex), _vkCommandPool(VK_NULL_HANDLE)
 {
     VkDevice vkDevice = _device->GetRawDevice();
@@ -14,7 +14,7 @@ VulkanCommandPool::VulkanCommandPool(TPtr<VulkanDevice> device, uint32_t queueFa
 
     VkCommandPoolCreateInfo poolInfo{};
     poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
-    poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+    poolInfo.flags = flags;
     poolInfo.queueFamilyIndex = graphicQueueFamilyIndex;
 
     if (vkCreateCommandPool(vkDevice, &poolInfo, nullptr, &_vkCommandPool) != VK_SUCCESS)
@@ -31,6 +31,13 @@ VulkanCommandPool::~VulkanCommandPool()
     vkDestroyCommandPool(vkDevice, _vkCommandPool, nullptr);
 }
 
+void VulkanCommandPool::Reset()
+{
+    if (vkResetCommandPool(_device->GetRawDevice(), _vkCommandPool, 0) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to reset command pool!");
+    }
+}
 
 VkCommandPool VulkanCommandPool::GetRawCommandPool()
 {
@@ -0,0 +1,128 @@
+#include "VulkanDeletionQueue.h"
+#include "VulkanTimelineSemaphore.h"
+
+#include <algorithm>
+
+
+namespace ZE {
+
+VulkanDeletionQueue::VulkanDeletionQueue(TPtr<VulkanTimelineSemaphore> frameTimeline, uint32_t maxDeletionsPerTick)
+    : _frameTimeline(frameTimeline), _maxDeletionsPerTick(maxDeletionsPerTick), _frameValue(frameTimeline->GetCompletedValue() + 1), _deletionCount(0)
+{
+}
+
+VulkanDeletionQueue::~VulkanDeletionQueue()
+{
+    Flush();
+}
+
+void VulkanDeletionQueue::Enqueue(Deleter deleter, TPtr<VulkanTimelineSemaphore> semaphore, uint64_t value)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    _entryQueue.push_back({std::move(deleter), _frameValue, semaphore, value});
+}
+
+void VulkanDeletionQueue::Tick(uint64_t frameValue)
+{
+    std::vector<Deleter> readyArr;
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        _frameValue = frameValue;
+
+        uint64_t completedValue = _frameTimeline->GetCompletedValue();
+
+        for (auto it = _timelineEntryArr.begin(); it != _timelineEntryArr.end() && readyArr.size() < _maxDeletionsPerTick;)
+        {
+            if (it->semaphore->GetCompletedValue() >= it->value)
+            {
+                readyArr.push_back(std::move(it->deleter));
+                it = _timelineEntryArr.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+
+        while (!_entryQueue.empty() && readyArr.size() < _maxDeletionsPerTick && _entryQueue.front().frameValue <= completedValue)
+        {
+            Entry& entry = _entryQueue.front();
+            if (entry.semaphore != nullptr && entry.semaphore->GetCompletedValue() < entry.value)
+                _timelineEntryArr.push_back(std::move(entry));
+            else
+                readyArr.push_back(std::move(entry.deleter));
+
+            _entryQueue.pop_front();
+        }
+
+        _deletionCount += readyArr.size();
+    }
+
+    // Outside the lock, destroying an object may release others
+    for (Deleter& deleter : readyArr)
+        deleter();
+}
+
+void VulkanDeletionQueue::Flush()
+{
+    // Deleters may enqueue more work, drain until nothing is left
+    while (true)
+    {
+        std::vector<Deleter> readyArr;
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+
+            for (Entry& entry : _timelineEntryArr)
+                readyArr.push_back(std::move(entry.deleter));
+            for (Entry& entry : _entryQueue)
+                readyArr.push_back(std::move(entry.deleter));
+
+            _timelineEntryArr.clear();
+            _entryQueue.clear();
+            _deletionCount += readyArr.size();
+        }
+
+        if (readyArr.empty())
+            break;
+
+        for (Deleter& deleter : readyArr)
+            deleter();
+    }
+}
+
+uint64_t VulkanDeletionQueue::GetFrameValue()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    return _frameValue;
+}
+
+bool VulkanDeletionQueue::IsReleased(uint64_t frameValue)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    if (!_entryQueue.empty() && _entryQueue.front().frameValue <= frameValue)
+        return false;
+
+    return std::none_of(_timelineEntryArr.begin(), _timelineEntryArr.end(), [frameValue](const Entry& entry) { return entry.frameValue <= frameValue; });
+}
+
+uint32_t VulkanDeletionQueue::GetPendingCount()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    return static_cast<uint32_t>(_entryQueue.size() + _timelineEntryArr.size());
+}
+
+uint64_t VulkanDeletionQueue::GetDeletionCount()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    return _deletionCount;
+}
+
+} // namespace ZE
\ No newline at end of file
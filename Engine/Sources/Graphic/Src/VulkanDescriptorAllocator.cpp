@@ -0,0 +1,78 @@
+#include "VulkanDescriptorAllocator.h"
+#include "VulkanDescriptorPool.h"
+#include "VulkanDescriptorSet.h"
+#include "VulkanDescriptorSetLayout.h"
+#include "VulkanDevice.h"
+
+#include <stdexcept>
+
+
+namespace ZE {
+
+VulkanDescriptorAllocator::VulkanDescriptorAllocator(TPtr<VulkanDevice> device, const std::vector<VkDescriptorPoolSize>& descriptorPoolSizeArr, uint32_t maxSetsPerPool)
+    : _device(device), _descriptorPoolSizeArr(descriptorPoolSizeArr), _maxSetsPerPool(maxSetsPerPool), _currentPoolIndex(0), _allocationCount(0)
+{
+    _poolArr.push_back(CreatePool());
+}
+
+VulkanDescriptorAllocator::~VulkanDescriptorAllocator()
+{
+}
+
+TPtr<VulkanDescriptorSet> VulkanDescriptorAllocator::Allocate(TPtr<VulkanDescriptorSetLayout> descriptorSetLayout)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    VkDescriptorSetLayout vkDescriptorSetLayout = descriptorSetLayout->GetRawDescriptorSetLayout();
+    VkDescriptorSet vkDescriptorSet = VK_NULL_HANDLE;
+
+    // Starting from the current pool, earlier pools get space back as their sets are freed
+    for (size_t i = 0; i < _poolArr.size(); i++)
+    {
+        size_t poolIndex = (_currentPoolIndex + i) % _poolArr.size();
+        VkResult result = _poolArr[poolIndex]->Allocate(vkDescriptorSetLayout, vkDescriptorSet);
+        if (result == VK_SUCCESS)
+        {
+            _currentPoolIndex = poolIndex;
+            _allocationCount++;
+            return std::make_shared<VulkanDescriptorSet>(_poolArr[poolIndex], descriptorSetLayout, vkDescriptorSet);
+        }
+
+        if (result != VK_ERROR_OUT_OF_POOL_MEMORY && result != VK_ERROR_FRAGMENTED_POOL)
+        {
+            throw std::runtime_error("failed to allocate descriptor sets!");
+        }
+    }
+
+    _poolArr.push_back(CreatePool());
+    _currentPoolIndex = _poolArr.size() - 1;
+
+    if (_poolArr.back()->Allocate(vkDescriptorSetLayout, vkDescriptorSet) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to allocate descriptor sets!");
+    }
+
+    _allocationCount++;
+    return std::make_shared<VulkanDescriptorSet>(_poolArr.back(), descriptorSetLayout, vkDescriptorSet);
+}
+
+uint32_t VulkanDescriptorAllocator::GetPoolCount()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    return static_cast<uint32_t>(_poolArr.size());
+}
+
+uint64_t VulkanDescriptorAllocator::GetAllocationCount()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    return _allocationCount;
+}
+
+TPtr<VulkanDescriptorPool> VulkanDescriptorAllocator::CreatePool()
+{
+    return std::make_shared<VulkanDescriptorPool>(_device, _descriptorPoolSizeArr, _maxSetsPerPool);
+}
+
+} // namespace ZE
\ No newline at end of file
@@ -7,13 +7,13 @@
 namespace ZE {
 
 VulkanDescriptorPool::VulkanDescriptorPool(TPtr<VulkanDevice> device,
-                                           const std::vector<VkDescriptorPoolSize>& descriptorPoolSizeArr)
+                                           const std::vector<VkDescriptorPoolSize>& descriptorPoolSizeArr, uint32_t maxSets)
     : _device(device), _descriptorPool(VK_NULL_HANDLE)
 {
     VkDescriptorPoolCreateInfo poolInfo{};
     poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
     poolInfo.flags = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT;
-    poolInfo.maxSets = 2;
+    poolInfo.maxSets = maxSets;
     poolInfo.poolSizeCount = static_cast<uint32_t>(descriptorPoolSizeArr.size());
     poolInfo.pPoolSizes = descriptorPoolSizeArr.data();
 
@@ -38,4 +38,15 @@ VkDescriptorPool VulkanDescriptorPool::GetRawDescriptorPool()
     return _descriptorPool;
 }
 
+VkResult VulkanDescriptorPool::Allocate(VkDescriptorSetLayout vkDescriptorSetLayout, VkDescriptorSet& vkDescriptorSet)
+{
+    VkDescriptorSetAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocInfo.descriptorPool = _descriptorPool;
+    allocInfo.descriptorSetCount = 1;
+    allocInfo.pSetLayouts = &vkDescriptorSetLayout;
+
+    return vkAllocateDescriptorSets(_device->GetRawDevice(), &allocInfo, &vkDescriptorSet);
+}
+
 } // namespace ZE
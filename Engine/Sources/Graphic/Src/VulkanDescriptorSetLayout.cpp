@@ -1,5 +1,6 @@
 #include "VulkanDescriptorSetLayout.h"
 #include "VulkanDevice.h"
+#include "CoreHash.h"
 
 #include <stdexcept>
 
@@ -7,10 +8,16 @@
 namespace ZE {
 
 VulkanDescriptorSetLayout::VulkanDescriptorSetLayout(TPtr<VulkanDevice> device, const std::vector<VkDescriptorSetLayoutBinding>& layoutBindings)
-    : _device(device), _vkDescriptorSetLayout(VK_NULL_HANDLE)
+    : _device(device), _vkDescriptorSetLayout(VK_NULL_HANDLE), _layoutHash(0)
 {
     VkDevice vkDevice = _device->GetRawDevice();
 
+    HashWriter writer;
+    writer.Write(static_cast<uint32_t>(layoutBindings.size()));
+    for (const VkDescriptorSetLayoutBinding& binding : layoutBindings)
+        writer.Write(binding.binding).Write(binding.descriptorType).Write(binding.descriptorCount).Write(binding.stageFlags);
+    _layoutHash = writer.GetHash();
+
     VkDescriptorSetLayoutCreateInfo layoutInfo{};
     layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
     layoutInfo.bindingCount = layoutBindings.size();
@@ -29,6 +36,11 @@ VulkanDescriptorSetLayout::~VulkanDescriptorSetLayout()
     vkDestroyDescriptorSetLayout(vkDevice, _vkDescriptorSetLayout, nullptr);
 }
 
+uint64_t VulkanDescriptorSetLayout::GetLayoutHash()
+{
+    return _layoutHash;
+}
+
 VkDescriptorSetLayout VulkanDescriptorSetLayout::GetRawDescriptorSetLayout()
 {
     return _vkDescriptorSetLayout;
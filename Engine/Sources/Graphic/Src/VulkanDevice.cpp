@@ -1,15 +1,21 @@
 #include "VulkanDevice.h"
 #include "VulkanGPU.h"
+#include "VulkanMemoryAllocator.h"
+#include "VulkanDeletionQueue.h"
+#include "VulkanTimelineSemaphore.h"
 
 #include <string>
 #include <stdexcept>
+#include <algorithm>
+#include <cstring>
 
 
 namespace ZE {
 
 VulkanDevice::VulkanDevice(TPtr<VulkanGPU> GPU)
     : _GPU(GPU), _vkDevice(VK_NULL_HANDLE), _graphicQueueFamilyIndex(-1),
-      _computeQueueFamilyIndex(-1), _transferQueueFamilyIndex(-1)
+      _computeQueueFamilyIndex(-1), _transferQueueFamilyIndex(-1), _isSynchronization2Supported(false),
+      _isDrawIndirectCountSupported(false), _isPresentWaitSupported(false), _vkWaitForPresentKHR(nullptr)
 {
     // Queue
     std::vector<VkQueueFamilyProperties> queueFamilyProperties = _GPU->GetQueueFamilyProperties();
@@ -71,13 +77,110 @@ VulkanDevice::VulkanDevice(TPtr<VulkanGPU> GPU)
 #ifdef ZE_PLATFORM_MACOS
     deviceExtensions.push_back("VK_KHR_portability_subset");
 #endif
+    bool isMemoryBudgetSupported = _GPU->IsExtensionSupported(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+    if (isMemoryBudgetSupported)
+        deviceExtensions.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+
+    // Lets the frame pacer wait for a frame to reach the display, only meaningful with a swapchain
+    bool hasSwapchain = std::any_of(deviceExtensions.begin(), deviceExtensions.end(), [](const char* extension) { return strcmp(extension, VK_KHR_SWAPCHAIN_EXTENSION_NAME) == 0; });
+    if (hasSwapchain && _GPU->IsExtensionSupported(VK_KHR_PRESENT_ID_EXTENSION_NAME) && _GPU->IsExtensionSupported(VK_KHR_PRESENT_WAIT_EXTENSION_NAME))
+    {
+        VkPhysicalDevicePresentWaitFeaturesKHR supportedPresentWaitFeatures{};
+        supportedPresentWaitFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR;
+
+        VkPhysicalDevicePresentIdFeaturesKHR supportedPresentIdFeatures{};
+        supportedPresentIdFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR;
+        supportedPresentIdFeatures.pNext = &supportedPresentWaitFeatures;
+
+        VkPhysicalDeviceFeatures2 supportedFeatures{};
+        supportedFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+        supportedFeatures.pNext = &supportedPresentIdFeatures;
+        vkGetPhysicalDeviceFeatures2(_GPU->GetRawGPU(), &supportedFeatures);
+
+        _isPresentWaitSupported = supportedPresentIdFeatures.presentId == VK_TRUE && supportedPresentWaitFeatures.presentWait == VK_TRUE;
+    }
+
+    if (_isPresentWaitSupported)
+    {
+        deviceExtensions.push_back(VK_KHR_PRESENT_ID_EXTENSION_NAME);
+        deviceExtensions.push_back(VK_KHR_PRESENT_WAIT_EXTENSION_NAME);
+    }
 
     // Features
     VkPhysicalDeviceFeatures deviceFeatures{};
     deviceFeatures.samplerAnisotropy = VK_TRUE;
 
+    // Core since 1.2. Frames, async uploads and the deletion queue all track completion on timelines,
+    // there is no fence based fallback
+    if (_GPU->GetProperties().apiVersion < VK_API_VERSION_1_2)
+    {
+        throw std::runtime_error("timeline semaphores required, the device doesn't support Vulkan 1.2!");
+    }
+
+    VkPhysicalDeviceVulkan12Features supportedFeatures12{};
+    supportedFeatures12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+
+    VkPhysicalDeviceFeatures2 supportedFeatures{};
+    supportedFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+    supportedFeatures.pNext = &supportedFeatures12;
+    vkGetPhysicalDeviceFeatures2(_GPU->GetRawGPU(), &supportedFeatures);
+
+    if (supportedFeatures12.timelineSemaphore != VK_TRUE)
+    {
+        throw std::runtime_error("timeline semaphores required, the device doesn't support them!");
+    }
+
+    VkPhysicalDeviceVulkan12Features deviceFeatures12{};
+    deviceFeatures12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+    deviceFeatures12.timelineSemaphore = VK_TRUE;
+
+    // GPU culling writes draws whose first instance selects the object, and their count
+    _isDrawIndirectCountSupported = supportedFeatures12.drawIndirectCount == VK_TRUE && supportedFeatures.features.drawIndirectFirstInstance == VK_TRUE;
+
+    if (_isDrawIndirectCountSupported)
+    {
+        deviceFeatures.drawIndirectFirstInstance = VK_TRUE;
+        deviceFeatures12.drawIndirectCount = VK_TRUE;
+    }
+
+    // Core since 1.3, queues submit through vkQueueSubmit2 when it is there
+    if (_GPU->GetProperties().apiVersion >= VK_API_VERSION_1_3)
+    {
+        VkPhysicalDeviceVulkan13Features supportedFeatures13{};
+        supportedFeatures13.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES;
+
+        VkPhysicalDeviceFeatures2 supportedFeatures2{};
+        supportedFeatures2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+        supportedFeatures2.pNext = &supportedFeatures13;
+        vkGetPhysicalDeviceFeatures2(_GPU->GetRawGPU(), &supportedFeatures2);
+
+        _isSynchronization2Supported = supportedFeatures13.synchronization2 == VK_TRUE;
+    }
+
+    VkPhysicalDeviceVulkan13Features deviceFeatures13{};
+    deviceFeatures13.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES;
+    deviceFeatures13.synchronization2 = VK_TRUE;
+    if (_isSynchronization2Supported)
+        deviceFeatures12.pNext = &deviceFeatures13;
+
+    VkPhysicalDevicePresentWaitFeaturesKHR presentWaitFeatures{};
+    presentWaitFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR;
+    presentWaitFeatures.presentWait = VK_TRUE;
+
+    VkPhysicalDevicePresentIdFeaturesKHR presentIdFeatures{};
+    presentIdFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR;
+    presentIdFeatures.presentId = VK_TRUE;
+    presentIdFeatures.pNext = &presentWaitFeatures;
+
+    if (_isPresentWaitSupported)
+    {
+        presentWaitFeatures.pNext = deviceFeatures12.pNext;
+        deviceFeatures12.pNext = &presentIdFeatures;
+    }
+
     VkDeviceCreateInfo vkDeviceCreateInfo{};
     vkDeviceCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+    vkDeviceCreateInfo.pNext = &deviceFeatures12;
     vkDeviceCreateInfo.pQueueCreateInfos = queueCreateInfos.data();
     vkDeviceCreateInfo.queueCreateInfoCount = static_cast<uint32_t>(queueCreateInfos.size());
     vkDeviceCreateInfo.pEnabledFeatures = &deviceFeatures;
@@ -88,10 +191,17 @@ VulkanDevice::VulkanDevice(TPtr<VulkanGPU> GPU)
     {
         throw std::runtime_error("create device fail!");
     }
+
+    _memoryAllocator = std::make_shared<VulkanMemoryAllocator>(_vkDevice, _GPU, isMemoryBudgetSupported);
+
+    if (_isPresentWaitSupported)
+        _vkWaitForPresentKHR = reinterpret_cast<PFN_vkWaitForPresentKHR>(vkGetDeviceProcAddr(_vkDevice, "vkWaitForPresentKHR"));
 }
 
 VulkanDevice::~VulkanDevice()
 {
+    _memoryAllocator.reset();
+
     if (_vkDevice != VK_NULL_HANDLE)
         vkDestroyDevice(_vkDevice, nullptr);
 }
@@ -146,6 +256,58 @@ TPtr<VulkanGPU> VulkanDevice::GetGPU()
     return _GPU;
 }
 
+TPtr<VulkanMemoryAllocator> VulkanDevice::GetMemoryAllocator()
+{
+    return _memoryAllocator;
+}
+
+void VulkanDevice::SetDeletionQueue(TPtr<VulkanDeletionQueue> deletionQueue)
+{
+    _deletionQueue = deletionQueue;
+}
+
+TPtr<VulkanDeletionQueue> VulkanDevice::GetDeletionQueue()
+{
+    return _deletionQueue;
+}
+
+void VulkanDevice::DeferDestruction(std::function<void()> deleter, TPtr<VulkanTimelineSemaphore> semaphore, uint64_t value)
+{
+    if (_deletionQueue != nullptr)
+    {
+        _deletionQueue->Enqueue(std::move(deleter), semaphore, value);
+        return;
+    }
+
+    if (semaphore != nullptr)
+        semaphore->Wait(value);
+
+    deleter();
+}
+
+bool VulkanDevice::IsSynchronization2Supported()
+{
+    return _isSynchronization2Supported;
+}
+
+bool VulkanDevice::IsDrawIndirectCountSupported()
+{
+    return _isDrawIndirectCountSupported;
+}
+
+bool VulkanDevice::IsPresentWaitSupported()
+{
+    return _isPresentWaitSupported;
+}
+
+VkResult VulkanDevice::WaitForPresent(VkSwapchainKHR swapchain, uint64_t presentId, uint64_t timeout)
+{
+    if (_vkWaitForPresentKHR == nullptr)
+        return VK_ERROR_EXTENSION_NOT_PRESENT;
+
+    return _vkWaitForPresentKHR(_vkDevice, swapchain, presentId, timeout);
+}
+
 VkDevice VulkanDevice::GetRawDevice()
 {
     return _vkDevice;
@@ -11,7 +11,7 @@
 namespace ZE {
 
 VulkanFramebuffer::VulkanFramebuffer(TPtr<VulkanDevice> device, TPtr<VulkanRenderPass> renderPass, const TPtrArr<VulkanImageView>& imageViewArr, const VkExtent2D& extent)
-    : _device(device), _vkFramebuffer(VK_NULL_HANDLE)
+    : _device(device), _renderPass(renderPass), _vkFramebuffer(VK_NULL_HANDLE)
 {
     std::copy(imageViewArr.begin(), imageViewArr.end(), std::back_inserter(_imageViewArr));
     std::vector<VkImageView> vkImageViewArr;
@@ -36,10 +36,39 @@ VulkanFramebuffer::VulkanFramebuffer(TPtr<VulkanDevice> device, TPtr<VulkanRende
 
 VulkanFramebuffer::~VulkanFramebuffer()
 {
-    if (_vkFramebuffer != VK_NULL_HANDLE)
-        vkDestroyFramebuffer(_device->GetRawDevice(), _vkFramebuffer, nullptr);
+    if (_vkFramebuffer == VK_NULL_HANDLE)
+        return;
+
+    _device->DeferDestruction([device = _device, vkFramebuffer = _vkFramebuffer]() {
+        vkDestroyFramebuffer(device->GetRawDevice(), vkFramebuffer, nullptr);
+    });
+}
+
+bool VulkanFramebuffer::IsValid()
+{
+    return std::none_of(_imageViewArr.begin(), _imageViewArr.end(), [](const TWeakPtr<VulkanImageView>& imageView) {
+        return imageView.expired();
+    });
 }
 
+bool VulkanFramebuffer::IsAttachedTo(const TPtrArr<VulkanImageView>& imageViewArr)
+{
+    if (imageViewArr.size() != _imageViewArr.size())
+        return false;
+
+    for (size_t i = 0; i < imageViewArr.size(); i++)
+    {
+        if (_imageViewArr[i].lock() != imageViewArr[i])
+            return false;
+    }
+
+    return true;
+}
+
+TPtr<VulkanRenderPass> VulkanFramebuffer::GetRenderPass()
+{
+    return _renderPass;
+}
 
 VkFramebuffer VulkanFramebuffer::GetRawFramebuffer()
 {
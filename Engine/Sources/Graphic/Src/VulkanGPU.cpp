@@ -5,13 +5,14 @@
 #include <stdexcept>
 #include <set>
 #include <string>
+#include <cstring>
 
 
 namespace ZE {
 
-VulkanGPU::VulkanGPU(const VkInstance& vkInstance)
+VulkanGPU::VulkanGPU(const VkInstance& vkInstance, const std::vector<const char*>& deviceExtensions)
     : _vkInstance(vkInstance),
-      _GPU(VK_NULL_HANDLE), _deviceExtensions({VK_KHR_SWAPCHAIN_EXTENSION_NAME})
+      _GPU(VK_NULL_HANDLE), _deviceExtensions(deviceExtensions)
 {
     std::vector<VkPhysicalDevice> GPUs = GetSupportedRawGPUs();
 
@@ -66,6 +67,18 @@ std::vector<VkExtensionProperties> VulkanGPU::GetExtensionProperties(VkPhysicalD
     return availableExtensions;
 }
 
+bool VulkanGPU::IsExtensionSupported(const char* extensionName)
+{
+    std::vector<VkExtensionProperties> availableExtensions = GetExtensionProperties(_GPU);
+    for (const VkExtensionProperties& extension : availableExtensions)
+    {
+        if (strcmp(extension.extensionName, extensionName) == 0)
+            return true;
+    }
+
+    return false;
+}
+
 std::vector<VkQueueFamilyProperties> VulkanGPU::GetQueueFamilyProperties()
 {
     uint32_t queueFamilyCount = 0;
@@ -77,6 +90,14 @@ std::vector<VkQueueFamilyProperties> VulkanGPU::GetQueueFamilyProperties()
     return queueFamilieProperties;
 }
 
+VkPhysicalDeviceProperties VulkanGPU::GetProperties()
+{
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(_GPU, &properties);
+
+    return properties;
+}
+
 bool VulkanGPU::isSurfaceSupported(uint32_t queueFamilyIndex, TPtr<VulkanSurface> surface)
 {
     VkBool32 isSupported;
@@ -85,6 +106,15 @@ bool VulkanGPU::isSurfaceSupported(uint32_t queueFamilyIndex, TPtr<VulkanSurface
 }
 
 uint32_t VulkanGPU::FindMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties)
+{
+    uint32_t typeIndex;
+    if (!TryFindMemoryType(typeFilter, properties, typeIndex))
+        throw std::runtime_error("failed to find suitable memory type!");
+
+    return typeIndex;
+}
+
+bool VulkanGPU::TryFindMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties, uint32_t& typeIndex)
 {
     VkPhysicalDeviceMemoryProperties memProperties;
     vkGetPhysicalDeviceMemoryProperties(_GPU, &memProperties);
@@ -93,11 +123,12 @@ uint32_t VulkanGPU::FindMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags pr
     {
         if ((typeFilter & (1 << i)) && (memProperties.memoryTypes[i].propertyFlags & properties) == properties)
         {
-            return i;
+            typeIndex = i;
+            return true;
         }
     }
 
-    throw std::runtime_error("failed to find suitable memory type!");
+    return false;
 }
 
 std::vector<VkPhysicalDevice> VulkanGPU::GetSupportedRawGPUs()
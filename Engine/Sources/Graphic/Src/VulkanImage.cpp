@@ -1,7 +1,9 @@
 #include "VulkanImage.h"
 #include "VulkanGPU.h"
 #include "VulkanDevice.h"
+#include "VulkanMemoryAllocator.h"
 #include "VulkanBuffer.h"
+#include "VulkanBufferManager.h"
 #include "VulkanCommandBuffer.h"
 #include "VulkanCommandPool.h"
 
@@ -10,8 +12,8 @@
 
 namespace ZE {
 
-VulkanImage::VulkanImage(TPtr<VulkanDevice> device, const VkExtent3D& extent, VkFormat format, VkImageUsageFlags usageFlags)
-    : _hasOwnship(true), _device(device), _extent(extent), _format(format), _layout(VK_IMAGE_LAYOUT_UNDEFINED), _vkImage(VK_NULL_HANDLE), _vkMemory(VK_NULL_HANDLE)
+VulkanImage::VulkanImage(TPtr<VulkanDevice> device, const VkExtent3D& extent, VkFormat format, VkImageUsageFlags usageFlags, VkMemoryPropertyFlags memoryProperties, EVulkanMemoryCategory category, uint32_t mipLevels)
+    : _hasOwnship(true), _device(device), _extent(extent), _format(format), _usageFlags(usageFlags), _mipLevels(mipLevels), _memoryProperties(memoryProperties), _layout(VK_IMAGE_LAYOUT_UNDEFINED), _vkImage(VK_NULL_HANDLE), _allocation{}, _timelineValue(0)
 {
     VkDeviceSize size = _extent.width * _extent.height * 4;
     VkDevice vkDevice = _device->GetRawDevice();
@@ -21,7 +23,7 @@ VulkanImage::VulkanImage(TPtr<VulkanDevice> device, const VkExtent3D& extent, Vk
     imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
     imageInfo.imageType = VK_IMAGE_TYPE_2D;
     imageInfo.extent = extent;
-    imageInfo.mipLevels = 1;
+    imageInfo.mipLevels = mipLevels;
     imageInfo.arrayLayers = 1;
     imageInfo.format = format;
     imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
@@ -39,21 +41,23 @@ VulkanImage::VulkanImage(TPtr<VulkanDevice> device, const VkExtent3D& extent, Vk
     VkMemoryRequirements memRequirements;
     vkGetImageMemoryRequirements(vkDevice, _vkImage, &memRequirements);
 
-    VkMemoryAllocateInfo allocInfo{};
-    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-    allocInfo.allocationSize = memRequirements.size;
-    allocInfo.memoryTypeIndex = _device->GetGPU()->FindMemoryType(memRequirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
-
-    if (vkAllocateMemory(vkDevice, &allocInfo, nullptr, &_vkMemory) != VK_SUCCESS)
+    TPtr<VulkanMemoryAllocator> memoryAllocator = _device->GetMemoryAllocator();
+    uint32_t memoryTypeIndex;
+    if (!memoryAllocator->TryFindMemoryType(memRequirements.memoryTypeBits, _memoryProperties, memoryTypeIndex))
     {
-        throw std::runtime_error("failed to allocate image memory!");
+        if ((_memoryProperties & VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT) == 0)
+            throw std::runtime_error("failed to find suitable memory type!");
+
+        _memoryProperties &= ~VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT;
+        memoryTypeIndex = memoryAllocator->FindMemoryType(memRequirements.memoryTypeBits, _memoryProperties);
     }
 
-    vkBindImageMemory(vkDevice, _vkImage, _vkMemory, 0);
+    _allocation = memoryAllocator->Allocate(memRequirements, memoryTypeIndex, EVulkanMemoryUsage::Optimal, category);
+    vkBindImageMemory(vkDevice, _vkImage, _allocation.memory, _allocation.offset);
 }
 
 VulkanImage::VulkanImage(TPtr<VulkanDevice> device, VkImage vkImage, const VkExtent3D& extent, VkFormat format, VkImageUsageFlags usageFlags)
-    : _hasOwnship(false), _device(device), _extent(extent), _format(format), _layout(VK_IMAGE_LAYOUT_UNDEFINED), _vkImage(vkImage), _vkMemory(VK_NULL_HANDLE)
+    : _hasOwnship(false), _device(device), _extent(extent), _format(format), _usageFlags(usageFlags), _mipLevels(1), _memoryProperties(0), _layout(VK_IMAGE_LAYOUT_UNDEFINED), _vkImage(vkImage), _allocation{}, _timelineValue(0)
 {
 }
 
@@ -61,16 +65,15 @@ VulkanImage::~VulkanImage()
 {
     if (_hasOwnship)
     {
-        VkDevice vkDevice = _device->GetRawDevice();
-
-        if (_vkImage != VK_NULL_HANDLE)
-            vkDestroyImage(vkDevice, _vkImage, nullptr);
+        // Frames in flight may still read the image
+        _device->DeferDestruction([device = _device, vkImage = _vkImage, allocation = _allocation]() mutable {
+            if (vkImage != VK_NULL_HANDLE)
+                vkDestroyImage(device->GetRawDevice(), vkImage, nullptr);
 
-        if (_vkMemory != VK_NULL_HANDLE)
-            vkFreeMemory(vkDevice, _vkMemory, nullptr);
+            device->GetMemoryAllocator()->Free(allocation);
+        }, _timelineSemaphore, _timelineValue);
     }
 
-    _vkMemory = VK_NULL_HANDLE;
     _vkImage = VK_NULL_HANDLE;
 }
 
@@ -83,51 +86,105 @@ void VulkanImage::TransitionLayout(TPtr<VulkanCommandBuffer> commandBuffer, VkIm
     barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
     barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
     barrier.image = _vkImage;
-    barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    barrier.subresourceRange.aspectMask = GetAspectMask(_format);
     barrier.subresourceRange.baseMipLevel = 0;
-    barrier.subresourceRange.levelCount = 1;
+    barrier.subresourceRange.levelCount = _mipLevels;
     barrier.subresourceRange.baseArrayLayer = 0;
     barrier.subresourceRange.layerCount = 1;
 
     VkPipelineStageFlags sourceStage;
     VkPipelineStageFlags destinationStage;
+    GetLayoutUsage(oldLayout, sourceStage, barrier.srcAccessMask);
+    GetLayoutUsage(newLayout, destinationStage, barrier.dstAccessMask);
 
-    if (oldLayout == VK_IMAGE_LAYOUT_UNDEFINED && newLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL)
-    {
-        barrier.srcAccessMask = 0;
-        barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    // Reads never need to be made available
+    barrier.srcAccessMask &= VK_ACCESS_TRANSFER_WRITE_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT | VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
 
-        sourceStage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
-        destinationStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
-    }
-    else if (oldLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL && newLayout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL)
-    {
-        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+    vkCmdPipelineBarrier(commandBuffer->GetRawCommandBuffer(), sourceStage, destinationStage, 0, 0, nullptr, 0, nullptr, 1, &barrier);
 
-        sourceStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
-        destinationStage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
-    }
-    else if (oldLayout == VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL && newLayout == VK_IMAGE_LAYOUT_PRESENT_SRC_KHR)
-    {
-        barrier.srcAccessMask = VK_ACCESS_NONE;
-        barrier.dstAccessMask = VK_ACCESS_NONE;
+    _layout = newLayout;
+}
 
-        sourceStage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
-        destinationStage = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+void VulkanImage::GetLayoutUsage(VkImageLayout layout, VkPipelineStageFlags& stageMask, VkAccessFlags& accessMask)
+{
+    switch (layout)
+    {
+    case VK_IMAGE_LAYOUT_UNDEFINED:
+        stageMask = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+        accessMask = VK_ACCESS_NONE;
+        break;
+    case VK_IMAGE_LAYOUT_PRESENT_SRC_KHR:
+        // The presentation engine is synchronized through the render finished semaphore
+        stageMask = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+        accessMask = VK_ACCESS_NONE;
+        break;
+    case VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL:
+        stageMask = VK_PIPELINE_STAGE_TRANSFER_BIT;
+        accessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        break;
+    case VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL:
+        stageMask = VK_PIPELINE_STAGE_TRANSFER_BIT;
+        accessMask = VK_ACCESS_TRANSFER_READ_BIT;
+        break;
+    case VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL:
+        stageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+        accessMask = VK_ACCESS_SHADER_READ_BIT;
+        break;
+    case VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL:
+        stageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+        accessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+        break;
+    case VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL:
+        stageMask = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+        accessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+        break;
+    case VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL:
+        stageMask = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+        accessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_SHADER_READ_BIT;
+        break;
+    default:
+        stageMask = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+        accessMask = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+        break;
     }
-    else
+}
+
+VkImageAspectFlags VulkanImage::GetAspectMask(VkFormat format)
+{
+    switch (format)
     {
-        throw std::invalid_argument("unsupported layout transition!");
+    case VK_FORMAT_D16_UNORM:
+    case VK_FORMAT_X8_D24_UNORM_PACK32:
+    case VK_FORMAT_D32_SFLOAT:
+        return VK_IMAGE_ASPECT_DEPTH_BIT;
+    case VK_FORMAT_S8_UINT:
+        return VK_IMAGE_ASPECT_STENCIL_BIT;
+    case VK_FORMAT_D16_UNORM_S8_UINT:
+    case VK_FORMAT_D24_UNORM_S8_UINT:
+    case VK_FORMAT_D32_SFLOAT_S8_UINT:
+        return VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT;
+    default:
+        return VK_IMAGE_ASPECT_COLOR_BIT;
     }
+}
 
-    vkCmdPipelineBarrier(commandBuffer->GetRawCommandBuffer(), sourceStage, destinationStage, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+void VulkanImage::CopyFromBuffer(TPtr<VulkanCommandBuffer> commandBuffer, TPtr<VulkanBuffer> buffer, VkOffset3D offset, VkExtent3D extent, VkDeviceSize bufferOffset)
+{
+    VkBufferImageCopy region{};
+    region.bufferOffset = bufferOffset;
+    region.bufferRowLength = 0;
+    region.bufferImageHeight = 0;
+    region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    region.imageSubresource.mipLevel = 0;
+    region.imageSubresource.baseArrayLayer = 0;
+    region.imageSubresource.layerCount = 1;
+    region.imageOffset = offset;
+    region.imageExtent = extent;
 
-    _layout = newLayout;
+    vkCmdCopyBufferToImage(commandBuffer->GetRawCommandBuffer(), buffer->GetRawBuffer(), _vkImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
 }
 
-
-void VulkanImage::CopyFromBuffer(TPtr<VulkanCommandBuffer> commandBuffer, TPtr<VulkanBuffer> buffer, VkOffset3D offset, VkExtent3D extent)
+void VulkanImage::CopyToBuffer(TPtr<VulkanCommandBuffer> commandBuffer, TPtr<VulkanBuffer> buffer, VkOffset3D offset, VkExtent3D extent)
 {
     VkBufferImageCopy region{};
     region.bufferOffset = 0;
@@ -140,19 +197,15 @@ void VulkanImage::CopyFromBuffer(TPtr<VulkanCommandBuffer> commandBuffer, TPtr<V
     region.imageOffset = offset;
     region.imageExtent = extent;
 
-    vkCmdCopyBufferToImage(commandBuffer->GetRawCommandBuffer(), buffer->GetRawBuffer(), _vkImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+    vkCmdCopyImageToBuffer(commandBuffer->GetRawCommandBuffer(), _vkImage, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, buffer->GetRawBuffer(), 1, &region);
 }
 
-void VulkanImage::TransferData(TPtr<VulkanCommandBuffer> commandBuffer, TPtr<VulkanBuffer> stagingBuffer, const void* data, uint32_t size)
+void VulkanImage::TransferData(TPtr<VulkanCommandBuffer> commandBuffer, TPtr<VulkanBufferManager> bufferManager, const void* data, uint32_t size)
 {
-    VkDeviceSize imageSize = size;
-
-    void* mappedAddress = stagingBuffer->MapMemory(0, size);
-    memcpy(mappedAddress, data, size);
-    stagingBuffer->UnmapMemory();
+    StagingAllocation staging = bufferManager->Stage(data, size);
 
     TransitionLayout(commandBuffer, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
-    CopyFromBuffer(commandBuffer, stagingBuffer, {0, 0, 0}, _extent);
+    CopyFromBuffer(commandBuffer, staging.buffer, {0, 0, 0}, _extent, staging.offset);
     TransitionLayout(commandBuffer, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
 }
 
@@ -176,6 +229,21 @@ VkFormat VulkanImage::GetFormat()
     return _format;
 }
 
+VkImageUsageFlags VulkanImage::GetUsage()
+{
+    return _usageFlags;
+}
+
+uint32_t VulkanImage::GetMipLevels()
+{
+    return _mipLevels;
+}
+
+bool VulkanImage::IsLazilyAllocated()
+{
+    return (_memoryProperties & VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT) != 0;
+}
+
 TPtr<VulkanDevice> VulkanImage::GetDevice()
 {
     return _device;
@@ -7,7 +7,7 @@
 
 namespace ZE {
 
-VulkanImageView::VulkanImageView(TPtr<VulkanImage> image, VkFormat format, VkImageAspectFlagBits accessFlags)
+VulkanImageView::VulkanImageView(TPtr<VulkanImage> image, VkFormat format, VkImageAspectFlagBits accessFlags, uint32_t baseMipLevel, uint32_t levelCount)
     : _format(format), _accessFlags(accessFlags), _vkImageView(VK_NULL_HANDLE), _image(image)
 {
     VkImageViewCreateInfo imageViewCreateInfo{};
@@ -20,8 +20,8 @@ VulkanImageView::VulkanImageView(TPtr<VulkanImage> image, VkFormat format, VkIma
     imageViewCreateInfo.components.b = VK_COMPONENT_SWIZZLE_IDENTITY;
     imageViewCreateInfo.components.a = VK_COMPONENT_SWIZZLE_IDENTITY;
     imageViewCreateInfo.subresourceRange.aspectMask = accessFlags;
-    imageViewCreateInfo.subresourceRange.baseMipLevel = 0;
-    imageViewCreateInfo.subresourceRange.levelCount = 1;
+    imageViewCreateInfo.subresourceRange.baseMipLevel = baseMipLevel;
+    imageViewCreateInfo.subresourceRange.levelCount = levelCount;
     imageViewCreateInfo.subresourceRange.baseArrayLayer = 0;
     imageViewCreateInfo.subresourceRange.layerCount = 1;
 
@@ -33,8 +33,13 @@ VulkanImageView::VulkanImageView(TPtr<VulkanImage> image, VkFormat format, VkIma
 
 VulkanImageView::~VulkanImageView()
 {
-    if (_vkImageView != VK_NULL_HANDLE)
-        vkDestroyImageView(_image->GetDevice()->GetRawDevice(), _vkImageView, nullptr);
+    if (_vkImageView == VK_NULL_HANDLE)
+        return;
+
+    // Keeps the image alive until the view is gone
+    _image->GetDevice()->DeferDestruction([image = _image, vkImageView = _vkImageView]() {
+        vkDestroyImageView(image->GetDevice()->GetRawDevice(), vkImageView, nullptr);
+    });
 }
 
 TPtr<VulkanImage> VulkanImageView::GetImage()
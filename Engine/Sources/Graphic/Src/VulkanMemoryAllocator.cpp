@@ -0,0 +1,739 @@
+#include "VulkanMemoryAllocator.h"
+#include "VulkanGPU.h"
+
+#include <stdexcept>
+#include <algorithm>
+#include <iostream>
+#include <bit>
+
+
+namespace ZE {
+
+namespace {
+
+constexpr uint32_t MemoryUsageCount = 3;
+constexpr VkDeviceSize LargeHeapSize = 1024ull * 1024 * 1024;
+constexpr VkDeviceSize LargeHeapBlockSize = 64ull * 1024 * 1024;
+
+// Without VK_EXT_memory_budget assume the rest of the system leaves us this much of every heap
+constexpr float EstimatedBudgetRatio = 0.8f;
+// Warn once usage crosses the first ratio of the budget, warn again only after falling below the second
+constexpr float BudgetWarningRatio = 0.9f;
+constexpr float BudgetRearmRatio = 0.8f;
+
+// Blocks fuller than this are not worth the copies of an evacuation
+constexpr float MaxEvacuationUsageRatio = 0.5f;
+
+VkDeviceSize AlignUp(VkDeviceSize value, VkDeviceSize alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+} // namespace
+
+
+class VulkanMemoryBlock
+{
+public:
+    VulkanMemoryBlock(VkDeviceMemory memory, VkDeviceSize size, uint32_t memoryTypeIndex, EVulkanMemoryUsage usage, bool isDedicated)
+        : memory(memory), size(size), memoryTypeIndex(memoryTypeIndex), usage(usage), isDedicated(isDedicated), mappedAddress(nullptr), allocationCount(0), usedSize(0)
+    {
+    }
+
+    virtual ~VulkanMemoryBlock() = default;
+
+    // Returns false when the block has no room left for the request
+    virtual bool TryAllocate(VkDeviceSize allocationSize, VkDeviceSize alignment, VkDeviceSize& offset, uint64_t& handle) = 0;
+    // TryAllocate would succeed, the block is left untouched
+    virtual bool CanAllocate(VkDeviceSize allocationSize, VkDeviceSize alignment) = 0;
+    virtual void Free(uint64_t handle) = 0;
+
+    bool IsEmpty()
+    {
+        return allocationCount == 0;
+    }
+
+public:
+    VkDeviceMemory memory;
+    VkDeviceSize size;
+    uint32_t memoryTypeIndex;
+    EVulkanMemoryUsage usage;
+    bool isDedicated;
+    void* mappedAddress;
+    uint32_t allocationCount;
+    VkDeviceSize usedSize;
+};
+
+// Bump allocator, the whole block is recycled when its last allocation is freed
+class LinearMemoryBlock : public VulkanMemoryBlock
+{
+public:
+    LinearMemoryBlock(VkDeviceMemory memory, VkDeviceSize size, uint32_t memoryTypeIndex, EVulkanMemoryUsage usage, bool isDedicated)
+        : VulkanMemoryBlock(memory, size, memoryTypeIndex, usage, isDedicated), _head(0)
+    {
+    }
+
+    virtual bool TryAllocate(VkDeviceSize allocationSize, VkDeviceSize alignment, VkDeviceSize& offset, uint64_t& handle) override
+    {
+        VkDeviceSize alignedOffset = AlignUp(_head, alignment);
+        if (alignedOffset + allocationSize > size)
+            return false;
+
+        _head = alignedOffset + allocationSize;
+        allocationCount++;
+
+        offset = alignedOffset;
+        handle = alignedOffset;
+        return true;
+    }
+
+    virtual bool CanAllocate(VkDeviceSize allocationSize, VkDeviceSize alignment) override
+    {
+        return AlignUp(_head, alignment) + allocationSize <= size;
+    }
+
+    virtual void Free(uint64_t handle) override
+    {
+        allocationCount--;
+        if (allocationCount == 0)
+            _head = 0;
+    }
+
+private:
+    VkDeviceSize _head;
+};
+
+// Two level segregated fit: free ranges are binned by the power of two of their size, then split
+// linearly in SecondLevelCount bins. Both levels are tracked by bitmaps so finding a free range
+// and merging neighbours on free are constant time.
+class TlsfMemoryBlock : public VulkanMemoryBlock
+{
+public:
+    TlsfMemoryBlock(VkDeviceMemory memory, VkDeviceSize size, uint32_t memoryTypeIndex, EVulkanMemoryUsage usage)
+        : VulkanMemoryBlock(memory, size, memoryTypeIndex, usage, false), _firstLevelBitmap(0), _secondLevelBitmap{}, _freeLists{}
+    {
+        _firstNode = new Node{0, size, nullptr, nullptr, nullptr, nullptr, true};
+        InsertFreeNode(_firstNode);
+    }
+
+    virtual ~TlsfMemoryBlock()
+    {
+        Node* node = _firstNode;
+        while (node != nullptr)
+        {
+            Node* next = node->nextPhysical;
+            delete node;
+            node = next;
+        }
+    }
+
+    virtual bool TryAllocate(VkDeviceSize allocationSize, VkDeviceSize alignment, VkDeviceSize& offset, uint64_t& handle) override
+    {
+        Node* node = FindFreeNode(allocationSize, alignment);
+        if (node == nullptr)
+            return false;
+
+        RemoveFreeNode(node);
+
+        // Give the alignment padding back as a free range, the previous node is never free so nothing to merge
+        VkDeviceSize alignedOffset = AlignUp(node->offset, alignment);
+        if (alignedOffset > node->offset)
+        {
+            Node* padding = new Node{node->offset, alignedOffset - node->offset, node->prevPhysical, node, nullptr, nullptr, true};
+            if (node->prevPhysical != nullptr)
+                node->prevPhysical->nextPhysical = padding;
+            else
+                _firstNode = padding;
+
+            node->prevPhysical = padding;
+            node->offset = alignedOffset;
+            node->size -= padding->size;
+            InsertFreeNode(padding);
+        }
+
+        if (node->size > allocationSize)
+        {
+            Node* remainder = new Node{node->offset + allocationSize, node->size - allocationSize, node, node->nextPhysical, nullptr, nullptr, true};
+            if (node->nextPhysical != nullptr)
+                node->nextPhysical->prevPhysical = remainder;
+
+            node->nextPhysical = remainder;
+            node->size = allocationSize;
+            InsertFreeNode(remainder);
+        }
+
+        node->isFree = false;
+        allocationCount++;
+
+        offset = node->offset;
+        handle = reinterpret_cast<uint64_t>(node);
+        return true;
+    }
+
+    virtual bool CanAllocate(VkDeviceSize allocationSize, VkDeviceSize alignment) override
+    {
+        return FindFreeNode(allocationSize, alignment) != nullptr;
+    }
+
+    virtual void Free(uint64_t handle) override
+    {
+        Node* node = reinterpret_cast<Node*>(handle);
+        node->isFree = true;
+
+        Node* prev = node->prevPhysical;
+        if (prev != nullptr && prev->isFree)
+        {
+            RemoveFreeNode(prev);
+            prev->size += node->size;
+            prev->nextPhysical = node->nextPhysical;
+            if (node->nextPhysical != nullptr)
+                node->nextPhysical->prevPhysical = prev;
+
+            delete node;
+            node = prev;
+        }
+
+        Node* next = node->nextPhysical;
+        if (next != nullptr && next->isFree)
+        {
+            RemoveFreeNode(next);
+            node->size += next->size;
+            node->nextPhysical = next->nextPhysical;
+            if (next->nextPhysical != nullptr)
+                next->nextPhysical->prevPhysical = node;
+
+            delete next;
+        }
+
+        InsertFreeNode(node);
+        allocationCount--;
+    }
+
+private:
+    struct Node
+    {
+        VkDeviceSize offset;
+        VkDeviceSize size;
+        Node* prevPhysical;
+        Node* nextPhysical;
+        Node* prevFree;
+        Node* nextFree;
+        bool isFree;
+    };
+
+    static constexpr uint32_t SecondLevelBits = 4;
+    static constexpr uint32_t SecondLevelCount = 1 << SecondLevelBits;
+    static constexpr uint32_t FirstLevelCount = 64 - SecondLevelBits + 1;
+
+    static void GetBin(VkDeviceSize size, uint32_t& firstLevel, uint32_t& secondLevel)
+    {
+        uint32_t msb = static_cast<uint32_t>(std::bit_width(size)) - 1;
+        if (msb < SecondLevelBits)
+        {
+            firstLevel = 0;
+            secondLevel = static_cast<uint32_t>(size);
+        }
+        else
+        {
+            firstLevel = msb - SecondLevelBits + 1;
+            secondLevel = static_cast<uint32_t>(size >> (msb - SecondLevelBits)) - SecondLevelCount;
+        }
+    }
+
+    Node* FindFreeNode(VkDeviceSize allocationSize, VkDeviceSize alignment)
+    {
+        // Start at the first bin whose every range is at least as large as the request
+        VkDeviceSize searchSize = allocationSize;
+        uint32_t msb = static_cast<uint32_t>(std::bit_width(searchSize)) - 1;
+        if (msb >= SecondLevelBits)
+            searchSize += (1ull << (msb - SecondLevelBits)) - 1;
+
+        uint32_t firstLevel, secondLevel;
+        GetBin(searchSize, firstLevel, secondLevel);
+        if (firstLevel >= FirstLevelCount)
+            return nullptr;
+
+        uint32_t secondLevelMap = _secondLevelBitmap[firstLevel] & (~0u << secondLevel);
+        while (true)
+        {
+            if (secondLevelMap == 0)
+            {
+                uint64_t firstLevelMap = _firstLevelBitmap & (~0ull << (firstLevel + 1));
+                if (firstLevelMap == 0)
+                    return nullptr;
+
+                firstLevel = static_cast<uint32_t>(std::countr_zero(firstLevelMap));
+                secondLevelMap = _secondLevelBitmap[firstLevel];
+            }
+
+            secondLevel = static_cast<uint32_t>(std::countr_zero(secondLevelMap));
+
+            // Ranges are large enough, only the alignment padding may not fit
+            for (Node* node = _freeLists[firstLevel][secondLevel]; node != nullptr; node = node->nextFree)
+            {
+                if (AlignUp(node->offset, alignment) + allocationSize <= node->offset + node->size)
+                    return node;
+            }
+
+            secondLevelMap &= ~(1u << secondLevel);
+        }
+    }
+
+    void InsertFreeNode(Node* node)
+    {
+        uint32_t firstLevel, secondLevel;
+        GetBin(node->size, firstLevel, secondLevel);
+
+        Node*& head = _freeLists[firstLevel][secondLevel];
+        node->prevFree = nullptr;
+        node->nextFree = head;
+        if (head != nullptr)
+            head->prevFree = node;
+        head = node;
+
+        _secondLevelBitmap[firstLevel] |= 1u << secondLevel;
+        _firstLevelBitmap |= 1ull << firstLevel;
+    }
+
+    void RemoveFreeNode(Node* node)
+    {
+        uint32_t firstLevel, secondLevel;
+        GetBin(node->size, firstLevel, secondLevel);
+
+        if (node->prevFree != nullptr)
+            node->prevFree->nextFree = node->nextFree;
+        else
+            _freeLists[firstLevel][secondLevel] = node->nextFree;
+
+        if (node->nextFree != nullptr)
+            node->nextFree->prevFree = node->prevFree;
+
+        node->prevFree = nullptr;
+        node->nextFree = nullptr;
+
+        if (_freeLists[firstLevel][secondLevel] == nullptr)
+        {
+            _secondLevelBitmap[firstLevel] &= ~(1u << secondLevel);
+            if (_secondLevelBitmap[firstLevel] == 0)
+                _firstLevelBitmap &= ~(1ull << firstLevel);
+        }
+    }
+
+private:
+    Node* _firstNode;
+
+    uint64_t _firstLevelBitmap;
+    uint32_t _secondLevelBitmap[FirstLevelCount];
+    Node* _freeLists[FirstLevelCount][SecondLevelCount];
+};
+
+
+VulkanMemoryAllocator::VulkanMemoryAllocator(VkDevice vkDevice, TPtr<VulkanGPU> GPU, bool isBudgetSupported)
+    : _vkDevice(vkDevice), _vkPhysicalDevice(GPU->GetRawGPU()), _isBudgetSupported(isBudgetSupported), _evacuatingBlock(nullptr),
+      _categoryStats{}, _allocationCount(0), _reservedSize(0), _usedSize(0)
+{
+    vkGetPhysicalDeviceMemoryProperties(_vkPhysicalDevice, &_memoryProperties);
+    _bufferImageGranularity = GPU->GetProperties().limits.bufferImageGranularity;
+
+    _blockArr.resize(_memoryProperties.memoryTypeCount * MemoryUsageCount);
+    _heapArr.resize(_memoryProperties.memoryHeapCount, HeapState{});
+
+    UpdateBudget();
+}
+
+VulkanMemoryAllocator::~VulkanMemoryAllocator()
+{
+    for (std::vector<VulkanMemoryBlock*>& blocks : _blockArr)
+    {
+        for (VulkanMemoryBlock* block : blocks)
+            DestroyBlock(block);
+    }
+    _blockArr.clear();
+
+    for (VulkanMemoryBlock* block : _dedicatedBlockArr)
+        DestroyBlock(block);
+    _dedicatedBlockArr.clear();
+}
+
+uint32_t VulkanMemoryAllocator::FindMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties)
+{
+    uint32_t typeIndex;
+    if (!TryFindMemoryType(typeFilter, properties, typeIndex))
+        throw std::runtime_error("failed to find suitable memory type!");
+
+    return typeIndex;
+}
+
+bool VulkanMemoryAllocator::TryFindMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties, uint32_t& typeIndex)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    uint32_t bestCost = UINT32_MAX;
+    for (uint32_t i = 0; i < _memoryProperties.memoryTypeCount; i++)
+    {
+        VkMemoryPropertyFlags propertyFlags = _memoryProperties.memoryTypes[i].propertyFlags;
+        if ((typeFilter & (1 << i)) == 0 || (propertyFlags & properties) != properties)
+            continue;
+
+        // Extra properties usually mean a scarcer heap, such as the host visible window of device memory
+        uint32_t cost = static_cast<uint32_t>(std::popcount(propertyFlags & ~properties));
+        if (IsHeapOverBudget(_memoryProperties.memoryTypes[i].heapIndex, 0))
+            cost += 32;
+
+        if (cost < bestCost)
+        {
+            bestCost = cost;
+            typeIndex = i;
+        }
+    }
+
+    return bestCost != UINT32_MAX;
+}
+
+VulkanMemoryAllocation VulkanMemoryAllocator::Allocate(const VkMemoryRequirements& requirements, uint32_t memoryTypeIndex, EVulkanMemoryUsage usage, EVulkanMemoryCategory category)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    VkMemoryPropertyFlags propertyFlags = _memoryProperties.memoryTypes[memoryTypeIndex].propertyFlags;
+    VkDeviceSize blockSize = GetPreferredBlockSize(memoryTypeIndex);
+
+    // Without a granularity constraint linear and optimal resources can share blocks
+    if (usage == EVulkanMemoryUsage::Optimal && _bufferImageGranularity <= 1)
+        usage = EVulkanMemoryUsage::Linear;
+
+    VulkanMemoryBlock* block = nullptr;
+    VkDeviceSize offset = 0;
+    uint64_t handle = 0;
+
+    // Lazily allocated memory is only committed when used, sharing it would defeat the point
+    bool isDedicated = requirements.size > blockSize / 2 || (propertyFlags & VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT) != 0;
+    if (isDedicated)
+    {
+        block = CreateBlock(memoryTypeIndex, requirements.size, usage, true);
+        block->TryAllocate(requirements.size, requirements.alignment, offset, handle);
+    }
+    else
+    {
+        std::vector<VulkanMemoryBlock*>& blocks = _blockArr[memoryTypeIndex * MemoryUsageCount + static_cast<uint32_t>(usage)];
+        for (VulkanMemoryBlock* candidate : blocks)
+        {
+            if (candidate != _evacuatingBlock && candidate->TryAllocate(requirements.size, requirements.alignment, offset, handle))
+            {
+                block = candidate;
+                break;
+            }
+        }
+
+        if (block == nullptr)
+        {
+            block = CreateBlock(memoryTypeIndex, blockSize, usage, false);
+            if (!block->TryAllocate(requirements.size, requirements.alignment, offset, handle))
+                throw std::runtime_error("failed to sub-allocate device memory!");
+        }
+    }
+
+    _allocationCount++;
+    _usedSize += requirements.size;
+    block->usedSize += requirements.size;
+    _heapArr[_memoryProperties.memoryTypes[memoryTypeIndex].heapIndex].usedSize += requirements.size;
+    _categoryStats[static_cast<size_t>(category)].allocationCount++;
+    _categoryStats[static_cast<size_t>(category)].usedSize += requirements.size;
+
+    VulkanMemoryAllocation allocation{};
+    allocation.memory = block->memory;
+    allocation.offset = offset;
+    allocation.size = requirements.size;
+    allocation.memoryTypeIndex = memoryTypeIndex;
+    allocation.category = category;
+    allocation.mappedAddress = block->mappedAddress != nullptr ? static_cast<uint8_t*>(block->mappedAddress) + offset : nullptr;
+    allocation.block = block;
+    allocation.handle = handle;
+
+    return allocation;
+}
+
+void VulkanMemoryAllocator::Free(VulkanMemoryAllocation& allocation)
+{
+    if (allocation.block == nullptr)
+        return;
+
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    VulkanMemoryBlock* block = allocation.block;
+    block->Free(allocation.handle);
+
+    _allocationCount--;
+    _usedSize -= allocation.size;
+    block->usedSize -= allocation.size;
+    _heapArr[_memoryProperties.memoryTypes[allocation.memoryTypeIndex].heapIndex].usedSize -= allocation.size;
+    _categoryStats[static_cast<size_t>(allocation.category)].allocationCount--;
+    _categoryStats[static_cast<size_t>(allocation.category)].usedSize -= allocation.size;
+
+    if (block->isDedicated)
+    {
+        _dedicatedBlockArr.erase(std::find(_dedicatedBlockArr.begin(), _dedicatedBlockArr.end(), block));
+        DestroyBlock(block);
+    }
+    else if (block->IsEmpty())
+    {
+        // Keep one empty block per pool so that usage hovering around a block boundary doesn't thrash
+        std::vector<VulkanMemoryBlock*>& blocks = _blockArr[block->memoryTypeIndex * MemoryUsageCount + static_cast<uint32_t>(block->usage)];
+        size_t emptyCount = std::count_if(blocks.begin(), blocks.end(), [](VulkanMemoryBlock* candidate) { return candidate->IsEmpty(); });
+        if (emptyCount > 1)
+        {
+            blocks.erase(std::find(blocks.begin(), blocks.end(), block));
+            DestroyBlock(block);
+        }
+    }
+
+    allocation = VulkanMemoryAllocation{};
+}
+
+void VulkanMemoryAllocator::UpdateBudget()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    if (_isBudgetSupported)
+    {
+        VkPhysicalDeviceMemoryBudgetPropertiesEXT budgetProperties{};
+        budgetProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_BUDGET_PROPERTIES_EXT;
+
+        VkPhysicalDeviceMemoryProperties2 memoryProperties{};
+        memoryProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PROPERTIES_2;
+        memoryProperties.pNext = &budgetProperties;
+        vkGetPhysicalDeviceMemoryProperties2(_vkPhysicalDevice, &memoryProperties);
+
+        for (uint32_t i = 0; i < _heapArr.size(); i++)
+        {
+            _heapArr[i].budget = budgetProperties.heapBudget[i];
+            _heapArr[i].driverUsage = budgetProperties.heapUsage[i];
+            _heapArr[i].reservedSizeAtUpdate = _heapArr[i].reservedSize;
+        }
+    }
+    else
+    {
+        for (uint32_t i = 0; i < _heapArr.size(); i++)
+        {
+            _heapArr[i].budget = static_cast<VkDeviceSize>(_memoryProperties.memoryHeaps[i].size * EstimatedBudgetRatio);
+            _heapArr[i].driverUsage = 0;
+            _heapArr[i].reservedSizeAtUpdate = 0;
+        }
+    }
+
+    for (uint32_t i = 0; i < _heapArr.size(); i++)
+        CheckBudget(i);
+}
+
+bool VulkanMemoryAllocator::IsEvacuationCandidate(VulkanMemoryBlock* block, float& usageRatio)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    if (block == nullptr || block->isDedicated || block->usage == EVulkanMemoryUsage::Transient)
+        return false;
+
+    usageRatio = static_cast<float>(block->usedSize) / static_cast<float>(block->size);
+    if (usageRatio > MaxEvacuationUsageRatio)
+        return false;
+
+    VkDeviceSize freeSize = 0;
+    std::vector<VulkanMemoryBlock*>& blocks = _blockArr[block->memoryTypeIndex * MemoryUsageCount + static_cast<uint32_t>(block->usage)];
+    for (VulkanMemoryBlock* other : blocks)
+    {
+        if (other != block)
+            freeSize += other->size - other->usedSize;
+    }
+
+    return freeSize >= block->usedSize;
+}
+
+bool VulkanMemoryAllocator::CanAllocateFromExistingBlock(const VkMemoryRequirements& requirements, uint32_t memoryTypeIndex, EVulkanMemoryUsage usage)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    // Same choices as Allocate, a dedicated allocation always creates its block
+    if (usage == EVulkanMemoryUsage::Optimal && _bufferImageGranularity <= 1)
+        usage = EVulkanMemoryUsage::Linear;
+
+    VkMemoryPropertyFlags propertyFlags = _memoryProperties.memoryTypes[memoryTypeIndex].propertyFlags;
+    if (requirements.size > GetPreferredBlockSize(memoryTypeIndex) / 2 || (propertyFlags & VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT) != 0)
+        return false;
+
+    std::vector<VulkanMemoryBlock*>& blocks = _blockArr[memoryTypeIndex * MemoryUsageCount + static_cast<uint32_t>(usage)];
+    return std::any_of(blocks.begin(), blocks.end(), [this, &requirements](VulkanMemoryBlock* candidate) {
+        return candidate != _evacuatingBlock && candidate->CanAllocate(requirements.size, requirements.alignment);
+    });
+}
+
+void VulkanMemoryAllocator::BeginEvacuation(VulkanMemoryBlock* block)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _evacuatingBlock = block;
+}
+
+void VulkanMemoryAllocator::EndEvacuation()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _evacuatingBlock = nullptr;
+}
+
+VulkanMemoryStats VulkanMemoryAllocator::GetStats()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    VulkanMemoryStats stats{};
+    for (std::vector<VulkanMemoryBlock*>& blocks : _blockArr)
+        stats.blockCount += static_cast<uint32_t>(blocks.size());
+
+    stats.dedicatedCount = static_cast<uint32_t>(_dedicatedBlockArr.size());
+    stats.allocationCount = _allocationCount;
+    stats.reservedSize = _reservedSize;
+    stats.usedSize = _usedSize;
+
+    return stats;
+}
+
+VulkanMemoryCategoryStats VulkanMemoryAllocator::GetCategoryStats(EVulkanMemoryCategory category)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _categoryStats[static_cast<size_t>(category)];
+}
+
+uint32_t VulkanMemoryAllocator::GetHeapCount()
+{
+    return static_cast<uint32_t>(_heapArr.size());
+}
+
+VulkanMemoryHeapStats VulkanMemoryAllocator::GetHeapStats(uint32_t heapIndex)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    VulkanMemoryHeapStats stats{};
+    stats.size = _memoryProperties.memoryHeaps[heapIndex].size;
+    stats.reservedSize = _heapArr[heapIndex].reservedSize;
+    stats.usedSize = _heapArr[heapIndex].usedSize;
+    stats.budget = _heapArr[heapIndex].budget;
+    stats.usage = GetHeapUsage(heapIndex);
+
+    return stats;
+}
+
+const char* VulkanMemoryAllocator::GetCategoryName(EVulkanMemoryCategory category)
+{
+    switch (category)
+    {
+    case EVulkanMemoryCategory::Mesh:
+        return "mesh";
+    case EVulkanMemoryCategory::Texture:
+        return "texture";
+    case EVulkanMemoryCategory::Staging:
+        return "staging";
+    case EVulkanMemoryCategory::RenderTarget:
+        return "render target";
+    case EVulkanMemoryCategory::Uniform:
+        return "uniform";
+    default:
+        return "other";
+    }
+}
+
+VkDeviceSize VulkanMemoryAllocator::GetPreferredBlockSize(uint32_t memoryTypeIndex)
+{
+    VkDeviceSize heapSize = _memoryProperties.memoryHeaps[_memoryProperties.memoryTypes[memoryTypeIndex].heapIndex].size;
+    if (heapSize > LargeHeapSize)
+        return LargeHeapBlockSize;
+
+    // Small heaps such as the host visible device local window can't afford 64MB blocks
+    return AlignUp(heapSize / 8, 32);
+}
+
+VulkanMemoryBlock* VulkanMemoryAllocator::CreateBlock(uint32_t memoryTypeIndex, VkDeviceSize size, EVulkanMemoryUsage usage, bool isDedicated)
+{
+    VkMemoryAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    allocInfo.allocationSize = size;
+    allocInfo.memoryTypeIndex = memoryTypeIndex;
+
+    VkDeviceMemory memory;
+    if (vkAllocateMemory(_vkDevice, &allocInfo, nullptr, &memory) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to allocate device memory!");
+    }
+
+    VulkanMemoryBlock* block;
+    if (isDedicated || usage == EVulkanMemoryUsage::Transient)
+        block = new LinearMemoryBlock(memory, size, memoryTypeIndex, usage, isDedicated);
+    else
+        block = new TlsfMemoryBlock(memory, size, memoryTypeIndex, usage);
+
+    if (_memoryProperties.memoryTypes[memoryTypeIndex].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)
+    {
+        if (vkMapMemory(_vkDevice, memory, 0, VK_WHOLE_SIZE, 0, &block->mappedAddress) != VK_SUCCESS)
+        {
+            vkFreeMemory(_vkDevice, memory, nullptr);
+            delete block;
+            throw std::runtime_error("failed to map device memory!");
+        }
+    }
+
+    if (isDedicated)
+        _dedicatedBlockArr.push_back(block);
+    else
+        _blockArr[memoryTypeIndex * MemoryUsageCount + static_cast<uint32_t>(usage)].push_back(block);
+
+    uint32_t heapIndex = _memoryProperties.memoryTypes[memoryTypeIndex].heapIndex;
+    _heapArr[heapIndex].reservedSize += size;
+    _reservedSize += size;
+    CheckBudget(heapIndex);
+
+    return block;
+}
+
+void VulkanMemoryAllocator::DestroyBlock(VulkanMemoryBlock* block)
+{
+    if (block->mappedAddress != nullptr)
+        vkUnmapMemory(_vkDevice, block->memory);
+
+    vkFreeMemory(_vkDevice, block->memory, nullptr);
+
+    uint32_t heapIndex = _memoryProperties.memoryTypes[block->memoryTypeIndex].heapIndex;
+    _heapArr[heapIndex].reservedSize -= block->size;
+    _reservedSize -= block->size;
+    CheckBudget(heapIndex);
+
+    if (block == _evacuatingBlock)
+        _evacuatingBlock = nullptr;
+
+    delete block;
+}
+
+VkDeviceSize VulkanMemoryAllocator::GetHeapUsage(uint32_t heapIndex)
+{
+    HeapState& heap = _heapArr[heapIndex];
+    if (heap.reservedSize >= heap.reservedSizeAtUpdate)
+        return heap.driverUsage + (heap.reservedSize - heap.reservedSizeAtUpdate);
+
+    return heap.driverUsage - std::min(heap.driverUsage, heap.reservedSizeAtUpdate - heap.reservedSize);
+}
+
+bool VulkanMemoryAllocator::IsHeapOverBudget(uint32_t heapIndex, VkDeviceSize size)
+{
+    return GetHeapUsage(heapIndex) + size > _heapArr[heapIndex].budget;
+}
+
+void VulkanMemoryAllocator::CheckBudget(uint32_t heapIndex)
+{
+    HeapState& heap = _heapArr[heapIndex];
+    VkDeviceSize usage = GetHeapUsage(heapIndex);
+
+    if (!heap.isWarned && usage > heap.budget * BudgetWarningRatio)
+    {
+        heap.isWarned = true;
+        std::cerr << "warning: memory heap " << heapIndex << " is using " << (usage >> 20) << " of its " << (heap.budget >> 20) << " MB budget" << std::endl;
+    }
+    else if (heap.isWarned && usage < heap.budget * BudgetRearmRatio)
+    {
+        heap.isWarned = false;
+    }
+}
+
+} // namespace ZE
\ No newline at end of file
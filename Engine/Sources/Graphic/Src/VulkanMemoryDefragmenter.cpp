@@ -0,0 +1,180 @@
+#include "VulkanMemoryDefragmenter.h"
+#include "VulkanMemoryAllocator.h"
+#include "VulkanDevice.h"
+#include "VulkanQueue.h"
+#include "VulkanBuffer.h"
+#include "VulkanCommandPool.h"
+#include "VulkanCommandBuffer.h"
+#include "VulkanDeletionQueue.h"
+
+#include <algorithm>
+
+
+namespace ZE {
+
+// Ticks to wait before searching again when nothing could be moved
+const uint64_t DefragmentationRetryInterval = 600;
+
+VulkanMemoryDefragmenter::VulkanMemoryDefragmenter(TPtr<VulkanDevice> device, TPtr<VulkanQueue> queue, VkDeviceSize maxMoveSizePerTick)
+    : _device(device), _queue(queue), _maxMoveSizePerTick(maxMoveSizePerTick), _isEvacuating(false), _commitFrameValue(0),
+      _tickCount(0), _nextSearchTick(0), _moveCount(0), _movedSize(0)
+{
+    _commandPool = std::make_shared<VulkanCommandPool>(device, queue->GetFamilyIndex(), VK_COMMAND_POOL_CREATE_TRANSIENT_BIT);
+    _commandBuffer = std::make_shared<VulkanCommandBuffer>(_commandPool);
+    _fence = device->CreateFence(true);
+}
+
+VulkanMemoryDefragmenter::~VulkanMemoryDefragmenter()
+{
+    vkWaitForFences(_device->GetRawDevice(), 1, &_fence, VK_TRUE, UINT64_MAX);
+
+    _pendingMoveArr.clear();
+
+    if (_isEvacuating)
+        _device->GetMemoryAllocator()->EndEvacuation();
+
+    _commandBuffer.reset();
+    _commandPool.reset();
+    _device->DestroyFence(_fence);
+}
+
+void VulkanMemoryDefragmenter::Register(TPtr<VulkanBuffer> buffer)
+{
+    _bufferArr.push_back(buffer);
+}
+
+void VulkanMemoryDefragmenter::Tick()
+{
+    _tickCount++;
+
+    if (!_pendingMoveArr.empty())
+    {
+        if (vkGetFenceStatus(_device->GetRawDevice(), _fence) != VK_SUCCESS)
+            return;
+
+        CommitMoves();
+    }
+
+    // Start over only once the evacuated memory is actually released
+    TPtr<VulkanDeletionQueue> deletionQueue = _device->GetDeletionQueue();
+    if (_isEvacuating && deletionQueue != nullptr && !deletionQueue->IsReleased(_commitFrameValue))
+        return;
+
+    if (_isEvacuating)
+    {
+        _device->GetMemoryAllocator()->EndEvacuation();
+        _isEvacuating = false;
+    }
+
+    if (_tickCount >= _nextSearchTick)
+        BeginMoves();
+}
+
+void VulkanMemoryDefragmenter::CommitMoves()
+{
+    // Frames recorded before this point may still read the old storage, dropping it defers its destruction
+    TPtr<VulkanDeletionQueue> deletionQueue = _device->GetDeletionQueue();
+    if (deletionQueue != nullptr)
+        _commitFrameValue = deletionQueue->GetFrameValue();
+
+    for (Move& move : _pendingMoveArr)
+    {
+        move.buffer->SwapStorage(*move.destination);
+
+        _moveCount++;
+        _movedSize += move.buffer->GetSize();
+    }
+
+    _pendingMoveArr.clear();
+}
+
+void VulkanMemoryDefragmenter::BeginMoves()
+{
+    TPtr<VulkanMemoryAllocator> memoryAllocator = _device->GetMemoryAllocator();
+
+    std::erase_if(_bufferArr, [](const TWeakPtr<VulkanBuffer>& weakBuffer) { return weakBuffer.expired(); });
+
+    // The sparsest block holding a movable buffer
+    VulkanMemoryBlock* candidate = nullptr;
+    float candidateUsageRatio = 1.0f;
+    for (TWeakPtr<VulkanBuffer>& weakBuffer : _bufferArr)
+    {
+        // Buffers may be released from other threads at any point
+        TPtr<VulkanBuffer> buffer = weakBuffer.lock();
+        if (buffer == nullptr)
+            continue;
+
+        VulkanMemoryBlock* block = buffer->GetAllocation().block;
+
+        float usageRatio;
+        if (block != candidate && memoryAllocator->IsEvacuationCandidate(block, usageRatio) && usageRatio < candidateUsageRatio)
+        {
+            candidate = block;
+            candidateUsageRatio = usageRatio;
+        }
+    }
+
+    if (candidate == nullptr)
+    {
+        _nextSearchTick = _tickCount + DefragmentationRetryInterval;
+        return;
+    }
+
+    memoryAllocator->BeginEvacuation(candidate);
+    _isEvacuating = true;
+
+    VkDeviceSize moveSize = 0;
+    for (TWeakPtr<VulkanBuffer>& weakBuffer : _bufferArr)
+    {
+        TPtr<VulkanBuffer> buffer = weakBuffer.lock();
+        if (buffer == nullptr || buffer->GetAllocation().block != candidate)
+            continue;
+
+        if (moveSize > 0 && moveSize + buffer->GetSize() > _maxMoveSizePerTick)
+            break;
+
+        // A fresh block would be the sparsest of all and stay allocated once the move is abandoned
+        VkMemoryRequirements requirements;
+        vkGetBufferMemoryRequirements(_device->GetRawDevice(), buffer->GetRawBuffer(), &requirements);
+        if (!memoryAllocator->CanAllocateFromExistingBlock(requirements, buffer->GetAllocation().memoryTypeIndex, EVulkanMemoryUsage::Linear))
+            break;
+
+        EVulkanMemoryCategory category = buffer->GetAllocation().category;
+        TPtr<VulkanBuffer> destination = std::make_shared<VulkanBuffer>(_device, buffer->GetSize(), buffer->GetUsage(), buffer->GetMemoryProperties(), category);
+
+        // Landing in a block at least as sparse would only move the problem around
+        float destinationUsageRatio;
+        if (memoryAllocator->IsEvacuationCandidate(destination->GetAllocation().block, destinationUsageRatio) && destinationUsageRatio <= candidateUsageRatio)
+            break;
+
+        _pendingMoveArr.push_back({buffer, destination});
+        moveSize += buffer->GetSize();
+    }
+
+    if (_pendingMoveArr.empty())
+    {
+        _nextSearchTick = _tickCount + DefragmentationRetryInterval;
+        return;
+    }
+
+    _commandPool->Reset();
+    _commandBuffer->Begin();
+    for (Move& move : _pendingMoveArr)
+        move.destination->CopyFromBuffer(_commandBuffer, move.buffer, move.buffer->GetSize());
+    _commandBuffer->End();
+
+    vkResetFences(_device->GetRawDevice(), 1, &_fence);
+    _queue->Submit(_commandBuffer, {}, {}, {}, _fence);
+}
+
+uint32_t VulkanMemoryDefragmenter::GetMoveCount()
+{
+    return _moveCount;
+}
+
+VkDeviceSize VulkanMemoryDefragmenter::GetMovedSize()
+{
+    return _movedSize;
+}
+
+} // namespace ZE
\ No newline at end of file
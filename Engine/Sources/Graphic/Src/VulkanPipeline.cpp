@@ -12,7 +12,7 @@ namespace ZE {
 
 
 VulkanGraphicPipeline::VulkanGraphicPipeline(
-    TPtr<VulkanDevice> device, const RHIPipelineState& state, TPtr<VulkanRenderPass> renderPass)
+    TPtr<VulkanDevice> device, const RHIPipelineState& state, TPtr<VulkanRenderPass> renderPass, VkPipelineCache pipelineCache)
     : _device(device),  _renderPass(renderPass), _vkPipeline(VK_NULL_HANDLE)
 {
     VkPipelineViewportStateCreateInfo viewportState{};
@@ -56,7 +56,7 @@ VulkanGraphicPipeline::VulkanGraphicPipeline(
     pipelineInfo.basePipelineHandle = VK_NULL_HANDLE; // Optional
     pipelineInfo.basePipelineIndex = -1;              // Optional
 
-    if (vkCreateGraphicsPipelines(_device->GetRawDevice(), VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &_vkPipeline) !=
+    if (vkCreateGraphicsPipelines(_device->GetRawDevice(), pipelineCache, 1, &pipelineInfo, nullptr, &_vkPipeline) !=
         VK_SUCCESS)
     {
         throw std::runtime_error("failed to create graphics pipeline!");
@@ -65,7 +65,9 @@ VulkanGraphicPipeline::VulkanGraphicPipeline(
 
 VulkanGraphicPipeline::~VulkanGraphicPipeline()
 {
-    vkDestroyPipeline(_device->GetRawDevice(), _vkPipeline, nullptr);
+    _device->DeferDestruction([device = _device, vkPipeline = _vkPipeline]() {
+        vkDestroyPipeline(device->GetRawDevice(), vkPipeline, nullptr);
+    });
 }
 
 VkPipeline VulkanGraphicPipeline::GetRawPipeline()
@@ -73,4 +75,43 @@ VkPipeline VulkanGraphicPipeline::GetRawPipeline()
     return _vkPipeline;
 }
 
+VulkanComputePipeline::VulkanComputePipeline(TPtr<VulkanDevice> device, TPtr<VulkanShader> shader, TPtr<VulkanPipelineLayout> layout, VkPipelineCache pipelineCache)
+    : _device(device), _shader(shader), _layout(layout), _vkPipeline(VK_NULL_HANDLE)
+{
+    VkPipelineShaderStageCreateInfo shaderStage{};
+    shaderStage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    shaderStage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+    shaderStage.module = shader->GetRawShader();
+    shaderStage.pName = "main";
+
+    VkComputePipelineCreateInfo pipelineInfo{};
+    pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+    pipelineInfo.stage = shaderStage;
+    pipelineInfo.layout = layout->GetRawPipelineLayout();
+    pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
+    pipelineInfo.basePipelineIndex = -1;
+
+    if (vkCreateComputePipelines(_device->GetRawDevice(), pipelineCache, 1, &pipelineInfo, nullptr, &_vkPipeline) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to create compute pipeline!");
+    }
+}
+
+VulkanComputePipeline::~VulkanComputePipeline()
+{
+    _device->DeferDestruction([device = _device, vkPipeline = _vkPipeline]() {
+        vkDestroyPipeline(device->GetRawDevice(), vkPipeline, nullptr);
+    });
+}
+
+VkPipeline VulkanComputePipeline::GetRawPipeline()
+{
+    return _vkPipeline;
+}
+
+TPtr<VulkanPipelineLayout> VulkanComputePipeline::GetLayout()
+{
+    return _layout;
+}
+
 } // namespace ZE
\ No newline at end of file
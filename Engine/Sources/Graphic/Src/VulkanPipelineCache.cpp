@@ -0,0 +1,121 @@
+#include "VulkanPipelineCache.h"
+#include "VulkanGPU.h"
+#include "VulkanDevice.h"
+
+#include <fstream>
+#include <cstring>
+#include <stdexcept>
+
+
+namespace ZE {
+
+VulkanPipelineCache::VulkanPipelineCache(TPtr<VulkanDevice> device, const std::filesystem::path& path)
+    : _device(device), _path(path), _savedSize(0), _isLoadedFromDisk(false), _vkPipelineCache(VK_NULL_HANDLE)
+{
+    std::vector<char> data;
+
+    std::ifstream file(_path, std::ios::ate | std::ios::binary);
+    if (file.is_open())
+    {
+        data.resize(static_cast<size_t>(file.tellg()));
+        file.seekg(0);
+        file.read(data.data(), data.size());
+
+        if (!file || !IsCompatible(data))
+            data.clear();
+    }
+
+    VkPipelineCacheCreateInfo cacheInfo{};
+    cacheInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+    cacheInfo.initialDataSize = data.size();
+    cacheInfo.pInitialData = data.empty() ? nullptr : data.data();
+
+    if (vkCreatePipelineCache(_device->GetRawDevice(), &cacheInfo, nullptr, &_vkPipelineCache) != VK_SUCCESS)
+    {
+        // The driver may still refuse data it wrote itself, start empty rather than fail
+        cacheInfo.initialDataSize = 0;
+        cacheInfo.pInitialData = nullptr;
+        data.clear();
+
+        if (vkCreatePipelineCache(_device->GetRawDevice(), &cacheInfo, nullptr, &_vkPipelineCache) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to create pipeline cache!");
+        }
+    }
+
+    _isLoadedFromDisk = !data.empty();
+    _savedSize = data.size();
+}
+
+VulkanPipelineCache::~VulkanPipelineCache()
+{
+    if (_vkPipelineCache != VK_NULL_HANDLE)
+        vkDestroyPipelineCache(_device->GetRawDevice(), _vkPipelineCache, nullptr);
+}
+
+bool VulkanPipelineCache::IsCompatible(const std::vector<char>& data)
+{
+    VkPipelineCacheHeaderVersionOne header;
+    if (data.size() < sizeof(header))
+        return false;
+
+    memcpy(&header, data.data(), sizeof(header));
+
+    VkPhysicalDeviceProperties properties = _device->GetGPU()->GetProperties();
+
+    return header.headerSize >= sizeof(header) &&
+           header.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+           header.vendorID == properties.vendorID &&
+           header.deviceID == properties.deviceID &&
+           memcmp(header.pipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+}
+
+bool VulkanPipelineCache::Save()
+{
+    VkDevice vkDevice = _device->GetRawDevice();
+
+    size_t size = 0;
+    if (vkGetPipelineCacheData(vkDevice, _vkPipelineCache, &size, nullptr) != VK_SUCCESS || size == 0)
+        return false;
+
+    if (size == _savedSize)
+        return true;
+
+    std::vector<char> data(size);
+    if (vkGetPipelineCacheData(vkDevice, _vkPipelineCache, &size, data.data()) != VK_SUCCESS)
+        return false;
+
+    // Write next to the target and swap it in, a crash mid-write never leaves a truncated cache behind
+    std::filesystem::path tempPath = _path;
+    tempPath += ".tmp";
+
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open())
+            return false;
+
+        file.write(data.data(), size);
+        if (!file)
+            return false;
+    }
+
+    std::error_code error;
+    std::filesystem::rename(tempPath, _path, error);
+    if (error)
+        return false;
+
+    _savedSize = size;
+    return true;
+}
+
+bool VulkanPipelineCache::IsLoadedFromDisk()
+{
+    return _isLoadedFromDisk;
+}
+
+VkPipelineCache VulkanPipelineCache::GetRawPipelineCache()
+{
+    return _vkPipelineCache;
+}
+
+} // namespace ZE
\ No newline at end of file
@@ -1,6 +1,7 @@
 #include "VulkanPipelineLayout.h"
 #include "VulkanDescriptorSetLayout.h"
 #include "VulkanDevice.h"
+#include "CoreHash.h"
 
 #include <algorithm>
 #include <iterator>
@@ -9,9 +10,18 @@
 
 namespace ZE {
 
-VulkanPipelineLayout::VulkanPipelineLayout(TPtr<VulkanDevice> device, TPtrArr<VulkanDescriptorSetLayout>& descriptorSetLayoutArr)
-    : _device(device), _descriptorSetLayoutArr(descriptorSetLayoutArr), _vkPipelineLayout(VK_NULL_HANDLE)
+VulkanPipelineLayout::VulkanPipelineLayout(TPtr<VulkanDevice> device, TPtrArr<VulkanDescriptorSetLayout>& descriptorSetLayoutArr, const std::vector<VkPushConstantRange>& pushConstantRangeArr)
+    : _device(device), _descriptorSetLayoutArr(descriptorSetLayoutArr), _vkPipelineLayout(VK_NULL_HANDLE), _layoutHash(0)
 {
+    HashWriter writer;
+    writer.Write(static_cast<uint32_t>(descriptorSetLayoutArr.size()));
+    for (TPtr<VulkanDescriptorSetLayout>& layout : descriptorSetLayoutArr)
+        writer.Write(layout->GetLayoutHash());
+    writer.Write(static_cast<uint32_t>(pushConstantRangeArr.size()));
+    for (const VkPushConstantRange& range : pushConstantRangeArr)
+        writer.Write(range.stageFlags).Write(range.offset).Write(range.size);
+    _layoutHash = writer.GetHash();
+
     std::vector<VkDescriptorSetLayout> layoutArr{};
     std::transform(
         descriptorSetLayoutArr.begin(), descriptorSetLayoutArr.end(), std::back_inserter(layoutArr), [](TPtr<VulkanDescriptorSetLayout>& layout) {
@@ -23,7 +33,8 @@ VulkanPipelineLayout::VulkanPipelineLayout(TPtr<VulkanDevice> device, TPtrArr<Vu
     pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
     pipelineLayoutInfo.setLayoutCount = layoutArr.size();
     pipelineLayoutInfo.pSetLayouts = layoutArr.data();
-    pipelineLayoutInfo.pushConstantRangeCount = 0;
+    pipelineLayoutInfo.pushConstantRangeCount = static_cast<uint32_t>(pushConstantRangeArr.size());
+    pipelineLayoutInfo.pPushConstantRanges = pushConstantRangeArr.data();
 
     if (vkCreatePipelineLayout(_device->GetRawDevice(), &pipelineLayoutInfo, nullptr, &_vkPipelineLayout) != VK_SUCCESS)
     {
@@ -36,6 +47,11 @@ VulkanPipelineLayout::~VulkanPipelineLayout()
     vkDestroyPipelineLayout(_device->GetRawDevice(), _vkPipelineLayout, nullptr);
 }
 
+uint64_t VulkanPipelineLayout::GetLayoutHash()
+{
+    return _layoutHash;
+}
+
 VkPipelineLayout VulkanPipelineLayout::GetRawPipelineLayout()
 {
     return _vkPipelineLayout;
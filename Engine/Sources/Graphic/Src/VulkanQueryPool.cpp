@@ -0,0 +1,66 @@
+#include "VulkanQueryPool.h"
+#include "VulkanDevice.h"
+#include "VulkanCommandBuffer.h"
+
+#include <stdexcept>
+
+
+namespace ZE {
+
+VulkanQueryPool::VulkanQueryPool(TPtr<VulkanDevice> device, VkQueryType queryType, uint32_t queryCount)
+    : _device(device), _queryType(queryType), _queryCount(queryCount), _vkQueryPool(VK_NULL_HANDLE)
+{
+    VkQueryPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+    poolInfo.queryType = queryType;
+    poolInfo.queryCount = queryCount;
+
+    if (vkCreateQueryPool(_device->GetRawDevice(), &poolInfo, nullptr, &_vkQueryPool) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to create query pool!");
+    }
+}
+
+VulkanQueryPool::~VulkanQueryPool()
+{
+    if (_vkQueryPool != VK_NULL_HANDLE)
+        vkDestroyQueryPool(_device->GetRawDevice(), _vkQueryPool, nullptr);
+}
+
+void VulkanQueryPool::Reset(TPtr<VulkanCommandBuffer> commandBuffer, uint32_t firstQuery, uint32_t queryCount)
+{
+    vkCmdResetQueryPool(commandBuffer->GetRawCommandBuffer(), _vkQueryPool, firstQuery, queryCount);
+}
+
+void VulkanQueryPool::WriteTimestamp(TPtr<VulkanCommandBuffer> commandBuffer, VkPipelineStageFlagBits stage, uint32_t query)
+{
+    vkCmdWriteTimestamp(commandBuffer->GetRawCommandBuffer(), stage, _vkQueryPool, query);
+}
+
+bool VulkanQueryPool::GetResults(uint32_t firstQuery, uint32_t queryCount, std::vector<uint64_t>& results)
+{
+    results.resize(queryCount);
+    if (queryCount == 0)
+        return true;
+
+    VkResult result = vkGetQueryPoolResults(_device->GetRawDevice(), _vkQueryPool, firstQuery, queryCount, results.size() * sizeof(uint64_t), results.data(), sizeof(uint64_t), VK_QUERY_RESULT_64_BIT);
+
+    return result == VK_SUCCESS;
+}
+
+uint32_t VulkanQueryPool::GetQueryCount()
+{
+    return _queryCount;
+}
+
+VkQueryPool VulkanQueryPool::GetRawQueryPool()
+{
+    return _vkQueryPool;
+}
+
+TPtr<VulkanDevice> VulkanQueryPool::GetDevice()
+{
+    return _device;
+}
+
+} // namespace ZE
\ No newline at end of file
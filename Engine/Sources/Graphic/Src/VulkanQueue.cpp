@@ -20,26 +20,151 @@ VulkanQueue::~VulkanQueue()
 
 void VulkanQueue::Submit(TPtr<VulkanCommandBuffer> commandBuffer, const std::vector<VkSemaphore>& waitSemaphoreArr, const std::vector<VkPipelineStageFlags>& waitStageArr, const std ::vector<VkSemaphore>& signalSemaphoreArr, VkFence fence)
 {
-    VkPipelineStageFlags waitStages[] = {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT};
-    VkCommandBuffer vkCommandBuffer = commandBuffer->GetRawCommandBuffer();
-
-    VkSubmitInfo submitInfo{};
-    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-    submitInfo.waitSemaphoreCount = waitSemaphoreArr.size();
-    submitInfo.pWaitSemaphores = waitSemaphoreArr.data();
-    submitInfo.pWaitDstStageMask = waitStageArr.data();
-    submitInfo.commandBufferCount = 1;
-    submitInfo.pCommandBuffers = &vkCommandBuffer;
-    submitInfo.signalSemaphoreCount = signalSemaphoreArr.size();
-    submitInfo.pSignalSemaphores = signalSemaphoreArr.data();
-
-    if (vkQueueSubmit(_vkQueue, 1, &submitInfo, fence) != VK_SUCCESS)
+    VulkanSubmitBatch batch;
+    batch.commandBufferArr.push_back(commandBuffer);
+
+    for (size_t i = 0; i < waitSemaphoreArr.size(); i++)
+        batch.waitArr.push_back({waitSemaphoreArr[i], 0, waitStageArr[i]});
+    for (VkSemaphore semaphore : signalSemaphoreArr)
+        batch.signalArr.push_back({semaphore, 0, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT});
+
+    Submit({batch}, fence);
+}
+
+void VulkanQueue::Submit(const std::vector<VulkanSubmitBatch>& batchArr, VkFence fence)
+{
+    if (_device->IsSynchronization2Supported())
+        SubmitSynchronization2(batchArr, fence);
+    else
+        SubmitLegacy(batchArr, fence);
+}
+
+VkSemaphoreSubmitInfo GetSemaphoreSubmitInfo(const VulkanSemaphoreSubmit& semaphoreSubmit)
+{
+    VkSemaphoreSubmitInfo semaphoreInfo{};
+    semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO;
+    semaphoreInfo.semaphore = semaphoreSubmit.semaphore;
+    semaphoreInfo.value = semaphoreSubmit.value;
+    semaphoreInfo.stageMask = semaphoreSubmit.stageMask;
+
+    return semaphoreInfo;
+}
+
+void VulkanQueue::SubmitSynchronization2(const std::vector<VulkanSubmitBatch>& batchArr, VkFence fence)
+{
+    size_t semaphoreCount = 0;
+    size_t commandBufferCount = 0;
+    for (const VulkanSubmitBatch& batch : batchArr)
     {
-       // throw std::runtime_error("failed to submit draw command buffer!");
+        semaphoreCount += batch.waitArr.size() + batch.signalArr.size();
+        commandBufferCount += batch.commandBufferArr.size();
+    }
+
+    // Reserved up front, the submit infos point into these arrays
+    std::vector<VkSemaphoreSubmitInfo> semaphoreInfoArr;
+    semaphoreInfoArr.reserve(semaphoreCount);
+    std::vector<VkCommandBufferSubmitInfo> commandBufferInfoArr;
+    commandBufferInfoArr.reserve(commandBufferCount);
+
+    std::vector<VkSubmitInfo2> submitInfoArr;
+    submitInfoArr.reserve(batchArr.size());
+    for (const VulkanSubmitBatch& batch : batchArr)
+    {
+        VkSubmitInfo2 submitInfo{};
+        submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO_2;
+
+        submitInfo.waitSemaphoreInfoCount = static_cast<uint32_t>(batch.waitArr.size());
+        submitInfo.pWaitSemaphoreInfos = semaphoreInfoArr.data() + semaphoreInfoArr.size();
+        for (const VulkanSemaphoreSubmit& wait : batch.waitArr)
+            semaphoreInfoArr.push_back(GetSemaphoreSubmitInfo(wait));
+
+        submitInfo.commandBufferInfoCount = static_cast<uint32_t>(batch.commandBufferArr.size());
+        submitInfo.pCommandBufferInfos = commandBufferInfoArr.data() + commandBufferInfoArr.size();
+        for (TPtr<VulkanCommandBuffer> commandBuffer : batch.commandBufferArr)
+        {
+            VkCommandBufferSubmitInfo commandBufferInfo{};
+            commandBufferInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO;
+            commandBufferInfo.commandBuffer = commandBuffer->GetRawCommandBuffer();
+            commandBufferInfoArr.push_back(commandBufferInfo);
+        }
+
+        submitInfo.signalSemaphoreInfoCount = static_cast<uint32_t>(batch.signalArr.size());
+        submitInfo.pSignalSemaphoreInfos = semaphoreInfoArr.data() + semaphoreInfoArr.size();
+        for (const VulkanSemaphoreSubmit& signal : batch.signalArr)
+            semaphoreInfoArr.push_back(GetSemaphoreSubmitInfo(signal));
+
+        submitInfoArr.push_back(submitInfo);
+    }
+
+    if (vkQueueSubmit2(_vkQueue, static_cast<uint32_t>(submitInfoArr.size()), submitInfoArr.data(), fence) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to submit command buffers!");
+    }
+}
+
+void VulkanQueue::SubmitLegacy(const std::vector<VulkanSubmitBatch>& batchArr, VkFence fence)
+{
+    struct LegacyBatch
+    {
+        std::vector<VkSemaphore> waitSemaphoreArr;
+        std::vector<VkPipelineStageFlags> waitStageArr;
+        std::vector<uint64_t> waitValueArr;
+        std::vector<VkCommandBuffer> commandBufferArr;
+        std::vector<VkSemaphore> signalSemaphoreArr;
+        std::vector<uint64_t> signalValueArr;
+        VkTimelineSemaphoreSubmitInfo timelineInfo;
+    };
+
+    // Sized up front, the submit infos point into it
+    std::vector<LegacyBatch> legacyBatchArr(batchArr.size());
+    std::vector<VkSubmitInfo> submitInfoArr(batchArr.size());
+
+    for (size_t i = 0; i < batchArr.size(); i++)
+    {
+        const VulkanSubmitBatch& batch = batchArr[i];
+        LegacyBatch& legacyBatch = legacyBatchArr[i];
+
+        // The legacy stage bits are the low bits of the synchronization2 ones
+        for (const VulkanSemaphoreSubmit& wait : batch.waitArr)
+        {
+            legacyBatch.waitSemaphoreArr.push_back(wait.semaphore);
+            legacyBatch.waitStageArr.push_back(static_cast<VkPipelineStageFlags>(wait.stageMask));
+            legacyBatch.waitValueArr.push_back(wait.value);
+        }
+        for (TPtr<VulkanCommandBuffer> commandBuffer : batch.commandBufferArr)
+            legacyBatch.commandBufferArr.push_back(commandBuffer->GetRawCommandBuffer());
+        for (const VulkanSemaphoreSubmit& signal : batch.signalArr)
+        {
+            legacyBatch.signalSemaphoreArr.push_back(signal.semaphore);
+            legacyBatch.signalValueArr.push_back(signal.value);
+        }
+
+        legacyBatch.timelineInfo = {};
+        legacyBatch.timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+        legacyBatch.timelineInfo.waitSemaphoreValueCount = static_cast<uint32_t>(legacyBatch.waitValueArr.size());
+        legacyBatch.timelineInfo.pWaitSemaphoreValues = legacyBatch.waitValueArr.data();
+        legacyBatch.timelineInfo.signalSemaphoreValueCount = static_cast<uint32_t>(legacyBatch.signalValueArr.size());
+        legacyBatch.timelineInfo.pSignalSemaphoreValues = legacyBatch.signalValueArr.data();
+
+        VkSubmitInfo& submitInfo = submitInfoArr[i];
+        submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        submitInfo.pNext = &legacyBatch.timelineInfo;
+        submitInfo.waitSemaphoreCount = static_cast<uint32_t>(legacyBatch.waitSemaphoreArr.size());
+        submitInfo.pWaitSemaphores = legacyBatch.waitSemaphoreArr.data();
+        submitInfo.pWaitDstStageMask = legacyBatch.waitStageArr.data();
+        submitInfo.commandBufferCount = static_cast<uint32_t>(legacyBatch.commandBufferArr.size());
+        submitInfo.pCommandBuffers = legacyBatch.commandBufferArr.data();
+        submitInfo.signalSemaphoreCount = static_cast<uint32_t>(legacyBatch.signalSemaphoreArr.size());
+        submitInfo.pSignalSemaphores = legacyBatch.signalSemaphoreArr.data();
+    }
+
+    if (vkQueueSubmit(_vkQueue, static_cast<uint32_t>(submitInfoArr.size()), submitInfoArr.data(), fence) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to submit command buffers!");
     }
 }
 
-void VulkanQueue::Present(TPtr<VulkanSwapchain> swapchain, const std::vector<VkSemaphore>& waitSemaphoreArr)
+void VulkanQueue::Present(TPtr<VulkanSwapchain> swapchain, const std::vector<VkSemaphore>& waitSemaphoreArr, uint64_t presentId)
 {
     VkSwapchainKHR swapchains[] = {swapchain->GetRawSwapchain()};
     uint32_t imageIndex = swapchain->GetCurrentAcquiredIndex();
@@ -53,6 +178,13 @@ void VulkanQueue::Present(TPtr<VulkanSwapchain> swapchain, const std::vector<VkS
     presentInfo.pImageIndices = &imageIndex;
     presentInfo.pResults = nullptr; // Optional
 
+    VkPresentIdKHR presentIdInfo{};
+    presentIdInfo.sType = VK_STRUCTURE_TYPE_PRESENT_ID_KHR;
+    presentIdInfo.swapchainCount = 1;
+    presentIdInfo.pPresentIds = &presentId;
+    if (presentId > 0 && _device->IsPresentWaitSupported())
+        presentInfo.pNext = &presentIdInfo;
+
     vkQueuePresentKHR(_vkQueue, &presentInfo);
 }
 
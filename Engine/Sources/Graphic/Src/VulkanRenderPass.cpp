@@ -1,5 +1,6 @@
 #include "VulkanRenderPass.h"
 #include "VulkanDevice.h"
+#include "CoreHash.h"
 
 #include <stdexcept>
 
@@ -7,7 +8,7 @@
 namespace ZE {
 
 VulkanRenderPass::VulkanRenderPass(TPtr<VulkanDevice> device, const std::vector<VkAttachmentDescription>& colorAttachmentDescriptionArr, const VkAttachmentDescription& depthAttachment)
-    : _device(device), _vkRenderPass(VK_NULL_HANDLE)
+    : _device(device), _vkRenderPass(VK_NULL_HANDLE), _compatibilityHash(ComputeCompatibilityHash(colorAttachmentDescriptionArr, &depthAttachment))
 {
     std::vector<VkAttachmentDescription> attachmentDescriptionArr;
     attachmentDescriptionArr.insert(attachmentDescriptionArr.begin(), colorAttachmentDescriptionArr.begin(), colorAttachmentDescriptionArr.end());
@@ -60,7 +61,7 @@ VulkanRenderPass::VulkanRenderPass(TPtr<VulkanDevice> device, const std::vector<
 }
 
 VulkanRenderPass::VulkanRenderPass(TPtr<VulkanDevice> device, const std::vector<VkAttachmentDescription>& colorAttachmentDescriptionArr)
-    : _device(device), _vkRenderPass(VK_NULL_HANDLE)
+    : _device(device), _vkRenderPass(VK_NULL_HANDLE), _compatibilityHash(ComputeCompatibilityHash(colorAttachmentDescriptionArr, nullptr))
 {
     // Reference
     std::vector<VkAttachmentReference> colorAttachmentRefArr;
@@ -104,7 +105,7 @@ VulkanRenderPass::VulkanRenderPass(TPtr<VulkanDevice> device, const std::vector<
 }
 
 VulkanRenderPass::VulkanRenderPass(TPtr<VulkanDevice> device, const VkAttachmentDescription& depthAttachment)
-    : _device(device), _vkRenderPass(VK_NULL_HANDLE)
+    : _device(device), _vkRenderPass(VK_NULL_HANDLE), _compatibilityHash(ComputeCompatibilityHash({}, &depthAttachment))
 {
     // Reference
     VkAttachmentReference depthAttachmentRef{};
@@ -143,10 +144,38 @@ VulkanRenderPass::VulkanRenderPass(TPtr<VulkanDevice> device, const VkAttachment
 
 VulkanRenderPass::~VulkanRenderPass()
 {
-    if (_vkRenderPass != VK_NULL_HANDLE)
-        vkDestroyRenderPass(_device->GetRawDevice(), _vkRenderPass, nullptr);
+    if (_vkRenderPass == VK_NULL_HANDLE)
+        return;
+
+    _device->DeferDestruction([device = _device, vkRenderPass = _vkRenderPass]() {
+        vkDestroyRenderPass(device->GetRawDevice(), vkRenderPass, nullptr);
+    });
+}
+
+uint64_t VulkanRenderPass::ComputeCompatibilityHash(const std::vector<VkAttachmentDescription>& colorAttachmentDescriptionArr, const VkAttachmentDescription* depthAttachment)
+{
+    HashWriter writer;
+    writer.Write(static_cast<uint32_t>(colorAttachmentDescriptionArr.size()));
+    for (const VkAttachmentDescription& attachment : colorAttachmentDescriptionArr)
+    {
+        writer.Write(attachment.format);
+        writer.Write(attachment.samples);
+    }
+
+    writer.Write(depthAttachment != nullptr);
+    if (depthAttachment != nullptr)
+    {
+        writer.Write(depthAttachment->format);
+        writer.Write(depthAttachment->samples);
+    }
+
+    return writer.GetHash();
 }
 
+uint64_t VulkanRenderPass::GetCompatibilityHash()
+{
+    return _compatibilityHash;
+}
 
 VkRenderPass VulkanRenderPass::GetRawRenderPass()
 {
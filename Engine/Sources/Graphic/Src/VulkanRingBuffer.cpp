@@ -0,0 +1,86 @@
+#include "VulkanRingBuffer.h"
+#include "VulkanBuffer.h"
+#include "VulkanDevice.h"
+
+#include <stdexcept>
+#include <algorithm>
+#include <cstring>
+
+
+namespace ZE {
+
+VulkanRingBuffer::VulkanRingBuffer(TPtr<VulkanDevice> device, uint32_t regionSize, uint32_t regionCount, VkBufferUsageFlags usage, uint32_t alignment)
+    : _mappedAddress(nullptr), _regionCount(regionCount), _alignment(std::max(alignment, 1u)), _regionBegin(0), _head(0), _peakUsedSize(0)
+{
+    // Every region starts aligned so that offsets within it stay aligned
+    _regionSize = (regionSize + _alignment - 1) / _alignment * _alignment;
+
+    _buffer = std::make_shared<VulkanBuffer>(device, _regionSize * _regionCount, usage, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, EVulkanMemoryCategory::Uniform);
+    _mappedAddress = static_cast<uint8_t*>(_buffer->MapMemory(0, _buffer->GetSize()));
+}
+
+VulkanRingBuffer::~VulkanRingBuffer()
+{
+    _buffer->UnmapMemory();
+    _mappedAddress = nullptr;
+}
+
+void VulkanRingBuffer::BeginRegion(uint32_t regionIndex)
+{
+    if (regionIndex >= _regionCount)
+        throw std::runtime_error("ring buffer region is out of range!");
+
+    _regionBegin = regionIndex * _regionSize;
+    _head = _regionBegin;
+}
+
+uint32_t VulkanRingBuffer::Allocate(uint32_t size, void*& mappedAddress)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    uint32_t offset = (_head + _alignment - 1) / _alignment * _alignment;
+    if (offset + size > _regionBegin + _regionSize)
+        throw std::runtime_error("ring buffer region is exhausted!");
+
+    _head = offset + size;
+    _peakUsedSize = std::max(_peakUsedSize, _head - _regionBegin);
+
+    mappedAddress = _mappedAddress + offset;
+    return offset;
+}
+
+uint32_t VulkanRingBuffer::Write(const void* data, uint32_t size)
+{
+    void* mappedAddress;
+    uint32_t offset = Allocate(size, mappedAddress);
+    memcpy(mappedAddress, data, size);
+
+    return offset;
+}
+
+uint32_t VulkanRingBuffer::GetAlignment()
+{
+    return _alignment;
+}
+
+uint32_t VulkanRingBuffer::GetRegionSize()
+{
+    return _regionSize;
+}
+
+uint32_t VulkanRingBuffer::GetUsedSize()
+{
+    return _head - _regionBegin;
+}
+
+uint32_t VulkanRingBuffer::GetPeakUsedSize()
+{
+    return _peakUsedSize;
+}
+
+TPtr<VulkanBuffer> VulkanRingBuffer::GetBuffer()
+{
+    return _buffer;
+}
+
+} // namespace ZE
\ No newline at end of file
@@ -36,8 +36,12 @@ VulkanSampler::VulkanSampler(TPtr<VulkanDevice> device)
 
 VulkanSampler::~VulkanSampler()
 {
-    if (_vkSampler != VK_NULL_HANDLE)
-        vkDestroySampler(_device->GetRawDevice(), _vkSampler, nullptr);
+    if (_vkSampler == VK_NULL_HANDLE)
+        return;
+
+    _device->DeferDestruction([device = _device, vkSampler = _vkSampler]() {
+        vkDestroySampler(device->GetRawDevice(), vkSampler, nullptr);
+    });
 }
 
 VkSampler VulkanSampler::GetRawSampler()
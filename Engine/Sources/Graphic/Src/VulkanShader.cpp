@@ -1,5 +1,6 @@
 #include "VulkanShader.h"
 #include "VulkanDevice.h"
+#include "CoreHash.h"
 
 #include <stdexcept>
 
@@ -7,7 +8,7 @@
 namespace ZE {
 
 VulkanShader::VulkanShader(TPtr<VulkanDevice> device, const std::vector<char>& byteCode)
-    : _device(device), _vkShaderModule(VK_NULL_HANDLE)
+    : _device(device), _codeHash(HashBytes(byteCode.data(), byteCode.size())), _vkShaderModule(VK_NULL_HANDLE)
 {
 
     VkShaderModuleCreateInfo createInfo{};
@@ -27,6 +28,11 @@ VulkanShader::~VulkanShader()
         vkDestroyShaderModule(_device->GetRawDevice(), _vkShaderModule, nullptr);
 }
 
+uint64_t VulkanShader::GetCodeHash()
+{
+    return _codeHash;
+}
+
 VkShaderModule VulkanShader::GetRawShader()
 {
     return _vkShaderModule;
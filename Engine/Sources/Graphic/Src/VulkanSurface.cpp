@@ -6,6 +6,7 @@
 
 #include <stdexcept>
 #include <algorithm>
+#include <iostream>
 
 namespace ZE {
 
@@ -44,15 +45,18 @@ void VulkanSurface::InitializePresentMode(TPtr<VulkanGPU> GPU, VkPresentModeKHR
 {
     std::vector<VkPresentModeKHR> supportedPresentModes = GetSupportedPresentModes(GPU);
 
-    _presentMode = VkPresentModeKHR::VK_PRESENT_MODE_IMMEDIATE_KHR;
+    // FIFO is the only mode every surface supports, and the only one that never tears
+    _presentMode = VkPresentModeKHR::VK_PRESENT_MODE_FIFO_KHR;
     for (const VkPresentModeKHR& presentMode : supportedPresentModes)
     {
         if (presentMode == presentModeHint)
         {
             _presentMode = presentMode;
-            break;
+            return;
         }
     }
+
+    std::cerr << "warning: present mode " << GetPresentModeName(presentModeHint) << " is not supported by the surface, using " << GetPresentModeName(_presentMode) << std::endl;
 }
 
 void VulkanSurface::InitializeExtent(TPtr<VulkanGPU> GPU, const VkExtent2D& extentHint)
@@ -86,6 +90,23 @@ VkPresentModeKHR VulkanSurface::GetPresentMode()
     return _presentMode;
 }
 
+const char* VulkanSurface::GetPresentModeName(VkPresentModeKHR presentMode)
+{
+    switch (presentMode)
+    {
+    case VK_PRESENT_MODE_IMMEDIATE_KHR:
+        return "immediate";
+    case VK_PRESENT_MODE_MAILBOX_KHR:
+        return "mailbox";
+    case VK_PRESENT_MODE_FIFO_KHR:
+        return "fifo";
+    case VK_PRESENT_MODE_FIFO_RELAXED_KHR:
+        return "fifo relaxed";
+    default:
+        return "other";
+    }
+}
+
 VkExtent2D VulkanSurface::GetExtent()
 {
     return _vkExtent;
@@ -2,8 +2,10 @@
 #include "VulkanDevice.h"
 #include "VulkanSurface.h"
 #include "VulkanImage.h"
+#include "VulkanImageView.h"
 
 #include <stdexcept>
+#include <algorithm>
 #include <assert.h>
 
 
@@ -17,6 +19,11 @@ VulkanSwapchain::VulkanSwapchain(TPtr<VulkanDevice> device, TPtr<VulkanSurface>
     VkSurfaceCapabilitiesKHR vkCapabilities = _surface->GetCpabilities(_device->GetGPU());
     VkExtent2D extent = _surface->GetExtent();
 
+    // A max image count of 0 means no limit
+    imageCount = std::max(imageCount, vkCapabilities.minImageCount);
+    if (vkCapabilities.maxImageCount > 0)
+        imageCount = std::min(imageCount, vkCapabilities.maxImageCount);
+
     // Create
     VkSwapchainCreateInfoKHR vkSwapchainCreateInfo{};
     vkSwapchainCreateInfo.sType = VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR;
@@ -57,12 +64,15 @@ VulkanSwapchain::VulkanSwapchain(TPtr<VulkanDevice> device, TPtr<VulkanSurface>
     {
         TPtr<VulkanImage> vulkanImage = std::make_shared<VulkanImage>(_device, vkImages[i], extent3D, surfaceFormat.format);
         vulkanImages[i] = vulkanImage;
+        _imageViewArr.push_back(std::make_shared<VulkanImageView>(vulkanImage));
     }
     _imagerArr.swap(vulkanImages);
 }
 
 VulkanSwapchain::~VulkanSwapchain()
 {
+    _imageViewArr.clear();
+
     if (_vkSwapchain != VK_NULL_HANDLE)
         vkDestroySwapchainKHR(_device->GetRawDevice(), _vkSwapchain, nullptr);
 }
@@ -78,10 +88,38 @@ TPtr<VulkanImage> VulkanSwapchain::AcquireNextImage(uint64_t timeout, VkSemaphor
 {
     VkResult result = vkAcquireNextImageKHR(_device->GetRawDevice(), _vkSwapchain, timeout, semaphore, fence, &_acquiredIndex);
 
-    if (result == VkResult::VK_SUCCESS)
+    // A suboptimal swapchain still presents, the image is acquired and the semaphore will be signaled
+    if (result == VkResult::VK_SUCCESS || result == VkResult::VK_SUBOPTIMAL_KHR)
         return _imagerArr[_acquiredIndex];
-    else
+
+    // Nothing was acquired and the semaphore is left untouched, the frame can try again
+    if (result == VkResult::VK_TIMEOUT || result == VkResult::VK_NOT_READY)
         return nullptr;
+
+    if (result == VkResult::VK_ERROR_OUT_OF_DATE_KHR)
+    {
+        throw std::runtime_error("swapchain is out of date and can't be recreated!");
+    }
+
+    throw std::runtime_error("failed to acquire swapchain image!");
+}
+
+TPtr<VulkanImageView> VulkanSwapchain::GetImageView(uint32_t index)
+{
+    return _imageViewArr[index];
+}
+
+uint32_t VulkanSwapchain::GetImageCount()
+{
+    return static_cast<uint32_t>(_imagerArr.size());
+}
+
+bool VulkanSwapchain::WaitForPresent(uint64_t presentId, uint64_t timeout)
+{
+    if (!_device->IsPresentWaitSupported())
+        return false;
+
+    return _device->WaitForPresent(_vkSwapchain, presentId, timeout) == VK_SUCCESS;
 }
 
 VkSwapchainKHR VulkanSwapchain::GetRawSwapchain()
@@ -0,0 +1,56 @@
+#include "VulkanTimelineSemaphore.h"
+#include "VulkanDevice.h"
+
+#include <stdexcept>
+
+
+namespace ZE {
+
+VulkanTimelineSemaphore::VulkanTimelineSemaphore(TPtr<VulkanDevice> device, uint64_t initialValue)
+    : _device(device), _vkSemaphore(VK_NULL_HANDLE)
+{
+    VkSemaphoreTypeCreateInfo typeInfo{};
+    typeInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+    typeInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+    typeInfo.initialValue = initialValue;
+
+    VkSemaphoreCreateInfo semaphoreInfo{};
+    semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+    semaphoreInfo.pNext = &typeInfo;
+
+    if (vkCreateSemaphore(device->GetRawDevice(), &semaphoreInfo, nullptr, &_vkSemaphore) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to create timeline semaphore!");
+    }
+}
+
+VulkanTimelineSemaphore::~VulkanTimelineSemaphore()
+{
+    vkDestroySemaphore(_device->GetRawDevice(), _vkSemaphore, nullptr);
+}
+
+uint64_t VulkanTimelineSemaphore::GetCompletedValue()
+{
+    uint64_t value = 0;
+    vkGetSemaphoreCounterValue(_device->GetRawDevice(), _vkSemaphore, &value);
+
+    return value;
+}
+
+bool VulkanTimelineSemaphore::Wait(uint64_t value, uint64_t timeout)
+{
+    VkSemaphoreWaitInfo waitInfo{};
+    waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+    waitInfo.semaphoreCount = 1;
+    waitInfo.pSemaphores = &_vkSemaphore;
+    waitInfo.pValues = &value;
+
+    return vkWaitSemaphores(_device->GetRawDevice(), &waitInfo, timeout) == VK_SUCCESS;
+}
+
+VkSemaphore VulkanTimelineSemaphore::GetRawSemaphore()
+{
+    return _vkSemaphore;
+}
+
+} // namespace ZE
\ No newline at end of file
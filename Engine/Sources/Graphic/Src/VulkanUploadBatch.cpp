@@ -0,0 +1,332 @@
+#include "VulkanUploadBatch.h"
+#include "VulkanBuffer.h"
+#include "VulkanImage.h"
+#include "VulkanBufferManager.h"
+#include "VulkanCommandBuffer.h"
+
+#include <assert.h>
+#include <cstring>
+#include <unordered_map>
+
+
+namespace ZE {
+
+// Offset alignment of each upload inside the shared staging allocation, covers every texel size we upload
+const VkDeviceSize UploadAlignment = 16;
+
+VkDeviceSize AlignUploadOffset(VkDeviceSize offset)
+{
+    return (offset + UploadAlignment - 1) & ~(UploadAlignment - 1);
+}
+
+void GetBufferUsageAccess(VkBufferUsageFlags usage, VkPipelineStageFlags& stageMask, VkAccessFlags& accessMask)
+{
+    if (usage & VK_BUFFER_USAGE_VERTEX_BUFFER_BIT)
+    {
+        stageMask |= VK_PIPELINE_STAGE_VERTEX_INPUT_BIT;
+        accessMask |= VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT;
+    }
+    if (usage & VK_BUFFER_USAGE_INDEX_BUFFER_BIT)
+    {
+        stageMask |= VK_PIPELINE_STAGE_VERTEX_INPUT_BIT;
+        accessMask |= VK_ACCESS_INDEX_READ_BIT;
+    }
+    if (usage & VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT)
+    {
+        stageMask |= VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT;
+        accessMask |= VK_ACCESS_INDIRECT_COMMAND_READ_BIT;
+    }
+    if (usage & VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT)
+    {
+        stageMask |= VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+        accessMask |= VK_ACCESS_UNIFORM_READ_BIT;
+    }
+    if (usage & VK_BUFFER_USAGE_STORAGE_BUFFER_BIT)
+    {
+        stageMask |= VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+        accessMask |= VK_ACCESS_SHADER_READ_BIT;
+    }
+    if (usage & VK_BUFFER_USAGE_TRANSFER_SRC_BIT)
+    {
+        stageMask |= VK_PIPELINE_STAGE_TRANSFER_BIT;
+        accessMask |= VK_ACCESS_TRANSFER_READ_BIT;
+    }
+}
+
+VkImageMemoryBarrier MakeUploadImageBarrier(TPtr<VulkanImage> image, VkImageLayout oldLayout, VkImageLayout newLayout)
+{
+    VkImageMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.oldLayout = oldLayout;
+    barrier.newLayout = newLayout;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = image->GetRawImage();
+    barrier.subresourceRange.aspectMask = VulkanImage::GetAspectMask(image->GetFormat());
+    barrier.subresourceRange.baseMipLevel = 0;
+    barrier.subresourceRange.levelCount = 1;
+    barrier.subresourceRange.baseArrayLayer = 0;
+    barrier.subresourceRange.layerCount = 1;
+
+    return barrier;
+}
+
+VulkanUploadBatch::VulkanUploadBatch(TPtr<VulkanBufferManager> bufferManager)
+    : _bufferManager(bufferManager), _srcQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED), _dstQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED), _pendingSize(0), _copyCommandCount(0), _barrierCommandCount(0), _uploadedSize(0)
+{
+}
+
+VulkanUploadBatch::~VulkanUploadBatch()
+{
+    assert(IsEmpty());
+}
+
+void VulkanUploadBatch::UploadBuffer(TPtr<VulkanBuffer> buffer, const void* data, VkDeviceSize size, VkDeviceSize dstOffset)
+{
+    if (size == 0)
+        return;
+
+    _bufferUploadArr.push_back({buffer, data, size, dstOffset});
+    _pendingSize = AlignUploadOffset(_pendingSize) + size;
+}
+
+void VulkanUploadBatch::UploadImage(TPtr<VulkanImage> image, const void* data, VkDeviceSize size, VkImageLayout finalLayout)
+{
+    _imageUploadArr.push_back({image, data, size, finalLayout});
+    _pendingSize = AlignUploadOffset(_pendingSize) + size;
+}
+
+void VulkanUploadBatch::SetQueueFamilyTransfer(uint32_t srcQueueFamilyIndex, uint32_t dstQueueFamilyIndex)
+{
+    bool isTransfer = srcQueueFamilyIndex != dstQueueFamilyIndex;
+    _srcQueueFamilyIndex = isTransfer ? srcQueueFamilyIndex : VK_QUEUE_FAMILY_IGNORED;
+    _dstQueueFamilyIndex = isTransfer ? dstQueueFamilyIndex : VK_QUEUE_FAMILY_IGNORED;
+}
+
+void VulkanUploadBatch::Flush(TPtr<VulkanCommandBuffer> commandBuffer)
+{
+    if (IsEmpty())
+        return;
+
+    Flush(commandBuffer, _bufferManager->AllocateStaging(_pendingSize, UploadAlignment));
+}
+
+void VulkanUploadBatch::Flush(TPtr<VulkanCommandBuffer> commandBuffer, const StagingAllocation& staging)
+{
+    if (IsEmpty())
+        return;
+
+    VkCommandBuffer vkCommandBuffer = commandBuffer->GetRawCommandBuffer();
+    bool isOwnershipTransfer = _srcQueueFamilyIndex != _dstQueueFamilyIndex;
+
+    uint8_t* mappedAddress = static_cast<uint8_t*>(staging.mappedAddress);
+    VkDeviceSize stagingOffset = 0;
+
+    // Regions grouped per destination, in the order the destinations were first seen
+    std::vector<std::pair<TPtr<VulkanBuffer>, std::vector<VkBufferCopy>>> bufferCopyArr;
+    std::unordered_map<VulkanBuffer*, size_t> bufferCopyIndexMap;
+    VkPipelineStageFlags bufferStageMask = 0;
+    VkAccessFlags bufferAccessMask = 0;
+
+    for (BufferUpload& upload : _bufferUploadArr)
+    {
+        stagingOffset = AlignUploadOffset(stagingOffset);
+        memcpy(mappedAddress + stagingOffset, upload.data, upload.size);
+
+        auto [it, isInserted] = bufferCopyIndexMap.try_emplace(upload.buffer.get(), bufferCopyArr.size());
+        if (isInserted)
+        {
+            bufferCopyArr.emplace_back(upload.buffer, std::vector<VkBufferCopy>());
+            GetBufferUsageAccess(upload.buffer->GetUsage(), bufferStageMask, bufferAccessMask);
+        }
+
+        bufferCopyArr[it->second].second.push_back({staging.offset + stagingOffset, upload.dstOffset, upload.size});
+        stagingOffset += upload.size;
+    }
+
+    std::vector<VkBufferImageCopy> imageCopyArr;
+    std::vector<VkImageMemoryBarrier> preBarrierArr;
+    std::vector<VkImageMemoryBarrier> postBarrierArr;
+    VkPipelineStageFlags imageStageMask = 0;
+
+    for (ImageUpload& upload : _imageUploadArr)
+    {
+        stagingOffset = AlignUploadOffset(stagingOffset);
+        memcpy(mappedAddress + stagingOffset, upload.data, upload.size);
+
+        VkBufferImageCopy region{};
+        region.bufferOffset = staging.offset + stagingOffset;
+        region.bufferRowLength = 0;
+        region.bufferImageHeight = 0;
+        region.imageSubresource.aspectMask = VulkanImage::GetAspectMask(upload.image->GetFormat());
+        region.imageSubresource.mipLevel = 0;
+        region.imageSubresource.baseArrayLayer = 0;
+        region.imageSubresource.layerCount = 1;
+        region.imageOffset = {0, 0, 0};
+        region.imageExtent = upload.image->GetExtent();
+        imageCopyArr.push_back(region);
+
+        VkImageMemoryBarrier preBarrier = MakeUploadImageBarrier(upload.image, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+        preBarrier.srcAccessMask = VK_ACCESS_NONE;
+        preBarrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        preBarrierArr.push_back(preBarrier);
+
+        VkPipelineStageFlags stageMask;
+        VkImageMemoryBarrier postBarrier = MakeUploadImageBarrier(upload.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, upload.finalLayout);
+        postBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        VulkanImage::GetLayoutUsage(upload.finalLayout, stageMask, postBarrier.dstAccessMask);
+        postBarrierArr.push_back(postBarrier);
+        imageStageMask |= stageMask;
+
+        stagingOffset += upload.size;
+    }
+
+    if (!preBarrierArr.empty())
+    {
+        vkCmdPipelineBarrier(vkCommandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr,
+                             static_cast<uint32_t>(preBarrierArr.size()), preBarrierArr.data());
+        _barrierCommandCount++;
+    }
+
+    for (auto& [buffer, regionArr] : bufferCopyArr)
+    {
+        vkCmdCopyBuffer(vkCommandBuffer, staging.buffer->GetRawBuffer(), buffer->GetRawBuffer(), static_cast<uint32_t>(regionArr.size()), regionArr.data());
+        _copyCommandCount++;
+    }
+
+    for (size_t i = 0; i < _imageUploadArr.size(); i++)
+    {
+        vkCmdCopyBufferToImage(vkCommandBuffer, staging.buffer->GetRawBuffer(), _imageUploadArr[i].image->GetRawImage(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &imageCopyArr[i]);
+        _copyCommandCount++;
+    }
+
+    if (isOwnershipTransfer)
+    {
+        // Release to the destination family, the layout transitions happen here and again in the matching acquire
+        std::vector<VkBufferMemoryBarrier> releaseBarrierArr;
+        for (auto& [buffer, regionArr] : bufferCopyArr)
+        {
+            VkBufferMemoryBarrier barrier{};
+            barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+            barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            barrier.dstAccessMask = VK_ACCESS_NONE;
+            barrier.srcQueueFamilyIndex = _srcQueueFamilyIndex;
+            barrier.dstQueueFamilyIndex = _dstQueueFamilyIndex;
+            barrier.buffer = buffer->GetRawBuffer();
+            barrier.offset = 0;
+            barrier.size = VK_WHOLE_SIZE;
+            releaseBarrierArr.push_back(barrier);
+
+            barrier.srcAccessMask = VK_ACCESS_NONE;
+            barrier.dstAccessMask = bufferAccessMask;
+            _acquire.bufferBarrierArr.push_back(barrier);
+        }
+
+        for (size_t i = 0; i < postBarrierArr.size(); i++)
+        {
+            VkImageMemoryBarrier& barrier = postBarrierArr[i];
+            barrier.srcQueueFamilyIndex = _srcQueueFamilyIndex;
+            barrier.dstQueueFamilyIndex = _dstQueueFamilyIndex;
+
+            VkImageMemoryBarrier acquireBarrier = barrier;
+            acquireBarrier.srcAccessMask = VK_ACCESS_NONE;
+            _acquire.imageBarrierArr.push_back(acquireBarrier);
+
+            barrier.dstAccessMask = VK_ACCESS_NONE;
+        }
+
+        _acquire.dstStageMask |= bufferStageMask | imageStageMask;
+
+        vkCmdPipelineBarrier(vkCommandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, nullptr,
+                             static_cast<uint32_t>(releaseBarrierArr.size()), releaseBarrierArr.data(),
+                             static_cast<uint32_t>(postBarrierArr.size()), postBarrierArr.data());
+        _barrierCommandCount++;
+    }
+    else
+    {
+        // Buffers are covered by a global barrier, images by their layout transitions, all in one call
+        VkMemoryBarrier memoryBarrier{};
+        memoryBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        memoryBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        memoryBarrier.dstAccessMask = bufferAccessMask;
+        uint32_t memoryBarrierCount = bufferCopyArr.empty() ? 0 : 1;
+
+        VkPipelineStageFlags destinationStage = bufferStageMask | imageStageMask;
+        if (destinationStage == 0)
+            destinationStage = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+
+        vkCmdPipelineBarrier(vkCommandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, destinationStage, 0, memoryBarrierCount, &memoryBarrier, 0, nullptr,
+                             static_cast<uint32_t>(postBarrierArr.size()), postBarrierArr.data());
+        _barrierCommandCount++;
+    }
+
+    for (auto& [buffer, regionArr] : bufferCopyArr)
+        _acquire.bufferArr.push_back(buffer);
+
+    for (ImageUpload& upload : _imageUploadArr)
+    {
+        upload.image->SetLayout(upload.finalLayout);
+        _acquire.imageArr.push_back(upload.image);
+    }
+
+    _uploadedSize += _pendingSize;
+    _bufferUploadArr.clear();
+    _imageUploadArr.clear();
+    _pendingSize = 0;
+}
+
+void VulkanUploadBatch::RecordAcquire(TPtr<VulkanCommandBuffer> commandBuffer, const std::vector<VulkanUploadAcquire>& acquireArr)
+{
+    std::vector<VkBufferMemoryBarrier> bufferBarrierArr;
+    std::vector<VkImageMemoryBarrier> imageBarrierArr;
+    VkPipelineStageFlags dstStageMask = 0;
+
+    for (const VulkanUploadAcquire& acquire : acquireArr)
+    {
+        bufferBarrierArr.insert(bufferBarrierArr.end(), acquire.bufferBarrierArr.begin(), acquire.bufferBarrierArr.end());
+        imageBarrierArr.insert(imageBarrierArr.end(), acquire.imageBarrierArr.begin(), acquire.imageBarrierArr.end());
+        dstStageMask |= acquire.dstStageMask;
+    }
+
+    if (bufferBarrierArr.empty() && imageBarrierArr.empty())
+        return;
+
+    vkCmdPipelineBarrier(commandBuffer->GetRawCommandBuffer(), VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, dstStageMask, 0, 0, nullptr,
+                         static_cast<uint32_t>(bufferBarrierArr.size()), bufferBarrierArr.data(),
+                         static_cast<uint32_t>(imageBarrierArr.size()), imageBarrierArr.data());
+}
+
+VulkanUploadAcquire VulkanUploadBatch::TakeAcquire()
+{
+    VulkanUploadAcquire acquire = std::move(_acquire);
+    _acquire = VulkanUploadAcquire{};
+
+    return acquire;
+}
+
+bool VulkanUploadBatch::IsEmpty()
+{
+    return _bufferUploadArr.empty() && _imageUploadArr.empty();
+}
+
+VkDeviceSize VulkanUploadBatch::GetPendingSize()
+{
+    return _pendingSize;
+}
+
+uint32_t VulkanUploadBatch::GetCopyCommandCount()
+{
+    return _copyCommandCount;
+}
+
+uint32_t VulkanUploadBatch::GetBarrierCommandCount()
+{
+    return _barrierCommandCount;
+}
+
+VkDeviceSize VulkanUploadBatch::GetUploadedSize()
+{
+    return _uploadedSize;
+}
+
+} // namespace ZE
\ No newline at end of file
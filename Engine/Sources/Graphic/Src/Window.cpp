@@ -43,7 +43,7 @@ Window::~Window()
     glfwTerminate();
 }
 
-void Window::CreateSurfaceAndSwapchain(TPtr<VulkanDevice> device)
+void Window::CreateSurfaceAndSwapchain(TPtr<VulkanDevice> device, VkPresentModeKHR presentMode, uint32_t imageCount)
 {
     TPtr<VulkanGPU> GPU = device->GetGPU();
 
@@ -53,9 +53,9 @@ void Window::CreateSurfaceAndSwapchain(TPtr<VulkanDevice> device)
     _surface->InitializeExtent(GPU, extent);
     VkSurfaceFormatKHR surfaceFormat{ VkFormat::VK_FORMAT_B8G8R8A8_UNORM, VkColorSpaceKHR::VK_COLOR_SPACE_SRGB_NONLINEAR_KHR};
     _surface->InitializeFormat(GPU, surfaceFormat);
-    _surface->InitializePresentMode(GPU, VkPresentModeKHR::VK_PRESENT_MODE_MAILBOX_KHR);
+    _surface->InitializePresentMode(GPU, presentMode);
 
-    _swapchain = std::make_shared<VulkanSwapchain>(device, _surface, 3);
+    _swapchain = std::make_shared<VulkanSwapchain>(device, _surface, imageCount);
 }
 
 bool Window::ShouldClose()
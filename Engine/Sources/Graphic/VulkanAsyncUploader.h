@@ -0,0 +1,82 @@
+#pragma once
+
+#include "CoreDefines.h"
+#include "CoreTypes.h"
+#include "VulkanUploadBatch.h"
+
+#include <vulkan/vulkan.h>
+
+#include <deque>
+#include <vector>
+
+
+namespace ZE {
+
+class VulkanDevice;
+class VulkanQueue;
+class VulkanBuffer;
+class VulkanBufferManager;
+class VulkanCommandPool;
+class VulkanCommandBuffer;
+class VulkanTimelineSemaphore;
+
+// Uploads on the transfer queue without blocking the frame loop. Each Submit records the queued uploads,
+// signals the next value of a timeline semaphore and returns it. When the transfer queue belongs to another
+// family than the graphic one the resources are released to the graphic family, RecordAcquire then records
+// the acquires of every landed submission into the frame's command buffer. Resources are ready once their
+// value is acquired. Staging memory comes from the buffer manager's ring and is reclaimed once the submission
+// landed, uploaded resources released early are only destroyed then too.
+class VulkanAsyncUploader
+{
+public:
+    VulkanAsyncUploader(TPtr<VulkanDevice> device, TPtr<VulkanBufferManager> bufferManager, TPtr<VulkanQueue> transferQueue, TPtr<VulkanQueue> graphicQueue);
+    ~VulkanAsyncUploader();
+
+    // Uploads queued on it go out with the next Submit, their data has to stay valid until then
+    TPtr<VulkanUploadBatch> GetBatch();
+    // Returns 0 when nothing was queued
+    uint64_t Submit();
+
+    // Returns the value the submission of the command buffer has to wait on, 0 when nothing new was acquired
+    uint64_t RecordAcquire(TPtr<VulkanCommandBuffer> commandBuffer);
+    bool IsReady(uint64_t value);
+    uint64_t GetAcquiredValue();
+    // Blocks until the submission landed, it still has to be acquired before use
+    void Wait(uint64_t value);
+
+    // Recycles the command buffers of landed submissions
+    void Tick();
+
+    TPtr<VulkanTimelineSemaphore> GetTimelineSemaphore();
+
+    uint32_t GetSubmissionCount();
+    VkDeviceSize GetUploadedSize();
+
+private:
+    struct Submission
+    {
+        uint64_t value;
+        TPtr<VulkanCommandBuffer> commandBuffer;
+        VulkanUploadAcquire acquire;
+        bool isAcquired;
+    };
+
+private:
+    TPtr<VulkanDevice> _device;
+    TPtr<VulkanBufferManager> _bufferManager;
+    TPtr<VulkanQueue> _transferQueue;
+    TPtr<VulkanCommandPool> _commandPool;
+    TPtr<VulkanTimelineSemaphore> _timelineSemaphore;
+
+    TPtr<VulkanUploadBatch> _batch;
+    std::deque<Submission> _submissionQueue;
+    TPtrArr<VulkanCommandBuffer> _freeCommandBufferArr;
+
+    uint64_t _submittedValue;
+    uint64_t _acquiredValue;
+
+    uint32_t _submissionCount;
+    VkDeviceSize _uploadedSize;
+};
+
+} // namespace ZE
\ No newline at end of file
@@ -2,6 +2,7 @@
 
 #include "CoreDefines.h"
 #include "CoreTypes.h"
+#include "VulkanMemoryAllocator.h"
 
 #include <vulkan/vulkan.h>
 
@@ -9,31 +10,45 @@ namespace ZE {
 
 class VulkanDevice;
 class VulkanCommandBuffer;
+class VulkanBufferManager;
+class VulkanTimelineSemaphore;
 
 class VulkanBuffer
 {
 public:
-    VulkanBuffer(TPtr<VulkanDevice> device, uint32_t size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties);
+    VulkanBuffer(TPtr<VulkanDevice> device, uint32_t size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties, EVulkanMemoryCategory category = EVulkanMemoryCategory::Other, EVulkanMemoryUsage memoryUsage = EVulkanMemoryUsage::Linear);
     ~VulkanBuffer();
 
 
-    void CopyFromBuffer(TPtr<VulkanCommandBuffer> commandBuffer, TPtr<VulkanBuffer> otherBuffer, VkDeviceSize size);
-    void TransferData(TPtr<VulkanCommandBuffer> commandBuffer, TPtr<VulkanBuffer> stagingBuffer, const void* data, uint32_t size);
+    void CopyFromBuffer(TPtr<VulkanCommandBuffer> commandBuffer, TPtr<VulkanBuffer> otherBuffer, VkDeviceSize size, VkDeviceSize srcOffset = 0);
+    // Host visible buffers are written directly, others through staging memory and a copy recorded in the command buffer
+    void TransferData(TPtr<VulkanCommandBuffer> commandBuffer, TPtr<VulkanBufferManager> bufferManager, const void* data, uint32_t size);
 
+    // Host visible buffers stay mapped for their whole life, unmapping is a no-op kept for symmetry
     void* MapMemory(VkDeviceSize offset, VkDeviceSize size);
     void UnmapMemory();
 
+    // Exchanges the raw buffers and their memory, used to move a buffer without changing its identity
+    void SwapStorage(VulkanBuffer& other);
+
+    // Work on another queue signaling the value uses the buffer, its destruction waits for it too
+    void SetTimelineUse(TPtr<VulkanTimelineSemaphore> semaphore, uint64_t value);
+
     uint32_t GetSize();
+    VkBufferUsageFlags GetUsage();
+    VkMemoryPropertyFlags GetMemoryProperties();
 
     VkBuffer GetRawBuffer();
-    VkDeviceMemory GetRawMemory();
+    const VulkanMemoryAllocation& GetAllocation();
 
 protected:
     uint32_t _size;
     VkBufferUsageFlags _usage;
     VkMemoryPropertyFlags _properties;
     VkBuffer _vkBuffer;
-    VkDeviceMemory _vkMemory;
+    VulkanMemoryAllocation _allocation;
+    TPtr<VulkanTimelineSemaphore> _timelineSemaphore;
+    uint64_t _timelineValue;
 
     TPtr<VulkanDevice> _device;
 };
@@ -3,37 +3,86 @@
 #include "CoreDefines.h"
 #include "CoreTypes.h"
 
+#include <vulkan/vulkan.h>
+
+#include <deque>
+
 
 namespace ZE {
 
 class VulkanDevice;
 class VulkanBuffer;
 class VulkanCommandBuffer;
+class VulkanTimelineSemaphore;
 
 
-struct StagingBufferEntry
+struct StagingAllocation
 {
     TPtr<VulkanBuffer> buffer;
-    TWeakPtr<VulkanCommandBuffer> weakCommandBuffer;
-    uint64_t frameCount;
+    VkDeviceSize offset;
+    void* mappedAddress;
 };
 
+// Staging memory for uploads, bump allocated from a persistently mapped ring. Every allocation belongs to
+// a timeline semaphore value, by default the frame timeline's value of the current frame, and its space is
+// reclaimed once the semaphore reached it. The ring is reclaimed in allocation order, so a value still
+// pending holds back the space allocated after it. Uploads too large for the ring, or made while it is
+// full, get a temporary buffer with the same lifetime.
 class VulkanBufferManager
 {
 public:
-    VulkanBufferManager(TPtr<VulkanDevice> device);
+    VulkanBufferManager(TPtr<VulkanDevice> device, VkDeviceSize ringSize, TPtr<VulkanTimelineSemaphore> frameTimeline);
     ~VulkanBufferManager();
 
-    TPtr<VulkanBuffer> AcquireStagingBuffer(uint32_t size);
-    void ReleaseStagingBuffer(TPtr<VulkanBuffer> buffer, TPtr<VulkanCommandBuffer> commandBuffer = nullptr);
+    // Consumed by commands submitted in the current frame
+    StagingAllocation AllocateStaging(VkDeviceSize size, VkDeviceSize alignment = 0);
+    // Consumed by a submission signaling value on semaphore, e.g. on another queue
+    StagingAllocation AllocateStaging(VkDeviceSize size, VkDeviceSize alignment, TPtr<VulkanTimelineSemaphore> semaphore, uint64_t value);
+    // Allocates and copies the data in
+    StagingAllocation Stage(const void* data, VkDeviceSize size, VkDeviceSize alignment = 0);
+
+    // Frame boundary, allocations from now on belong to the frame signaling the given value
+    void Tick(uint64_t frameValue);
+
+    VkDeviceSize GetRingSize();
+    VkDeviceSize GetPeakUsedSize();
+    uint32_t GetTemporaryBufferCount();
 
-    void Tick();
+private:
+    bool TryAllocateFromRing(VkDeviceSize size, VkDeviceSize alignment, TPtr<VulkanTimelineSemaphore> semaphore, uint64_t value, VkDeviceSize& offset);
+    VkDeviceSize GetUsedSize();
 
 private:
-    TPtrList<VulkanBuffer> _usedStagingBuffer, _freeStagingBuffer;
-    std::list<StagingBufferEntry> _pendingList;
+    struct Segment
+    {
+        // Ring head after the last allocation of the value
+        VkDeviceSize end;
+        TPtr<VulkanTimelineSemaphore> semaphore;
+        uint64_t value;
+    };
+
+    struct TemporaryBuffer
+    {
+        TPtr<VulkanBuffer> buffer;
+        TPtr<VulkanTimelineSemaphore> semaphore;
+        uint64_t value;
+    };
 
     TPtr<VulkanDevice> _device;
+    TPtr<VulkanTimelineSemaphore> _frameTimeline;
+    VkDeviceSize _minAlignment;
+
+    TPtr<VulkanBuffer> _ringBuffer;
+    uint8_t* _mappedAddress;
+    VkDeviceSize _ringSize;
+    VkDeviceSize _head;
+    VkDeviceSize _tail;
+    std::deque<Segment> _segmentQueue;
+    std::deque<TemporaryBuffer> _temporaryBufferQueue;
+
+    uint64_t _frameValue;
+    VkDeviceSize _peakUsedSize;
+    uint32_t _temporaryBufferCount;
 };
 
 } // namespace ZE
\ No newline at end of file
@@ -27,15 +27,20 @@ public:
     };
 
 public:
-    VulkanCommandBuffer(TPtr<VulkanCommandPool> commandPool);
+    VulkanCommandBuffer(TPtr<VulkanCommandPool> commandPool, VkCommandBufferLevel level = VK_COMMAND_BUFFER_LEVEL_PRIMARY);
     ~VulkanCommandBuffer();
 
     void Begin();
+    // Secondary command buffers only, records draws continuing the given render pass
+    void BeginSecondary(TPtr<VulkanRenderPass> renderPass, TPtr<VulkanFramebuffer> framebuffer);
     void End();
 
-    void BeginRenderPass(TPtr<VulkanRenderPass> renderPass, TPtr<VulkanFramebuffer> framebuffer, const VkRect2D& renderArea, const std::vector<VkClearValue>& clearColors);
+    // With VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS the pass may only be filled through ExecuteCommands
+    void BeginRenderPass(TPtr<VulkanRenderPass> renderPass, TPtr<VulkanFramebuffer> framebuffer, const VkRect2D& renderArea, const std::vector<VkClearValue>& clearColors, VkSubpassContents contents = VK_SUBPASS_CONTENTS_INLINE);
     void EndRenderPass();
 
+    void ExecuteCommands(const TPtrArr<VulkanCommandBuffer>& commandBufferArr);
+
     uint32_t GetExecuteCount();
 
     VkFence GetFence();
@@ -45,6 +50,7 @@ public:
 
 private:
     VkCommandBuffer _vkCommandBuffer;
+    VkCommandBufferLevel _level;
     VkFence _vkFence;
     EStatus _status;
     uint32_t _executeCount;
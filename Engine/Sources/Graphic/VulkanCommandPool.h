@@ -14,9 +14,12 @@ class VulkanCommandBuffer;
 class VulkanCommandPool
 {
 public:
-    VulkanCommandPool(TPtr<VulkanDevice> device, uint32_t queueFamilyIndex);
+    VulkanCommandPool(TPtr<VulkanDevice> device, uint32_t queueFamilyIndex, VkCommandPoolCreateFlags flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT);
     ~VulkanCommandPool();
 
+    // Recycles every command buffer allocated from this pool at once
+    void Reset();
+
     VkCommandPool GetRawCommandPool();
     TPtr<VulkanDevice> GetDevice();
 
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "CoreDefines.h"
+#include "CoreTypes.h"
+
+#include <vulkan/vulkan.h>
+
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+
+namespace ZE {
+
+class VulkanTimelineSemaphore;
+
+// Defers the destruction of GPU objects until no submitted work can use them anymore. An object released
+// while a frame is recorded is destroyed once the frame timeline reached that frame's value, and after its
+// own timeline value when it is also used on another queue. At most maxDeletionsPerTick objects are
+// destroyed per frame so large releases are spread out.
+class VulkanDeletionQueue
+{
+public:
+    typedef std::function<void()> Deleter;
+
+public:
+    VulkanDeletionQueue(TPtr<VulkanTimelineSemaphore> frameTimeline, uint32_t maxDeletionsPerTick);
+    ~VulkanDeletionQueue();
+
+    void Enqueue(Deleter deleter, TPtr<VulkanTimelineSemaphore> semaphore = nullptr, uint64_t value = 0);
+
+    // Frame boundary, objects released from now on belong to the frame signaling the given value
+    void Tick(uint64_t frameValue);
+    // Destroys everything right away, only valid once the device is idle
+    void Flush();
+
+    uint64_t GetFrameValue();
+    // True once everything enqueued up to the given frame has been destroyed
+    bool IsReleased(uint64_t frameValue);
+
+    uint32_t GetPendingCount();
+    uint64_t GetDeletionCount();
+
+private:
+    struct Entry
+    {
+        Deleter deleter;
+        uint64_t frameValue;
+        TPtr<VulkanTimelineSemaphore> semaphore;
+        uint64_t value;
+    };
+
+    TPtr<VulkanTimelineSemaphore> _frameTimeline;
+    uint32_t _maxDeletionsPerTick;
+
+    // Ordered by frame, entries whose timeline value is still pending are parked aside
+    std::deque<Entry> _entryQueue;
+    std::vector<Entry> _timelineEntryArr;
+
+    uint64_t _frameValue;
+    uint64_t _deletionCount;
+
+    std::mutex _mutex;
+};
+
+} // namespace ZE
\ No newline at end of file
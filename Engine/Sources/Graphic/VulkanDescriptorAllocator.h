@@ -0,0 +1,47 @@
+#pragma once
+
+#include "CoreDefines.h"
+#include "CoreTypes.h"
+
+#include <vulkan/vulkan.h>
+
+#include <mutex>
+
+
+namespace ZE {
+
+class VulkanDevice;
+class VulkanDescriptorPool;
+class VulkanDescriptorSet;
+class VulkanDescriptorSetLayout;
+
+
+// Allocates descriptor sets from a growing list of pools, a new pool is added once every pool is full.
+// Freed sets go back to their own pool, so the space of removed materials is reused by later ones.
+class VulkanDescriptorAllocator
+{
+public:
+    VulkanDescriptorAllocator(TPtr<VulkanDevice> device, const std::vector<VkDescriptorPoolSize>& descriptorPoolSizeArr, uint32_t maxSetsPerPool);
+    ~VulkanDescriptorAllocator();
+
+    TPtr<VulkanDescriptorSet> Allocate(TPtr<VulkanDescriptorSetLayout> descriptorSetLayout);
+
+    uint32_t GetPoolCount();
+    uint64_t GetAllocationCount();
+
+private:
+    TPtr<VulkanDescriptorPool> CreatePool();
+
+private:
+    TPtr<VulkanDevice> _device;
+    std::vector<VkDescriptorPoolSize> _descriptorPoolSizeArr;
+    uint32_t _maxSetsPerPool;
+
+    std::mutex _mutex;
+    TPtrArr<VulkanDescriptorPool> _poolArr;
+    // Pool the last allocation succeeded in, tried first
+    size_t _currentPoolIndex;
+    uint64_t _allocationCount;
+};
+
+} // namespace ZE
\ No newline at end of file
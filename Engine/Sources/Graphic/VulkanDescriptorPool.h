@@ -13,13 +13,16 @@ class VulkanDevice;
 class VulkanDescriptorPool
 {
 public:
-    VulkanDescriptorPool(TPtr<VulkanDevice> device, const std::vector<VkDescriptorPoolSize>& descriptorPoolSizeArr);
+    VulkanDescriptorPool(TPtr<VulkanDevice> device, const std::vector<VkDescriptorPoolSize>& descriptorPoolSizeArr, uint32_t maxSets = 2);
     ~VulkanDescriptorPool();
 
     TPtr<VulkanDevice> GetDevice();
 
     VkDescriptorPool GetRawDescriptorPool();
 
+    // Returns VK_ERROR_OUT_OF_POOL_MEMORY or VK_ERROR_FRAGMENTED_POOL once the pool is full
+    VkResult Allocate(VkDescriptorSetLayout vkDescriptorSetLayout, VkDescriptorSet& vkDescriptorSet);
+
 private:
     VkDescriptorPool _descriptorPool;
 
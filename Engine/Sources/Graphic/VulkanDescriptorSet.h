@@ -17,10 +17,12 @@ class VulkanDescriptorSet
 public:
 public:
     VulkanDescriptorSet(TPtr<VulkanDescriptorPool> descriptorPool, TPtr<VulkanDescriptorSetLayout> descriptorSetLayout);
+    // Takes ownership of a set already allocated from the pool
+    VulkanDescriptorSet(TPtr<VulkanDescriptorPool> descriptorPool, TPtr<VulkanDescriptorSetLayout> descriptorSetLayout, VkDescriptorSet vkDescriptorSet);
     ~VulkanDescriptorSet();
 
-    void Update(uint32_t binding, uint32_t arrayElement, const VkDescriptorBufferInfo& bufferInfo);
-    void Update(uint32_t binding, uint32_t arrayElement, const VkDescriptorImageInfo& imageInfo);
+    void Update(uint32_t binding, uint32_t arrayElement, const VkDescriptorBufferInfo& bufferInfo, VkDescriptorType descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER);
+    void Update(uint32_t binding, uint32_t arrayElement, const VkDescriptorImageInfo& imageInfo, VkDescriptorType descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER);
 
     const VkDescriptorSet& GetRawDescriptorSet();
 
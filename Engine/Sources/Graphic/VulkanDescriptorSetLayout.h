@@ -16,10 +16,14 @@ public:
     VulkanDescriptorSetLayout(TPtr<VulkanDevice> device, const std::vector<VkDescriptorSetLayoutBinding>& layoutBindings);
     ~VulkanDescriptorSetLayout();
 
+    // Equal for identically defined layouts, immutable samplers aren't used
+    uint64_t GetLayoutHash();
+
     VkDescriptorSetLayout GetRawDescriptorSetLayout();
 
 private:
     VkDescriptorSetLayout _vkDescriptorSetLayout;
+    uint64_t _layoutHash;
 
     TPtr<VulkanDevice> _device;
 };
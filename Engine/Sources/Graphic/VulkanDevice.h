@@ -6,11 +6,16 @@
 #include <GLFW/glfw3.h>
 #include <vulkan/vulkan.h>
 
+#include <functional>
+
 
 namespace ZE {
 
 class VulkanGPU;
 class VulkanSurface;
+class VulkanMemoryAllocator;
+class VulkanDeletionQueue;
+class VulkanTimelineSemaphore;
 
 class VulkanDevice
 {
@@ -27,6 +32,19 @@ public:
     void WaitIdle();
 
     TPtr<VulkanGPU> GetGPU();
+    TPtr<VulkanMemoryAllocator> GetMemoryAllocator();
+
+    void SetDeletionQueue(TPtr<VulkanDeletionQueue> deletionQueue);
+    TPtr<VulkanDeletionQueue> GetDeletionQueue();
+    // Runs the deleter once no submitted work can use the object anymore, right away without a deletion queue
+    void DeferDestruction(std::function<void()> deleter, TPtr<VulkanTimelineSemaphore> semaphore = nullptr, uint64_t value = 0);
+
+    bool IsSynchronization2Supported();
+    // Indirect draws may take their count from a buffer and start at any instance, needed for GPU generated draws
+    bool IsDrawIndirectCountSupported();
+    // Presents can carry an id and be waited on, see VK_KHR_present_wait
+    bool IsPresentWaitSupported();
+    VkResult WaitForPresent(VkSwapchainKHR swapchain, uint64_t presentId, uint64_t timeout);
 
     VkDevice GetRawDevice();
 
@@ -37,8 +55,14 @@ public:
 private:
     VkDevice _vkDevice;
     uint32_t _graphicQueueFamilyIndex, _computeQueueFamilyIndex, _transferQueueFamilyIndex;
+    bool _isSynchronization2Supported;
+    bool _isDrawIndirectCountSupported;
+    bool _isPresentWaitSupported;
+    PFN_vkWaitForPresentKHR _vkWaitForPresentKHR;
 
     TPtr<VulkanGPU> _GPU;
+    TPtr<VulkanMemoryAllocator> _memoryAllocator;
+    TPtr<VulkanDeletionQueue> _deletionQueue;
 };
 
 } // namespace ZE
\ No newline at end of file
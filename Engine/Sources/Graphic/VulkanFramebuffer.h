@@ -17,11 +17,18 @@ public:
     VulkanFramebuffer(TPtr<VulkanDevice> device, TPtr<VulkanRenderPass> renderPass, const TPtrArr<VulkanImageView>& imageViewArr, const VkExtent2D& extent);
     ~VulkanFramebuffer();
 
+    // False once any of the attached views has been destroyed
+    bool IsValid();
+    bool IsAttachedTo(const TPtrArr<VulkanImageView>& imageViewArr);
+
+    TPtr<VulkanRenderPass> GetRenderPass();
     VkFramebuffer GetRawFramebuffer();
 
 private:
     TPtr<VulkanDevice> _device;
-    TPtrArr<VulkanImageView> _imageViewArr;
+    TPtr<VulkanRenderPass> _renderPass;
+    // Weak so that a cached framebuffer never keeps its attachments alive
+    std::vector<TWeakPtr<VulkanImageView>> _imageViewArr;
 
     VkFramebuffer _vkFramebuffer;
 };
@@ -14,7 +14,7 @@ class VulkanDevice;
 class VulkanGPU
 {
 public:
-    VulkanGPU(const VkInstance& vkInstance);
+    VulkanGPU(const VkInstance& vkInstance, const std::vector<const char*>& deviceExtensions);
     ~VulkanGPU();
 
     const std::vector<const char*>& GetExtensions();
@@ -22,10 +22,13 @@ public:
     VkInstance GetVkInstance();
 
     std::vector<VkExtensionProperties> GetExtensionProperties(VkPhysicalDevice GPU);
+    bool IsExtensionSupported(const char* extensionName);
     std::vector<VkQueueFamilyProperties> GetQueueFamilyProperties();
+    VkPhysicalDeviceProperties GetProperties();
     bool isSurfaceSupported(uint32_t queueFamilyIndex, TPtr<VulkanSurface> surface);
 
     uint32_t FindMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties);
+    bool TryFindMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties, uint32_t& typeIndex);
 
 private:
     std::vector<VkPhysicalDevice> GetSupportedRawGPUs();
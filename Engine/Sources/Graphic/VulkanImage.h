@@ -2,6 +2,7 @@
 
 #include "CoreDefines.h"
 #include "CoreTypes.h"
+#include "VulkanMemoryAllocator.h"
 
 #include <vulkan/vulkan.h>
 
@@ -10,36 +11,56 @@ namespace ZE {
 class VulkanDevice;
 class VulkanCommandBuffer;
 class VulkanBuffer;
+class VulkanBufferManager;
+class VulkanTimelineSemaphore;
 
 class VulkanImage
 {
 public:
-    VulkanImage(TPtr<VulkanDevice> device, const VkExtent3D& extent, VkFormat format, VkImageUsageFlags usageFlags = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT);
+    // Lazily allocated memory is only a request, the image falls back to plain device local memory
+    // on devices that don't expose it, see IsLazilyAllocated.
+    VulkanImage(TPtr<VulkanDevice> device, const VkExtent3D& extent, VkFormat format, VkImageUsageFlags usageFlags = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, VkMemoryPropertyFlags memoryProperties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, EVulkanMemoryCategory category = EVulkanMemoryCategory::Texture, uint32_t mipLevels = 1);
     VulkanImage(TPtr<VulkanDevice> device, VkImage vkImage, const VkExtent3D& extent, VkFormat format, VkImageUsageFlags usageFlags = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT);
     ~VulkanImage();
 
     void TransitionLayout(TPtr<VulkanCommandBuffer> commandBuffer, VkImageLayout oldLayout, VkImageLayout newLayout);
-    void CopyFromBuffer(TPtr<VulkanCommandBuffer> commandBuffer, TPtr<VulkanBuffer> buffer, VkOffset3D offset, VkExtent3D extent);
-    void TransferData(TPtr<VulkanCommandBuffer> commandBuffer, TPtr<VulkanBuffer> stagingBuffer, const void* data, uint32_t size);
+    void CopyFromBuffer(TPtr<VulkanCommandBuffer> commandBuffer, TPtr<VulkanBuffer> buffer, VkOffset3D offset, VkExtent3D extent, VkDeviceSize bufferOffset = 0);
+    void CopyToBuffer(TPtr<VulkanCommandBuffer> commandBuffer, TPtr<VulkanBuffer> buffer, VkOffset3D offset, VkExtent3D extent);
+    void TransferData(TPtr<VulkanCommandBuffer> commandBuffer, TPtr<VulkanBufferManager> bufferManager, const void* data, uint32_t size);
 
     void SetLayout(VkImageLayout layout);
     VkImageLayout GetLayout();
 
     VkExtent3D GetExtent();
     VkFormat GetFormat();
+    VkImageUsageFlags GetUsage();
+    uint32_t GetMipLevels();
+    bool IsLazilyAllocated();
 
     TPtr<VulkanDevice> GetDevice();
 
+    // Work on another queue signaling the value uses the image, its destruction waits for it too
+    void SetTimelineUse(TPtr<VulkanTimelineSemaphore> semaphore, uint64_t value);
+
     VkImage GetRawImage();
 
+    // Stages and accesses an image in the given layout is used by, the conservative side of a barrier
+    static void GetLayoutUsage(VkImageLayout layout, VkPipelineStageFlags& stageMask, VkAccessFlags& accessMask);
+    static VkImageAspectFlags GetAspectMask(VkFormat format);
+
 private:
     bool _hasOwnship;
     VkExtent3D _extent;
     VkFormat _format;
+    VkImageUsageFlags _usageFlags;
+    uint32_t _mipLevels;
+    VkMemoryPropertyFlags _memoryProperties;
     VkImageLayout _layout;
 
     VkImage _vkImage;
-    VkDeviceMemory _vkMemory;
+    VulkanMemoryAllocation _allocation;
+    TPtr<VulkanTimelineSemaphore> _timelineSemaphore;
+    uint64_t _timelineValue;
 
     TPtr<VulkanDevice> _device;
 };
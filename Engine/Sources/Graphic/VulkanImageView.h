@@ -13,7 +13,7 @@ class VulkanImage;
 class VulkanImageView
 {
 public:
-    VulkanImageView(TPtr<VulkanImage> image, VkFormat format = VkFormat::VK_FORMAT_UNDEFINED, VkImageAspectFlagBits accessFlags = VkImageAspectFlagBits::VK_IMAGE_ASPECT_COLOR_BIT);
+    VulkanImageView(TPtr<VulkanImage> image, VkFormat format = VkFormat::VK_FORMAT_UNDEFINED, VkImageAspectFlagBits accessFlags = VkImageAspectFlagBits::VK_IMAGE_ASPECT_COLOR_BIT, uint32_t baseMipLevel = 0, uint32_t levelCount = 1);
     ~VulkanImageView();
 
     TPtr<VulkanImage> GetImage();
@@ -0,0 +1,157 @@
+#pragma once
+
+#include "CoreDefines.h"
+#include "CoreTypes.h"
+
+#include <vulkan/vulkan.h>
+
+#include <mutex>
+#include <vector>
+
+
+namespace ZE {
+
+class VulkanGPU;
+class VulkanMemoryBlock;
+
+enum class EVulkanMemoryUsage : uint8_t
+{
+    // Buffers and linear images
+    Linear,
+    // Optimal tiling images, kept in their own blocks so they never share a granularity page with linear resources
+    Optimal,
+    // Short lived buffers, bump allocated and only recycled once every allocation of their block is freed
+    Transient,
+};
+
+enum class EVulkanMemoryCategory : uint8_t
+{
+    Other,
+    Mesh,
+    Texture,
+    Staging,
+    RenderTarget,
+    Uniform,
+
+    Count,
+};
+
+struct VulkanMemoryAllocation
+{
+    VkDeviceMemory memory;
+    VkDeviceSize offset;
+    VkDeviceSize size;
+    uint32_t memoryTypeIndex;
+    EVulkanMemoryCategory category;
+    // nullptr unless the memory type is host visible, blocks stay mapped for their whole life
+    void* mappedAddress;
+
+    VulkanMemoryBlock* block;
+    // Block specific, the TLSF node or the linear offset
+    uint64_t handle;
+};
+
+struct VulkanMemoryStats
+{
+    uint32_t blockCount;
+    uint32_t dedicatedCount;
+    uint32_t allocationCount;
+    // Device memory reserved from the driver and the part of it handed out
+    VkDeviceSize reservedSize;
+    VkDeviceSize usedSize;
+};
+
+struct VulkanMemoryCategoryStats
+{
+    uint32_t allocationCount;
+    VkDeviceSize usedSize;
+};
+
+struct VulkanMemoryHeapStats
+{
+    VkDeviceSize size;
+    VkDeviceSize reservedSize;
+    VkDeviceSize usedSize;
+    // Reported by VK_EXT_memory_budget when available, estimated from the heap size and our own blocks otherwise
+    VkDeviceSize budget;
+    VkDeviceSize usage;
+};
+
+// Sub-allocates buffers and images from large device memory blocks, one set of blocks per memory type
+// and usage. General blocks use a two level segregated fit allocator, transient ones a linear one.
+// Resources larger than half a block and lazily allocated images get a dedicated allocation.
+class VulkanMemoryAllocator
+{
+public:
+    VulkanMemoryAllocator(VkDevice vkDevice, TPtr<VulkanGPU> GPU, bool isBudgetSupported);
+    ~VulkanMemoryAllocator();
+
+    // Prefers the type with the fewest properties beyond the required ones whose heap still has budget left
+    uint32_t FindMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties);
+    bool TryFindMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties, uint32_t& typeIndex);
+
+    VulkanMemoryAllocation Allocate(const VkMemoryRequirements& requirements, uint32_t memoryTypeIndex, EVulkanMemoryUsage usage, EVulkanMemoryCategory category);
+    void Free(VulkanMemoryAllocation& allocation);
+    // False when Allocate would have to create a block for the request
+    bool CanAllocateFromExistingBlock(const VkMemoryRequirements& requirements, uint32_t memoryTypeIndex, EVulkanMemoryUsage usage);
+
+    // Queries the driver budget, warns once per heap when its usage gets close to the budget
+    void UpdateBudget();
+
+    // A block is worth evacuating when it is sparsely used and its pool has other blocks to move into
+    bool IsEvacuationCandidate(VulkanMemoryBlock* block, float& usageRatio);
+    // Allocations avoid the evacuated block until the evacuation ends or the block is released
+    void BeginEvacuation(VulkanMemoryBlock* block);
+    void EndEvacuation();
+
+    VulkanMemoryStats GetStats();
+    VulkanMemoryCategoryStats GetCategoryStats(EVulkanMemoryCategory category);
+    uint32_t GetHeapCount();
+    VulkanMemoryHeapStats GetHeapStats(uint32_t heapIndex);
+
+    VkDeviceSize GetPreferredBlockSize(uint32_t memoryTypeIndex);
+
+    static const char* GetCategoryName(EVulkanMemoryCategory category);
+
+private:
+    VulkanMemoryBlock* CreateBlock(uint32_t memoryTypeIndex, VkDeviceSize size, EVulkanMemoryUsage usage, bool isDedicated);
+    void DestroyBlock(VulkanMemoryBlock* block);
+
+    VkDeviceSize GetHeapUsage(uint32_t heapIndex);
+    bool IsHeapOverBudget(uint32_t heapIndex, VkDeviceSize size);
+    void CheckBudget(uint32_t heapIndex);
+
+private:
+    struct HeapState
+    {
+        VkDeviceSize reservedSize;
+        VkDeviceSize usedSize;
+        VkDeviceSize budget;
+        // Driver reported usage at the last budget update, our own reserved size covers the changes since
+        VkDeviceSize driverUsage;
+        VkDeviceSize reservedSizeAtUpdate;
+        bool isWarned;
+    };
+
+    VkDevice _vkDevice;
+    VkPhysicalDevice _vkPhysicalDevice;
+    VkPhysicalDeviceMemoryProperties _memoryProperties;
+    VkDeviceSize _bufferImageGranularity;
+    bool _isBudgetSupported;
+
+    // Indexed by memory type then usage
+    std::vector<std::vector<VulkanMemoryBlock*>> _blockArr;
+    std::vector<VulkanMemoryBlock*> _dedicatedBlockArr;
+    VulkanMemoryBlock* _evacuatingBlock;
+
+    std::vector<HeapState> _heapArr;
+    VulkanMemoryCategoryStats _categoryStats[static_cast<size_t>(EVulkanMemoryCategory::Count)];
+
+    uint32_t _allocationCount;
+    VkDeviceSize _reservedSize;
+    VkDeviceSize _usedSize;
+
+    std::mutex _mutex;
+};
+
+} // namespace ZE
\ No newline at end of file
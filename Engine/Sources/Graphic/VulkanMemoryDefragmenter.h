@@ -0,0 +1,67 @@
+#pragma once
+
+#include "CoreDefines.h"
+#include "CoreTypes.h"
+
+#include <vulkan/vulkan.h>
+
+
+namespace ZE {
+
+class VulkanDevice;
+class VulkanQueue;
+class VulkanBuffer;
+class VulkanMemoryBlock;
+class VulkanCommandPool;
+class VulkanCommandBuffer;
+
+// Incrementally compacts device memory by moving registered buffers out of sparsely used blocks.
+// Every Tick is a frame boundary: a finished batch of copies is committed by swapping the buffers'
+// storage, the old storage goes through the device's deletion queue and a new batch is started once
+// it is actually destroyed. Only buffers whose raw handle is fetched at record time may be registered.
+class VulkanMemoryDefragmenter
+{
+public:
+    VulkanMemoryDefragmenter(TPtr<VulkanDevice> device, TPtr<VulkanQueue> queue, VkDeviceSize maxMoveSizePerTick);
+    ~VulkanMemoryDefragmenter();
+
+    // The buffer needs VK_BUFFER_USAGE_TRANSFER_SRC_BIT, it is forgotten once released
+    void Register(TPtr<VulkanBuffer> buffer);
+
+    void Tick();
+
+    uint32_t GetMoveCount();
+    VkDeviceSize GetMovedSize();
+
+private:
+    struct Move
+    {
+        TPtr<VulkanBuffer> buffer;
+        TPtr<VulkanBuffer> destination;
+    };
+
+    void CommitMoves();
+    void BeginMoves();
+
+private:
+    TPtr<VulkanDevice> _device;
+    TPtr<VulkanQueue> _queue;
+    TPtr<VulkanCommandPool> _commandPool;
+    TPtr<VulkanCommandBuffer> _commandBuffer;
+    VkFence _fence;
+
+    VkDeviceSize _maxMoveSizePerTick;
+
+    std::vector<TWeakPtr<VulkanBuffer>> _bufferArr;
+    std::vector<Move> _pendingMoveArr;
+    bool _isEvacuating;
+    // Frame value the last batch of old storage was released in
+    uint64_t _commitFrameValue;
+
+    uint64_t _tickCount;
+    uint64_t _nextSearchTick;
+    uint32_t _moveCount;
+    VkDeviceSize _movedSize;
+};
+
+} // namespace ZE
\ No newline at end of file
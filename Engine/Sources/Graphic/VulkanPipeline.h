@@ -17,7 +17,7 @@ class VulkanRenderPass;
 class VulkanGraphicPipeline
 {
 public:
-    VulkanGraphicPipeline(TPtr<VulkanDevice> device, const RHIPipelineState& state, TPtr<VulkanRenderPass> renderPass);
+    VulkanGraphicPipeline(TPtr<VulkanDevice> device, const RHIPipelineState& state, TPtr<VulkanRenderPass> renderPass, VkPipelineCache pipelineCache = VK_NULL_HANDLE);
     ~VulkanGraphicPipeline();
 
     VkPipeline GetRawPipeline();
@@ -29,4 +29,21 @@ private:
     TPtr<VulkanRenderPass> _renderPass;
 };
 
+class VulkanComputePipeline
+{
+public:
+    VulkanComputePipeline(TPtr<VulkanDevice> device, TPtr<VulkanShader> shader, TPtr<VulkanPipelineLayout> layout, VkPipelineCache pipelineCache = VK_NULL_HANDLE);
+    ~VulkanComputePipeline();
+
+    VkPipeline GetRawPipeline();
+    TPtr<VulkanPipelineLayout> GetLayout();
+
+private:
+    VkPipeline _vkPipeline;
+
+    TPtr<VulkanDevice> _device;
+    TPtr<VulkanShader> _shader;
+    TPtr<VulkanPipelineLayout> _layout;
+};
+
 } // namespace ZE
\ No newline at end of file
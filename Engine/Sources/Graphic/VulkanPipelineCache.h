@@ -0,0 +1,42 @@
+#pragma once
+
+#include "CoreDefines.h"
+#include "CoreTypes.h"
+
+#include <vulkan/vulkan.h>
+
+#include <filesystem>
+
+
+namespace ZE {
+
+class VulkanDevice;
+
+// Driver pipeline cache persisted to disk. A file written by another driver or device is ignored.
+class VulkanPipelineCache
+{
+public:
+    VulkanPipelineCache(TPtr<VulkanDevice> device, const std::filesystem::path& path);
+    ~VulkanPipelineCache();
+
+    // Writes the cache to its file when it has grown since the last save
+    bool Save();
+
+    bool IsLoadedFromDisk();
+
+    VkPipelineCache GetRawPipelineCache();
+
+private:
+    bool IsCompatible(const std::vector<char>& data);
+
+private:
+    TPtr<VulkanDevice> _device;
+
+    std::filesystem::path _path;
+    size_t _savedSize;
+    bool _isLoadedFromDisk;
+
+    VkPipelineCache _vkPipelineCache;
+};
+
+} // namespace ZE
\ No newline at end of file
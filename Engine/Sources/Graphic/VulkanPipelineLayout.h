@@ -14,13 +14,17 @@ class VulkanDescriptorSetLayout;
 class VulkanPipelineLayout
 {
 public:
-    VulkanPipelineLayout(TPtr<VulkanDevice> device, TPtrArr<VulkanDescriptorSetLayout>& descriptorSetLayoutArr);
+    VulkanPipelineLayout(TPtr<VulkanDevice> device, TPtrArr<VulkanDescriptorSetLayout>& descriptorSetLayoutArr, const std::vector<VkPushConstantRange>& pushConstantRangeArr = {});
     ~VulkanPipelineLayout();
 
+    // Equal for identically defined layouts, which pipelines and descriptor sets may be used with interchangeably
+    uint64_t GetLayoutHash();
+
     VkPipelineLayout GetRawPipelineLayout();
 
 private:
     VkPipelineLayout _vkPipelineLayout;
+    uint64_t _layoutHash;
 
     TPtrArr<VulkanDescriptorSetLayout> _descriptorSetLayoutArr;
     TPtr<VulkanDevice> _device;
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "CoreDefines.h"
+#include "CoreTypes.h"
+
+#include <vulkan/vulkan.h>
+
+
+namespace ZE {
+
+class VulkanDevice;
+class VulkanCommandBuffer;
+
+class VulkanQueryPool
+{
+public:
+    VulkanQueryPool(TPtr<VulkanDevice> device, VkQueryType queryType, uint32_t queryCount);
+    ~VulkanQueryPool();
+
+    void Reset(TPtr<VulkanCommandBuffer> commandBuffer, uint32_t firstQuery, uint32_t queryCount);
+    void WriteTimestamp(TPtr<VulkanCommandBuffer> commandBuffer, VkPipelineStageFlagBits stage, uint32_t query);
+
+    // Never waits, returns false when any of the queries is not available yet
+    bool GetResults(uint32_t firstQuery, uint32_t queryCount, std::vector<uint64_t>& results);
+
+    uint32_t GetQueryCount();
+
+    VkQueryPool GetRawQueryPool();
+    TPtr<VulkanDevice> GetDevice();
+
+private:
+    TPtr<VulkanDevice> _device;
+
+    VkQueryType _queryType;
+    uint32_t _queryCount;
+    VkQueryPool _vkQueryPool;
+};
+
+}
\ No newline at end of file
@@ -12,6 +12,22 @@ class VulkanDevice;
 class VulkanCommandBuffer;
 class VulkanSwapchain;
 
+// A semaphore wait or signal of a submission, the value only matters for timeline semaphores
+struct VulkanSemaphoreSubmit
+{
+    VkSemaphore semaphore;
+    uint64_t value;
+    VkPipelineStageFlags2 stageMask;
+};
+
+// One submission, its command buffers start in order
+struct VulkanSubmitBatch
+{
+    TPtrArr<VulkanCommandBuffer> commandBufferArr;
+    std::vector<VulkanSemaphoreSubmit> waitArr;
+    std::vector<VulkanSemaphoreSubmit> signalArr;
+};
+
 class VulkanQueue
 {
 public:
@@ -29,7 +45,10 @@ public:
     ~VulkanQueue();
 
     void Submit(TPtr<VulkanCommandBuffer> commandBuffer, const std::vector<VkSemaphore>& waitSemaphoreArr, const std::vector<VkPipelineStageFlags>& waitStageArr, const std ::vector<VkSemaphore>& signalSemaphoreArr, VkFence fence);
-    void Present(TPtr<VulkanSwapchain> swapchain, const std::vector<VkSemaphore>& waitSemaphoreArr);
+    // All batches go out in a single call, through vkQueueSubmit2 when the device supports it
+    void Submit(const std::vector<VulkanSubmitBatch>& batchArr, VkFence fence = VK_NULL_HANDLE);
+    // A non zero present id can be waited on with VulkanSwapchain::WaitForPresent
+    void Present(TPtr<VulkanSwapchain> swapchain, const std::vector<VkSemaphore>& waitSemaphoreArr, uint64_t presentId = 0);
 
     void WaitIdle();
 
@@ -38,6 +57,10 @@ public:
 
     VkQueue GetRawQueue();
 
+private:
+    void SubmitSynchronization2(const std::vector<VulkanSubmitBatch>& batchArr, VkFence fence);
+    void SubmitLegacy(const std::vector<VulkanSubmitBatch>& batchArr, VkFence fence);
+
 private:
     uint32_t _familyIndex;
     EType _type;
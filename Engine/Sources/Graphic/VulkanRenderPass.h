@@ -17,10 +17,17 @@ public:
     VulkanRenderPass(TPtr<VulkanDevice> device, const VkAttachmentDescription& depthAttachment);
     ~VulkanRenderPass();
 
+    // Equal for render passes a pipeline can be used with interchangeably: same attachment formats and sample counts
+    uint64_t GetCompatibilityHash();
+
     VkRenderPass GetRawRenderPass();
 
+private:
+    static uint64_t ComputeCompatibilityHash(const std::vector<VkAttachmentDescription>& colorAttachmentDescriptionArr, const VkAttachmentDescription* depthAttachment);
+
 private:
     TPtr<VulkanDevice> _device;
+    uint64_t _compatibilityHash;
 
     VkRenderPass _vkRenderPass;
 };
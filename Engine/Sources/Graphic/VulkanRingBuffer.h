@@ -0,0 +1,53 @@
+#pragma once
+
+#include "CoreDefines.h"
+#include "CoreTypes.h"
+
+#include <vulkan/vulkan.h>
+
+#include <mutex>
+
+namespace ZE {
+
+class VulkanDevice;
+class VulkanBuffer;
+
+// Persistently mapped host visible buffer with one region per frame in flight. Allocations are bump
+// allocated from the current region and stay valid until that region is begun again, which must only
+// happen once the GPU is done with the frame that used it.
+class VulkanRingBuffer
+{
+public:
+    VulkanRingBuffer(TPtr<VulkanDevice> device, uint32_t regionSize, uint32_t regionCount, VkBufferUsageFlags usage, uint32_t alignment);
+    ~VulkanRingBuffer();
+
+    void BeginRegion(uint32_t regionIndex);
+
+    // Both return the offset of the allocation from the start of the buffer, safe to call from any thread
+    uint32_t Allocate(uint32_t size, void*& mappedAddress);
+    uint32_t Write(const void* data, uint32_t size);
+
+    // Offsets of consecutive elements packed into one allocation have to be multiples of it
+    uint32_t GetAlignment();
+    uint32_t GetRegionSize();
+    uint32_t GetUsedSize();
+    uint32_t GetPeakUsedSize();
+
+    TPtr<VulkanBuffer> GetBuffer();
+
+private:
+    TPtr<VulkanBuffer> _buffer;
+    uint8_t* _mappedAddress;
+
+    uint32_t _regionSize;
+    uint32_t _regionCount;
+    uint32_t _alignment;
+
+    uint32_t _regionBegin;
+    uint32_t _head;
+    uint32_t _peakUsedSize;
+
+    std::mutex _mutex;
+};
+
+} // namespace ZE
\ No newline at end of file
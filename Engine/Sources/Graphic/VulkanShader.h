@@ -15,10 +15,14 @@ public:
     VulkanShader(TPtr<VulkanDevice> device, const std::vector<char>& byteCode);
     ~VulkanShader();
 
+    // Hash of the SPIR-V, equal for modules created from the same code
+    uint64_t GetCodeHash();
+
     VkShaderModule GetRawShader();
 
 private:
     TPtr<VulkanDevice> _device;
+    uint64_t _codeHash;
 
     VkShaderModule _vkShaderModule;
 };
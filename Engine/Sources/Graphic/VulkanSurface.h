@@ -30,6 +30,8 @@ public:
     std::vector<VkPresentModeKHR> GetSupportedPresentModes(TPtr<VulkanGPU> GPU);
     VkSurfaceCapabilitiesKHR GetCpabilities(TPtr<VulkanGPU> GPU);
 
+    static const char* GetPresentModeName(VkPresentModeKHR presentMode);
+
 private:
     VkInstance _vkInstance;
     VkSurfaceKHR _vkSurface;
@@ -11,15 +11,24 @@ namespace ZE {
 class VulkanSurface;
 class VulkanDevice;
 class VulkanImage;
+class VulkanImageView;
 
 class VulkanSwapchain
 {
 public:
+    // The image count is clamped to what the surface allows
     VulkanSwapchain(TPtr<VulkanDevice> device, TPtr<VulkanSurface> surface, uint32_t imageCount);
     ~VulkanSwapchain();
 
     uint32_t GetCurrentAcquiredIndex();
+    // nullptr when no image became available within timeout, throws when the swapchain can no longer be used
     TPtr<VulkanImage> AcquireNextImage(uint64_t timeout, VkSemaphore semaphore, VkFence fence);
+    // Views live as long as the swapchain, so framebuffers built on them can be cached
+    TPtr<VulkanImageView> GetImageView(uint32_t index);
+    uint32_t GetImageCount();
+
+    // Returns false on timeout or when present wait isn't supported
+    bool WaitForPresent(uint64_t presentId, uint64_t timeout);
 
     VkSwapchainKHR GetRawSwapchain();
 
@@ -30,6 +39,7 @@ private:
     TPtr<VulkanDevice> _device;
     TPtr<VulkanSurface> _surface;
     TPtrArr<VulkanImage> _imagerArr;
+    TPtrArr<VulkanImageView> _imageViewArr;
 };
 
 } // namespace ZE
\ No newline at end of file
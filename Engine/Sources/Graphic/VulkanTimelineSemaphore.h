@@ -0,0 +1,33 @@
+#pragma once
+
+#include "CoreDefines.h"
+#include "CoreTypes.h"
+
+#include <vulkan/vulkan.h>
+
+
+namespace ZE {
+
+class VulkanDevice;
+
+// A semaphore carrying a monotonically increasing value, queues signal and wait on values and the host can
+// poll or wait on them without a fence per submission.
+class VulkanTimelineSemaphore
+{
+public:
+    VulkanTimelineSemaphore(TPtr<VulkanDevice> device, uint64_t initialValue = 0);
+    ~VulkanTimelineSemaphore();
+
+    uint64_t GetCompletedValue();
+    // Returns false on timeout
+    bool Wait(uint64_t value, uint64_t timeout = UINT64_MAX);
+
+    VkSemaphore GetRawSemaphore();
+
+private:
+    VkSemaphore _vkSemaphore;
+
+    TPtr<VulkanDevice> _device;
+};
+
+} // namespace ZE
\ No newline at end of file
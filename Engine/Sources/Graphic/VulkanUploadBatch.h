@@ -0,0 +1,96 @@
+#pragma once
+
+#include "CoreDefines.h"
+#include "CoreTypes.h"
+
+#include "VulkanBufferManager.h"
+
+#include <vulkan/vulkan.h>
+
+#include <vector>
+
+
+namespace ZE {
+
+class VulkanBuffer;
+class VulkanImage;
+class VulkanCommandBuffer;
+
+// The acquire half of the queue family ownership transfers released by a flush
+struct VulkanUploadAcquire
+{
+    std::vector<VkBufferMemoryBarrier> bufferBarrierArr;
+    std::vector<VkImageMemoryBarrier> imageBarrierArr;
+    VkPipelineStageFlags dstStageMask = 0;
+
+    // Destinations of the flush, kept alive until the copies are known to be complete
+    TPtrArr<VulkanBuffer> bufferArr;
+    TPtrArr<VulkanImage> imageArr;
+};
+
+// Collects uploads and records them together: the data is packed into a single staging allocation,
+// every destination buffer gets one copy command with all its regions, and the image layout
+// transitions share one barrier before and one after the copies. The source data is only read
+// in Flush and must stay valid until then.
+class VulkanUploadBatch
+{
+public:
+    VulkanUploadBatch(TPtr<VulkanBufferManager> bufferManager);
+    ~VulkanUploadBatch();
+
+    void UploadBuffer(TPtr<VulkanBuffer> buffer, const void* data, VkDeviceSize size, VkDeviceSize dstOffset = 0);
+    // Uploads the whole first mip level, the previous content is discarded
+    void UploadImage(TPtr<VulkanImage> image, const void* data, VkDeviceSize size, VkImageLayout finalLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+
+    // Uploads recorded on a queue of another family than the one using the resources end with release barriers,
+    // the matching acquires are collected for TakeAcquire along with the destinations of every flush
+    void SetQueueFamilyTransfer(uint32_t srcQueueFamilyIndex, uint32_t dstQueueFamilyIndex);
+
+    void Flush(TPtr<VulkanCommandBuffer> commandBuffer);
+    // Uses the given staging memory instead of the buffer manager's ring, it needs GetPendingSize bytes
+    void Flush(TPtr<VulkanCommandBuffer> commandBuffer, const StagingAllocation& staging);
+
+    VulkanUploadAcquire TakeAcquire();
+    // Records the acquires of any number of flushes with a single barrier
+    static void RecordAcquire(TPtr<VulkanCommandBuffer> commandBuffer, const std::vector<VulkanUploadAcquire>& acquireArr);
+
+    bool IsEmpty();
+    VkDeviceSize GetPendingSize();
+
+    uint32_t GetCopyCommandCount();
+    uint32_t GetBarrierCommandCount();
+    VkDeviceSize GetUploadedSize();
+
+private:
+    struct BufferUpload
+    {
+        TPtr<VulkanBuffer> buffer;
+        const void* data;
+        VkDeviceSize size;
+        VkDeviceSize dstOffset;
+    };
+
+    struct ImageUpload
+    {
+        TPtr<VulkanImage> image;
+        const void* data;
+        VkDeviceSize size;
+        VkImageLayout finalLayout;
+    };
+
+private:
+    TPtr<VulkanBufferManager> _bufferManager;
+    uint32_t _srcQueueFamilyIndex;
+    uint32_t _dstQueueFamilyIndex;
+    VulkanUploadAcquire _acquire;
+
+    std::vector<BufferUpload> _bufferUploadArr;
+    std::vector<ImageUpload> _imageUploadArr;
+    VkDeviceSize _pendingSize;
+
+    uint32_t _copyCommandCount;
+    uint32_t _barrierCommandCount;
+    VkDeviceSize _uploadedSize;
+};
+
+} // namespace ZE
\ No newline at end of file
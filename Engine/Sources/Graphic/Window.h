@@ -4,6 +4,7 @@
 #include "CoreTypes.h"
 
 #include <glm/glm.hpp>
+#include <vulkan/vulkan.h>
 
 #include <string>
 
@@ -23,7 +24,8 @@ public:
     Window(const std::string& title, const glm::ivec2& size);
     ~Window();
 
-    void CreateSurfaceAndSwapchain(TPtr<VulkanDevice> device);
+    // Falls back to FIFO when the present mode isn't supported
+    void CreateSurfaceAndSwapchain(TPtr<VulkanDevice> device, VkPresentModeKHR presentMode = VK_PRESENT_MODE_MAILBOX_KHR, uint32_t imageCount = 3);
 
     bool ShouldClose();
 
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "CoreDefines.h"
+#include "CoreTypes.h"
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+
+namespace ZE {
+
+struct Job;
+
+// Chase-Lev work stealing deque. The owning thread pushes and pops at the bottom, any other thread steals
+// from the top. The capacity is fixed, a full queue refuses the push and the owner runs the job itself.
+class JobQueue
+{
+public:
+    // Rounded up to a power of two
+    JobQueue(uint32_t capacity);
+    ~JobQueue();
+
+    // Owner only
+    bool Push(Job* job);
+    Job* Pop();
+
+    // Any thread, nullptr when empty or when another thread won the race
+    Job* Steal();
+
+    // Approximate when read from another thread
+    uint32_t GetSize();
+
+private:
+    std::vector<std::atomic<Job*>> _buffer;
+    int64_t _mask;
+
+    // On separate cache lines, the owner hammers the bottom and thieves the top
+    alignas(64) std::atomic<int64_t> _top;
+    alignas(64) std::atomic<int64_t> _bottom;
+};
+
+} // namespace ZE
\ No newline at end of file
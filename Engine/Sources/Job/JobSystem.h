@@ -0,0 +1,108 @@
+#pragma once
+
+#include "CoreDefines.h"
+#include "CoreTypes.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+namespace ZE {
+
+class JobQueue;
+
+// Jobs run against a counter are joined by waiting on it, a counter can be reused once it is done
+class JobCounter
+{
+public:
+    JobCounter();
+
+    bool IsDone();
+
+private:
+    friend class JobSystem;
+
+    std::atomic<uint32_t> _pendingCount;
+};
+
+struct Job
+{
+    std::function<void()> function;
+    JobCounter* counter;
+};
+
+// Work stealing job system. Every worker owns a JobQueue and the thread that initialized the system gets one
+// as well; a thread runs its own jobs newest first and steals the oldest job of a random victim when it runs
+// dry. Jobs scheduled from any other thread go through a shared queue. Waiting on a counter runs jobs until
+// the counter is done, so jobs may schedule and wait on jobs of their own. Threads without a queue only help
+// with shared jobs, jobs scheduled by a queue owning thread always run on one of those threads.
+class JobSystem
+{
+public:
+    // 0 workers uses one per CPU the process may run on besides the calling thread, pinned workers stay on
+    // one of those CPUs each
+    static void Initialize(uint32_t workerCount = 0, bool isAffinityEnabled = true);
+    static void Cleanup();
+    static JobSystem& Get();
+
+private:
+    JobSystem(uint32_t workerCount, bool isAffinityEnabled);
+    ~JobSystem();
+
+public:
+    void Run(std::function<void()> function, JobCounter* counter = nullptr);
+    void Wait(JobCounter& counter);
+
+    // Calls function on disjoint [begin, end) ranges covering [0, count) and returns once all are done.
+    // The grain is derived from the count and the number of queues, never below minGrainSize, and a range
+    // is only split in halves while the local queue has nothing left for thieves, so an even load is
+    // barely split and an uneven one keeps being rebalanced.
+    void ParallelFor(size_t count, const std::function<void(size_t begin, size_t end)>& function, size_t minGrainSize = 1);
+
+    uint32_t GetWorkerCount();
+    // Queue owning threads, the initializing one included
+    uint32_t GetThreadCount();
+    // In [0, GetThreadCount()) on queue owning threads, 0 for the initializing one, UINT32_MAX on any other
+    uint32_t GetThreadIndex();
+    uint64_t GetJobCount();
+    uint64_t GetStealCount();
+
+private:
+    void WorkerMain(uint32_t queueIndex, int32_t cpu);
+    Job* FindJob();
+    void Execute(Job* job);
+    void WakeWorkers();
+    bool IsStarving();
+    void RunRange(size_t begin, size_t end, const std::function<void(size_t, size_t)>& function, size_t grainSize, JobCounter& counter);
+
+private:
+    static JobSystem* _instance;
+
+    // Index 0 belongs to the initializing thread
+    std::vector<std::unique_ptr<JobQueue>> _queueArr;
+    std::vector<std::thread> _workerArr;
+
+    // Jobs from threads without a queue of their own
+    std::mutex _sharedMutex;
+    std::deque<Job*> _sharedJobQueue;
+    std::atomic<uint32_t> _sharedJobCount;
+
+    // Bumped on every push, a worker only goes to sleep if it didn't change since it last looked for work
+    std::atomic<uint64_t> _workEpoch;
+    std::atomic<uint32_t> _sleepingCount;
+    std::mutex _sleepMutex;
+    std::condition_variable _sleepCondition;
+    std::atomic<bool> _isStopping;
+
+    std::atomic<uint64_t> _jobCount;
+    std::atomic<uint64_t> _stealCount;
+};
+
+} // namespace ZE
\ No newline at end of file
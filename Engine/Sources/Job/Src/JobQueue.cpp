@@ -0,0 +1,84 @@
+#include "JobQueue.h"
+
+#include <algorithm>
+#include <bit>
+
+
+namespace ZE {
+
+JobQueue::JobQueue(uint32_t capacity)
+    : _buffer(std::bit_ceil(std::max(capacity, 2u))), _top(0), _bottom(0)
+{
+    _mask = static_cast<int64_t>(_buffer.size()) - 1;
+}
+
+JobQueue::~JobQueue()
+{
+}
+
+bool JobQueue::Push(Job* job)
+{
+    int64_t bottom = _bottom.load(std::memory_order_relaxed);
+    int64_t top = _top.load(std::memory_order_acquire);
+    if (bottom - top > _mask)
+        return false;
+
+    _buffer[bottom & _mask].store(job, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    _bottom.store(bottom + 1, std::memory_order_relaxed);
+
+    return true;
+}
+
+Job* JobQueue::Pop()
+{
+    int64_t bottom = _bottom.load(std::memory_order_relaxed) - 1;
+    _bottom.store(bottom, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t top = _top.load(std::memory_order_relaxed);
+
+    if (top > bottom)
+    {
+        _bottom.store(bottom + 1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    Job* job = _buffer[bottom & _mask].load(std::memory_order_relaxed);
+
+    // The last job, thieves may be after it as well
+    if (top == bottom)
+    {
+        if (!_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            job = nullptr;
+
+        _bottom.store(bottom + 1, std::memory_order_relaxed);
+    }
+
+    return job;
+}
+
+Job* JobQueue::Steal()
+{
+    int64_t top = _top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t bottom = _bottom.load(std::memory_order_acquire);
+
+    if (top >= bottom)
+        return nullptr;
+
+    Job* job = _buffer[top & _mask].load(std::memory_order_relaxed);
+    if (!_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+        return nullptr;
+
+    return job;
+}
+
+uint32_t JobQueue::GetSize()
+{
+    int64_t bottom = _bottom.load(std::memory_order_relaxed);
+    int64_t top = _top.load(std::memory_order_relaxed);
+
+    return bottom > top ? static_cast<uint32_t>(bottom - top) : 0;
+}
+
+} // namespace ZE
\ No newline at end of file
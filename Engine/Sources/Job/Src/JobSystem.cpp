@@ -0,0 +1,409 @@
+#include "JobSystem.h"
+#include "JobQueue.h"
+
+#include <algorithm>
+#include <cassert>
+#include <fstream>
+#include <set>
+#include <string>
+
+#if defined(ZE_PLATFORM_WINDOWS)
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #include <windows.h>
+#elif defined(ZE_PLATFORM_LINUX)
+    #include <pthread.h>
+    #include <sched.h>
+#endif
+
+
+namespace ZE {
+
+const uint32_t JobQueueCapacity = 4096;
+
+// Rounds of looking for work before a worker goes to sleep
+const uint32_t WorkerSpinCount = 64;
+
+// Ranges handed out per queue when nothing gets stolen, enough to even out uneven ranges
+const size_t RangesPerQueue = 8;
+
+thread_local JobQueue* localQueue = nullptr;
+thread_local uint32_t localThreadIndex = UINT32_MAX;
+thread_local uint32_t localRandomState = 0;
+
+uint32_t NextRandom()
+{
+    if (localRandomState == 0)
+        localRandomState = static_cast<uint32_t>(std::hash<std::thread::id>{}(std::this_thread::get_id())) | 1;
+
+    // xorshift32
+    localRandomState ^= localRandomState << 13;
+    localRandomState ^= localRandomState >> 17;
+    localRandomState ^= localRandomState << 5;
+
+    return localRandomState;
+}
+
+#if defined(ZE_PLATFORM_LINUX)
+int32_t ReadCpuTopology(int32_t cpu, const char* name)
+{
+    std::ifstream file("/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/topology/" + name);
+
+    int32_t value = -1;
+    if (!(file >> value))
+        return -1;
+
+    return value;
+}
+#endif
+
+// CPUs the process may run on, one per physical core first and their SMT siblings after
+std::vector<int32_t> GetAvailableCpuArr()
+{
+    std::vector<int32_t> cpuArr;
+
+#if defined(ZE_PLATFORM_WINDOWS)
+    DWORD_PTR processMask, systemMask;
+    if (GetProcessAffinityMask(GetCurrentProcess(), &processMask, &systemMask))
+    {
+        for (int32_t cpu = 0; cpu < static_cast<int32_t>(sizeof(DWORD_PTR) * 8); cpu++)
+        {
+            if ((processMask & (static_cast<DWORD_PTR>(1) << cpu)) != 0)
+                cpuArr.push_back(cpu);
+        }
+    }
+#elif defined(ZE_PLATFORM_LINUX)
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    if (sched_getaffinity(0, sizeof(cpuSet), &cpuSet) == 0)
+    {
+        std::set<std::pair<int32_t, int32_t>> coreSet;
+        std::vector<int32_t> siblingArr;
+        for (int32_t cpu = 0; cpu < CPU_SETSIZE; cpu++)
+        {
+            if (!CPU_ISSET(cpu, &cpuSet))
+                continue;
+
+            int32_t package = ReadCpuTopology(cpu, "physical_package_id");
+            int32_t core = ReadCpuTopology(cpu, "core_id");
+            if (core < 0)
+                core = cpu;
+
+            if (coreSet.insert({package, core}).second)
+                cpuArr.push_back(cpu);
+            else
+                siblingArr.push_back(cpu);
+        }
+
+        cpuArr.insert(cpuArr.end(), siblingArr.begin(), siblingArr.end());
+    }
+#endif
+
+    return cpuArr;
+}
+
+void PinCurrentThread(int32_t cpu)
+{
+#if defined(ZE_PLATFORM_WINDOWS)
+    SetThreadAffinityMask(GetCurrentThread(), static_cast<DWORD_PTR>(1) << cpu);
+#elif defined(ZE_PLATFORM_LINUX)
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    CPU_SET(cpu, &cpuSet);
+    pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet);
+#endif
+}
+
+JobCounter::JobCounter() : _pendingCount(0)
+{
+}
+
+bool JobCounter::IsDone()
+{
+    return _pendingCount.load(std::memory_order_acquire) == 0;
+}
+
+JobSystem* JobSystem::_instance = nullptr;
+
+void JobSystem::Initialize(uint32_t workerCount, bool isAffinityEnabled)
+{
+    assert(_instance == nullptr);
+
+    if (_instance != nullptr)
+        return;
+
+    _instance = new JobSystem(workerCount, isAffinityEnabled);
+}
+
+void JobSystem::Cleanup()
+{
+    assert(_instance);
+
+    if (_instance == nullptr)
+        return;
+
+    delete _instance;
+    _instance = nullptr;
+}
+
+JobSystem& JobSystem::Get()
+{
+    assert(_instance);
+
+    return *_instance;
+}
+
+JobSystem::JobSystem(uint32_t workerCount, bool isAffinityEnabled)
+    : _sharedJobCount(0), _workEpoch(0), _sleepingCount(0), _isStopping(false), _jobCount(0), _stealCount(0)
+{
+    std::vector<int32_t> cpuArr = GetAvailableCpuArr();
+
+    if (workerCount == 0)
+    {
+        uint32_t cpuCount = cpuArr.empty() ? std::thread::hardware_concurrency() : static_cast<uint32_t>(cpuArr.size());
+        workerCount = std::max(cpuCount, 1u) - 1;
+    }
+
+    for (uint32_t i = 0; i <= workerCount; i++)
+        _queueArr.push_back(std::make_unique<JobQueue>(JobQueueCapacity));
+
+    localQueue = _queueArr[0].get();
+    localThreadIndex = 0;
+
+    // The first CPU is left to the calling thread
+    for (uint32_t i = 0; i < workerCount; i++)
+    {
+        int32_t cpu = isAffinityEnabled && !cpuArr.empty() ? cpuArr[(i + 1) % cpuArr.size()] : -1;
+        _workerArr.emplace_back(&JobSystem::WorkerMain, this, i + 1, cpu);
+    }
+}
+
+JobSystem::~JobSystem()
+{
+    {
+        std::lock_guard<std::mutex> lock(_sleepMutex);
+        _isStopping = true;
+    }
+    _sleepCondition.notify_all();
+
+    for (std::thread& worker : _workerArr)
+        worker.join();
+
+    // Whatever is left still runs, its counters may be waited on
+    while (Job* job = FindJob())
+        Execute(job);
+
+    localQueue = nullptr;
+    localThreadIndex = UINT32_MAX;
+}
+
+void JobSystem::Run(std::function<void()> function, JobCounter* counter)
+{
+    if (counter != nullptr)
+        counter->_pendingCount.fetch_add(1, std::memory_order_relaxed);
+
+    Job* job = new Job{std::move(function), counter};
+    _jobCount.fetch_add(1, std::memory_order_relaxed);
+
+    if (localQueue != nullptr)
+    {
+        if (!localQueue->Push(job))
+        {
+            Execute(job);
+            return;
+        }
+    }
+    else
+    {
+        std::lock_guard<std::mutex> lock(_sharedMutex);
+        _sharedJobQueue.push_back(job);
+        _sharedJobCount.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    WakeWorkers();
+}
+
+void JobSystem::Wait(JobCounter& counter)
+{
+    while (!counter.IsDone())
+    {
+        if (Job* job = FindJob())
+            Execute(job);
+        else
+            std::this_thread::yield();
+    }
+}
+
+void JobSystem::ParallelFor(size_t count, const std::function<void(size_t begin, size_t end)>& function, size_t minGrainSize)
+{
+    if (count == 0)
+        return;
+
+    size_t grainSize = std::max({minGrainSize, count / (_queueArr.size() * RangesPerQueue), static_cast<size_t>(1)});
+    if (_workerArr.empty() || count <= grainSize)
+    {
+        function(0, count);
+        return;
+    }
+
+    JobCounter counter;
+    RunRange(0, count, function, grainSize, counter);
+    Wait(counter);
+}
+
+bool JobSystem::IsStarving()
+{
+    if (localQueue != nullptr)
+        return localQueue->GetSize() == 0;
+
+    return _sharedJobCount.load(std::memory_order_relaxed) == 0;
+}
+
+void JobSystem::RunRange(size_t begin, size_t end, const std::function<void(size_t, size_t)>& function, size_t grainSize, JobCounter& counter)
+{
+    while (begin < end)
+    {
+        // Half of the rest goes to the thieves whenever they took everything queued here
+        if (end - begin > grainSize && IsStarving())
+        {
+            size_t middle = begin + (end - begin) / 2;
+            Run([this, middle, end, &function, grainSize, &counter]() { RunRange(middle, end, function, grainSize, counter); }, &counter);
+            end = middle;
+            continue;
+        }
+
+        size_t rangeEnd = std::min(begin + grainSize, end);
+        function(begin, rangeEnd);
+        begin = rangeEnd;
+    }
+}
+
+void JobSystem::WorkerMain(uint32_t queueIndex, int32_t cpu)
+{
+    if (cpu >= 0)
+        PinCurrentThread(cpu);
+
+    localQueue = _queueArr[queueIndex].get();
+    localThreadIndex = queueIndex;
+
+    uint32_t idleCount = 0;
+    while (!_isStopping.load(std::memory_order_acquire))
+    {
+        uint64_t workEpoch = _workEpoch.load();
+
+        if (Job* job = FindJob())
+        {
+            Execute(job);
+            idleCount = 0;
+            continue;
+        }
+
+        if (++idleCount < WorkerSpinCount)
+        {
+            std::this_thread::yield();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(_sleepMutex);
+        _sleepingCount.fetch_add(1);
+        _sleepCondition.wait(lock, [this, workEpoch]() { return _isStopping.load() || _workEpoch.load() != workEpoch; });
+        _sleepingCount.fetch_sub(1);
+        idleCount = 0;
+    }
+
+    localQueue = nullptr;
+    localThreadIndex = UINT32_MAX;
+}
+
+Job* JobSystem::FindJob()
+{
+    if (localQueue != nullptr)
+    {
+        if (Job* job = localQueue->Pop())
+            return job;
+    }
+
+    if (_sharedJobCount.load(std::memory_order_relaxed) > 0)
+    {
+        std::lock_guard<std::mutex> lock(_sharedMutex);
+        if (!_sharedJobQueue.empty())
+        {
+            Job* job = _sharedJobQueue.front();
+            _sharedJobQueue.pop_front();
+            _sharedJobCount.fetch_sub(1, std::memory_order_relaxed);
+            return job;
+        }
+    }
+
+    if (localQueue == nullptr)
+        return nullptr;
+
+    size_t queueCount = _queueArr.size();
+    size_t start = NextRandom() % queueCount;
+    for (size_t i = 0; i < queueCount; i++)
+    {
+        JobQueue* victim = _queueArr[(start + i) % queueCount].get();
+        if (victim == localQueue)
+            continue;
+
+        if (Job* job = victim->Steal())
+        {
+            _stealCount.fetch_add(1, std::memory_order_relaxed);
+            return job;
+        }
+    }
+
+    return nullptr;
+}
+
+void JobSystem::Execute(Job* job)
+{
+    job->function();
+
+    JobCounter* counter = job->counter;
+    delete job;
+
+    if (counter != nullptr)
+        counter->_pendingCount.fetch_sub(1, std::memory_order_release);
+}
+
+void JobSystem::WakeWorkers()
+{
+    // Pairs with the sleeping count going up before the epoch is checked, one of both sides sees the other
+    _workEpoch.fetch_add(1);
+    if (_sleepingCount.load() == 0)
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(_sleepMutex);
+    }
+    _sleepCondition.notify_one();
+}
+
+uint32_t JobSystem::GetWorkerCount()
+{
+    return static_cast<uint32_t>(_workerArr.size());
+}
+
+uint32_t JobSystem::GetThreadCount()
+{
+    return static_cast<uint32_t>(_queueArr.size());
+}
+
+uint32_t JobSystem::GetThreadIndex()
+{
+    return localThreadIndex;
+}
+
+uint64_t JobSystem::GetJobCount()
+{
+    return _jobCount.load(std::memory_order_relaxed);
+}
+
+uint64_t JobSystem::GetStealCount()
+{
+    return _stealCount.load(std::memory_order_relaxed);
+}
+
+} // namespace ZE
\ No newline at end of file
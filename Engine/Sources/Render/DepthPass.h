@@ -7,14 +7,11 @@ namespace ZE {
 class DepthPass : public RenderPass
 {
 public:
-    void Setup(TPtr<VulkanImageView>& Depth);
+    DepthPass();
 
-    virtual RenderTargets GetRenderTargets() override;
+    void Setup(RenderGraph& graph, RenderGraphTextureHandle depth, TPtrArr<SceneObject> objectsToRender);
 
-    virtual void Draw(TPtrArr<SceneObject> objectsToRender, TPtr<VulkanCommandBuffer> commandBuffer) override;
-
-private:
-    TPtr<VulkanImageView> m_depth;
+    virtual const char* GetName() override;
 };
 
 }
\ No newline at end of file
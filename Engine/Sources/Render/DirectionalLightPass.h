@@ -11,15 +11,11 @@ class FRenderTargetBindings;
 class DirectionalLightPass : public RenderPass
 {
 public:
-    void Setup(TPtr<VulkanImageView> color, TPtr<VulkanImageView> depth);
+    DirectionalLightPass();
 
-    virtual RenderTargets GetRenderTargets() override;
+    void Setup(RenderGraph& graph, RenderGraphTextureHandle color, RenderGraphTextureHandle depth, TPtrArr<SceneObject> objectsToRender);
 
-    virtual void Draw(TPtrArr<SceneObject> objectsToRender, TPtr<VulkanCommandBuffer> commandBuffer) override;
-
-private:
-    TPtr<VulkanImageView> m_color;
-    TPtr<VulkanImageView> m_depth;
+    virtual const char* GetName() override;
 };
 
 }
\ No newline at end of file
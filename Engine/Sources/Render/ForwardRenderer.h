@@ -2,41 +2,89 @@
 
 #include "Renderer.h"
 #include "Graphic/Window.h"
+#include "Scene/Scene.h"
 
 #include <glm/glm.hpp>
 #include <vulkan/vulkan.h>
 
+#include <deque>
+
 
 namespace ZE {
 
 class SceneObject;
+class RenderGraph;
 class RenderPass;
 class DepthPass;
 class DirectionalLightPass;
+class FrustumCuller;
+class GpuCuller;
+class HiZPyramid;
 class VulkanCommandBuffer;
 class VulkanDevice;
 class Surface;
+class Mesh;
+class Material;
+class MeshResource;
+class MaterialResource;
 
 
-class ForwardRenderer : public RendererInterface
+// GPU resources follow the scene: objects added at any time are queued and built over the next frames within
+// the upload budget, resources of removed objects are released right away and destroyed through the deletion queue.
+class ForwardRenderer : public RendererInterface, public SceneObserver
 {
 public:
-    ForwardRenderer();
+    // Bytes queued for upload and CPU time spent building resources per frame, at least one object is built per frame,
+    // spawning many objects at once spreads their uploads over several frames
+    ForwardRenderer(VkDeviceSize uploadByteBudget, float uploadMillisecondBudget);
     virtual ~ForwardRenderer();
+    // Culls and generates the draws on the GPU instead of Prepare, ignored without indirect count support.
+    // The lighting pass also skips objects occluded in the depth pass' Hi-Z pyramid.
+    // Has to be set before Init, only objects built afterwards are registered with the culler
+    void SetGpuCulling(bool isEnabled);
 
     virtual void Init(TPtr<Scene> scene) override;
-    TPtrArr<SceneObject> Prepare(TPtr<VulkanCommandBuffer> commandBuffer, TPtr<Scene> scene);
+
+    virtual void OnObjectAdded(TPtr<SceneObject> object) override;
+    virtual void OnObjectRemoved(TPtr<SceneObject> object) override;
+
+    // Objects ready to be drawn and inside the camera's frustum
+    TPtrArr<SceneObject> Prepare(TPtr<Scene> scene);
+    TPtr<FrustumCuller> GetFrustumCuller();
+    // Null unless GPU culling is enabled
+    TPtr<GpuCuller> GetGpuCuller();
     void Draw(TPtr<VulkanCommandBuffer> commandBuffer, TPtr<Scene> scene);
-    void SetupFrame(TPtr<VulkanCommandBuffer> commandBuffer, TPtr<Frame> frame);
+    void SetupFrame(RenderGraph& graph, TPtr<Frame> frame, const TPtrArr<SceneObject>& objectsToRender);
     virtual void RenderFrame(TPtr<VulkanCommandBuffer> commandBuffer, TPtr<Scene> scene, TPtr<Frame> frame) override;
 
 private:
+    void BuildPendingResources();
+    bool BuildResources(TPtr<SceneObject> object, TPtrArr<Mesh>& meshArr, TPtrArr<Material>& materialArr);
+
+private:
+    struct ObjectResources
+    {
+        TPtr<MeshResource> meshResource;
+        TPtr<MaterialResource> materialResource;
+    };
+
     VkFence _inFlightFence;
 
     TPtr<DepthPass> _depthPass;
     TPtr<DirectionalLightPass> _directionalLightPass;
+    TPtr<FrustumCuller> _frustumCuller;
+    TPtr<GpuCuller> _gpuCuller;
+    TPtr<HiZPyramid> _hiZPyramid;
+
+    TWeakPtr<Scene> _scene;
+    std::deque<TWeakPtr<SceneObject>> _pendingObjectQueue;
+    // Objects whose resources are built, resources shared between objects are counted
+    std::unordered_map<SceneObject*, ObjectResources> _objectResourceMap;
+    std::unordered_map<MeshResource*, uint32_t> _meshRefCountMap;
+    std::unordered_map<MaterialResource*, uint32_t> _materialRefCountMap;
 
-    TPtrArr<RenderPass> _passes;
+    VkDeviceSize _uploadByteBudget;
+    float _uploadMillisecondBudget;
 };
 
 }
\ No newline at end of file
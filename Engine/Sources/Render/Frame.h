@@ -2,51 +2,114 @@
 
 #include "CoreDefines.h"
 #include "CoreTypes.h"
+#include "Graphic/VulkanQueue.h"
 
 #include <glm/glm.hpp>
 #include <vulkan/vulkan.h>
 
+#include <functional>
+
 namespace ZE {
 
-struct RenderTargets;
 class VulkanSwapchain;
 class VulkanFramebuffer;
+class VulkanImage;
 class VulkanImageView;
+class VulkanBuffer;
 class VulkanDevice;
+class VulkanCommandPool;
 class VulkanCommandBuffer;
 
+// Receives the tightly packed pixels of a headless frame once the GPU is done with it
+typedef std::function<void(uint64_t frameNumber, const void* data, const VkExtent3D& extent, VkFormat format)> ReadbackCallback;
+
+// One slot of the frames-in-flight ring. The slot is created once and reused:
+// its command pool and semaphores live as long as the slot does. Completion is
+// tracked by the value the slot's last submission signals on the frame timeline.
 class Frame
 {
 public:
-    Frame(TPtr<VulkanDevice> device, TPtr<VulkanSwapchain> swapchain);
+    Frame(TPtr<VulkanDevice> device, uint32_t index);
     ~Frame();
 
+    // Waits until the GPU has finished the last submission made from this slot,
+    // recycles its per-frame resources and acquires the next swapchain image.
+    // Returns false when no image could be acquired; the slot stays untouched.
+    bool Begin(TPtr<VulkanSwapchain> swapchain);
+    // Headless variant, renders into an engine owned image instead of a swapchain image.
+    void Begin(TPtr<VulkanImageView> renderTarget);
+    void WaitForCompletion();
+
+    // Records a copy of the render target into host memory, the result is handed to the
+    // callback when the slot is reused or flushed. Only valid for headless frames.
+    TPtr<VulkanCommandBuffer> RecordReadback(uint64_t frameNumber, ReadbackCallback callback);
+    void FlushReadback();
+
+    bool IsHeadless();
+    // Layout the render target has to be left in at the end of the frame
+    VkImageLayout GetFinalLayout();
+
+    uint32_t GetIndex();
+
     const glm::ivec2 GetViewport();
 
     TPtr<VulkanImageView> GetFrameBuffer();
     VkExtent3D GetExtent();
 
     VkSemaphore GetAvailableSemaphore();
-    VkFence GetFence();
+    VkSemaphore GetRenderFinishedSemaphore();
+    // Value the frame's submission has to signal on the frame timeline
+    uint64_t GetTimelineValue();
+
+    // Semaphores the frame's submission waits on, timeline ones for the given value. Cleared by Begin.
+    void AddWaitSemaphore(VkSemaphore semaphore, VkPipelineStageFlags2 stage, uint64_t value = 0);
+    const std::vector<VulkanSemaphoreSubmit>& GetWaitArr();
 
     TPtr<VulkanCommandBuffer> GetCachedCommandBuffer();
+    // A secondary command buffer from the calling job thread's own pool, recycled by Begin. Threads never
+    // share a pool, so any number of them may record at once.
+    TPtr<VulkanCommandBuffer> GetSecondaryCommandBuffer();
 
-    void PutImage(TPtr<VulkanImageView> imageView); 
+    void PutImage(TPtr<VulkanImageView> imageView);
     void PutFramebuffer(TPtr<VulkanFramebuffer> framebuffer);
-    void PutSemaphore(VkSemaphore sem);
 
 private:
+    void BeginInternal();
+    void ReleaseResources();
+
+private:
+    // Own cache line, threads bump usedCount concurrently
+    struct alignas(64) ThreadCommandPool
+    {
+        TPtr<VulkanCommandPool> commandPool;
+        TPtrArr<VulkanCommandBuffer> commandBufferArr;
+        size_t usedCount = 0;
+    };
+
+    uint32_t _index;
     TPtr<VulkanDevice> _cachedDevice;
     TPtr<VulkanImageView> _renderTarget;
+    bool _isHeadless;
 
     VkExtent3D _extent;
     VkSemaphore _imageAvailableSemaphore;
-    VkFence _fence;
+    VkSemaphore _renderFinishedSemaphore;
+    uint64_t _timelineValue;
+
+    std::vector<VulkanSemaphoreSubmit> _waitArr;
 
     TPtrArr<VulkanImageView> _imageViewArr;
     TPtrArr<VulkanFramebuffer> _framebufferArr;
-    std::vector<VkSemaphore> _semaphoreArr;
+    TPtr<VulkanCommandPool> _commandPool;
     TPtr<VulkanCommandBuffer> _cachedCommandBuffer;
+    // Indexed by job thread, pools are created by the thread on first use
+    std::vector<ThreadCommandPool> _threadCommandPoolArr;
+
+    TPtr<VulkanBuffer> _readbackBuffer;
+    TPtr<VulkanCommandBuffer> _readbackCommandBuffer;
+    ReadbackCallback _readbackCallback;
+    uint64_t _readbackFrameNumber;
+    bool _hasPendingReadback;
 };
 
 }
\ No newline at end of file
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "CoreDefines.h"
+#include "CoreTypes.h"
+
+#include <chrono>
+
+
+namespace ZE {
+
+class VulkanSwapchain;
+
+// Trades throughput against latency for the frame loop. WaitForNextFrame is called before a frame starts:
+// it first bounds the number of frames queued ahead of the display, waiting for presents when
+// VK_KHR_present_wait is available and for the frame timeline otherwise, then holds the frame until the
+// limiter's next slot. The limiter sleeps for most of the interval and spins the rest, as OS sleeps
+// overshoot by up to a millisecond.
+class FramePacer
+{
+public:
+    // The swapchain is nullptr when headless
+    FramePacer(TPtr<VulkanSwapchain> swapchain);
+    ~FramePacer();
+
+    // Frames per second, 0 disables the limiter
+    void SetMaxFrameRate(float frameRate);
+    // Frames submitted but not displayed yet, 0 leaves the bound to the frames in flight
+    void SetMaxQueuedFrames(uint32_t maxQueuedFrames);
+
+    void WaitForNextFrame();
+    // Id the frame is presented with, 0 when presents can't be waited on
+    uint64_t NextPresentId();
+
+    bool IsPresentWaitEnabled();
+    // Seconds spent waiting on queued frames and in the limiter
+    double GetQueueWaitTime();
+    double GetLimiterWaitTime();
+
+private:
+    void WaitForQueue();
+    void WaitForLimiter(std::chrono::steady_clock::time_point now);
+
+private:
+    TPtr<VulkanSwapchain> _swapchain;
+    bool _isPresentWaitEnabled;
+
+    uint32_t _maxQueuedFrames;
+    uint64_t _lastPresentId;
+
+    std::chrono::steady_clock::duration _frameInterval;
+    std::chrono::steady_clock::time_point _nextFrameTime;
+
+    std::chrono::duration<double> _queueWaitTime;
+    std::chrono::duration<double> _limiterWaitTime;
+};
+
+} // namespace ZE
\ No newline at end of file
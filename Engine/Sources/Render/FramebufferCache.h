@@ -0,0 +1,54 @@
+#pragma once
+
+#include "CoreDefines.h"
+#include "CoreTypes.h"
+#include "CoreHash.h"
+
+#include <vulkan/vulkan.h>
+
+
+namespace ZE {
+
+class VulkanDevice;
+class VulkanRenderPass;
+class VulkanImageView;
+class VulkanFramebuffer;
+
+// Framebuffers keyed by render pass, attachments and extent. An entry whose attachments have been
+// destroyed is never returned and is dropped on the next Tick.
+class FramebufferCache
+{
+public:
+    // Entries unused for evictAfterFrames frames are dropped, it must exceed the frames in flight
+    FramebufferCache(TPtr<VulkanDevice> device, uint64_t evictAfterFrames = 600);
+    ~FramebufferCache();
+
+    TPtr<VulkanFramebuffer> GetOrCreate(TPtr<VulkanRenderPass> renderPass, const TPtrArr<VulkanImageView>& imageViewArr, const VkExtent2D& extent);
+
+    void Tick();
+    void Clear();
+
+    uint64_t GetHitCount();
+    uint64_t GetMissCount();
+    size_t GetSize();
+
+private:
+    struct Entry
+    {
+        TPtr<VulkanFramebuffer> framebuffer;
+        uint64_t lastUsedFrame;
+    };
+
+private:
+    TPtr<VulkanDevice> _device;
+
+    std::unordered_map<HashKey, Entry, HashKeyHasher> _entries;
+
+    uint64_t _frame;
+    uint64_t _evictAfterFrames;
+
+    uint64_t _hitCount;
+    uint64_t _missCount;
+};
+
+} // namespace ZE
\ No newline at end of file
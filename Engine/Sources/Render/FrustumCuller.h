@@ -0,0 +1,48 @@
+#pragma once
+
+#include "CoreDefines.h"
+#include "CoreTypes.h"
+#include "Scene/CameraComponent.h"
+
+#include <vector>
+
+
+namespace ZE {
+
+class SceneObject;
+
+// Keeps the objects whose world space bounds touch the frustum. Bounds are gathered into a structure of
+// arrays, a block of 8 objects at a time, and each block is tested against all planes at once with AVX,
+// SSE or scalar code depending on what the build targets. Large scenes are gathered and tested on the
+// job threads. An object is culled when either its sphere or its box is fully outside one plane.
+class FrustumCuller
+{
+public:
+    FrustumCuller();
+    ~FrustumCuller();
+
+    // Objects need a mesh, visibleObjects keeps their order
+    void Cull(const Frustum& frustum, const TPtrArr<SceneObject>& objects, TPtrArr<SceneObject>& visibleObjects);
+
+    uint64_t GetTestedCount();
+    uint64_t GetCulledCount();
+
+private:
+    void GatherBlocks(const TPtrArr<SceneObject>& objects, size_t beginBlock, size_t endBlock);
+
+private:
+    // World space center, box half extents and sphere radius, padded to whole blocks
+    std::vector<float> _centerX;
+    std::vector<float> _centerY;
+    std::vector<float> _centerZ;
+    std::vector<float> _extentX;
+    std::vector<float> _extentY;
+    std::vector<float> _extentZ;
+    std::vector<float> _radius;
+    std::vector<uint8_t> _visibleArr;
+
+    uint64_t _testedCount;
+    uint64_t _culledCount;
+};
+
+} // namespace ZE
\ No newline at end of file
@@ -0,0 +1,124 @@
+#pragma once
+
+#include "CoreDefines.h"
+#include "CoreTypes.h"
+#include "Scene/CameraComponent.h"
+
+#include <glm/glm.hpp>
+#include <vulkan/vulkan.h>
+
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+
+namespace ZE {
+
+class SceneObject;
+class TransformComponent;
+class ShaderResource;
+class Mesh;
+class Material;
+class HiZPyramid;
+class VulkanBuffer;
+class VulkanCommandBuffer;
+class VulkanSampler;
+class VulkanShader;
+class VulkanDescriptorPool;
+class VulkanDescriptorSetLayout;
+class VulkanDescriptorSet;
+class VulkanPipelineLayout;
+class VulkanComputePipeline;
+
+// Objects sharing mesh and material, their draws are compacted into one range of the indirect buffer
+struct GpuDrawGroup
+{
+    TPtr<Mesh> mesh;
+    TPtr<Material> material;
+    // Also the size of the group's range, a group without objects is a free slot
+    uint32_t objectCount;
+    uint32_t commandOffset;
+};
+
+// Culls on the GPU and generates the draws of the surviving objects. Objects are registered once and keep a
+// slot, every frame their transforms and bounds go to a per frame buffer and a compute dispatch tests them
+// against the frustum, writes the MVP of every visible object to the instance buffer and appends a
+// VkDrawIndexedIndirectCommand to its group's range. Passes draw each group with one
+// vkCmdDrawIndexedIndirectCount reading the group's count at its index in the draw count buffer.
+// Once the depth pass ran, the draws can be generated again with the objects hidden behind the Hi-Z pyramid
+// of its depth rejected as well.
+class GpuCuller
+{
+public:
+    GpuCuller(TPtr<HiZPyramid> hiZPyramid);
+    ~GpuCuller();
+
+    // The object needs a transform, mesh and material may not be drawn before they are ready
+    void AddObject(TPtr<SceneObject> object, TPtr<Mesh> mesh, TPtr<Material> material);
+    void RemoveObject(SceneObject* object);
+
+    // Records the cull dispatch outside of any render pass, passes drawing the groups have to come after it
+    void Dispatch(TPtr<VulkanCommandBuffer> commandBuffer, uint32_t frameIndex, const glm::mat4x4& viewProjection, const Frustum& frustum);
+    // Culls the objects of the frame's Dispatch again, also against the pyramid. Passes drawing the groups
+    // afterwards only draw what is not occluded
+    void DispatchOcclusion(TPtr<VulkanCommandBuffer> commandBuffer, uint32_t frameIndex);
+
+    const std::vector<GpuDrawGroup>& GetDrawGroups();
+    TPtr<VulkanBuffer> GetIndirectBuffer();
+    TPtr<VulkanBuffer> GetDrawCountBuffer();
+    // One MVP per object slot, the draws' first instance is the slot
+    TPtr<VulkanBuffer> GetInstanceBuffer();
+
+    uint32_t GetObjectCount();
+    uint32_t GetDrawGroupCount();
+
+private:
+    struct ObjectSlot
+    {
+        SceneObject* object;
+        TPtr<TransformComponent> transformComponent;
+        glm::vec4 sphere;
+        glm::vec3 extent;
+        uint32_t groupIndex;
+    };
+
+    // Rewritten every frame, the GPU may still read the copies of the frames in flight
+    struct FrameResources
+    {
+        TPtr<VulkanBuffer> objectBuffer;
+        TPtr<VulkanBuffer> groupBuffer;
+        TPtr<VulkanDescriptorSet> descriptorSet;
+    };
+
+    uint32_t AcquireDrawGroup(TPtr<Mesh> mesh, TPtr<Material> material);
+    void ReleaseDrawGroup(uint32_t groupIndex);
+
+    void WriteObjects(FrameResources& frameResources, const glm::mat4x4& viewProjection, const Frustum& frustum);
+    void WriteDrawGroups(FrameResources& frameResources);
+    void UpdateDescriptorSet(FrameResources& frameResources);
+    void RecordCull(TPtr<VulkanCommandBuffer> commandBuffer, FrameResources& frameResources, bool isOcclusionCulled);
+
+private:
+    TPtr<ShaderResource> _shaderResource;
+    TPtr<VulkanShader> _shader;
+    TPtr<VulkanDescriptorSetLayout> _descriptorSetLayout;
+    TPtr<VulkanDescriptorPool> _descriptorPool;
+    TPtr<VulkanPipelineLayout> _pipelineLayout;
+    TPtr<VulkanComputePipeline> _pipeline;
+    TPtr<VulkanSampler> _sampler;
+    TPtr<HiZPyramid> _hiZPyramid;
+
+    std::vector<FrameResources> _frameResourcesArr;
+    TPtr<VulkanBuffer> _indirectBuffer;
+    TPtr<VulkanBuffer> _drawCountBuffer;
+    TPtr<VulkanBuffer> _instanceBuffer;
+
+    std::vector<ObjectSlot> _objectArr;
+    std::unordered_map<SceneObject*, uint32_t> _objectIndexMap;
+    std::vector<GpuDrawGroup> _drawGroupArr;
+    std::map<std::pair<Mesh*, Material*>, uint32_t> _drawGroupIndexMap;
+    std::vector<uint32_t> _freeDrawGroupArr;
+    uint32_t _commandCount;
+};
+
+} // namespace ZE
\ No newline at end of file
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "CoreDefines.h"
+#include "CoreTypes.h"
+#include "CoreHash.h"
+#include "Graphic/PipelineState.h"
+
+#include <vulkan/vulkan.h>
+
+#include <mutex>
+
+
+namespace ZE {
+
+class VulkanDevice;
+class VulkanRenderPass;
+class VulkanGraphicPipeline;
+class VulkanPipelineCache;
+
+// Pipelines keyed by the effective pipeline state plus the render pass compatibility,
+// so compatible render passes recreated every frame still hit the same pipeline.
+// GetOrCreate may be called from any thread, draws recorded in parallel share the cache.
+class GraphicPipelineCache
+{
+public:
+    // Pipelines unused for evictAfterFrames frames are destroyed, it must exceed the frames in flight
+    GraphicPipelineCache(TPtr<VulkanDevice> device, TPtr<VulkanPipelineCache> driverCache, uint64_t evictAfterFrames = 600);
+    ~GraphicPipelineCache();
+
+    TPtr<VulkanGraphicPipeline> GetOrCreate(const RHIPipelineState& state, TPtr<VulkanRenderPass> renderPass);
+
+    void Tick();
+    void Clear();
+
+    uint64_t GetHitCount();
+    uint64_t GetMissCount();
+    uint64_t GetEvictionCount();
+    size_t GetSize();
+
+private:
+    struct Entry
+    {
+        TPtr<VulkanGraphicPipeline> pipeline;
+        uint64_t lastUsedFrame;
+    };
+
+    static HashKey MakeKey(const RHIPipelineState& state, TPtr<VulkanRenderPass> renderPass);
+
+private:
+    TPtr<VulkanDevice> _device;
+    TPtr<VulkanPipelineCache> _driverCache;
+
+    std::unordered_map<HashKey, Entry, HashKeyHasher> _entries;
+
+    uint64_t _frame;
+    uint64_t _evictAfterFrames;
+
+    uint64_t _hitCount;
+    uint64_t _missCount;
+    uint64_t _evictionCount;
+
+    std::mutex _mutex;
+};
+
+} // namespace ZE
\ No newline at end of file
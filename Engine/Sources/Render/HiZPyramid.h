@@ -0,0 +1,66 @@
+#pragma once
+
+#include "CoreDefines.h"
+#include "CoreTypes.h"
+
+#include <vulkan/vulkan.h>
+
+#include <vector>
+
+
+namespace ZE {
+
+class ShaderResource;
+class VulkanImage;
+class VulkanImageView;
+class VulkanSampler;
+class VulkanShader;
+class VulkanCommandBuffer;
+class VulkanDescriptorPool;
+class VulkanDescriptorSetLayout;
+class VulkanDescriptorSet;
+class VulkanPipelineLayout;
+class VulkanComputePipeline;
+
+// Min/max depth pyramid of the scene depth for occlusion tests. Level 0 is half the depth resolution rounded
+// down and every level halves the previous one down to a single texel, r holds the farthest depth of the
+// footprint and g the nearest. The image stays in the general layout, it is written and sampled by compute.
+class HiZPyramid
+{
+public:
+    HiZPyramid();
+    ~HiZPyramid();
+
+    // Recreates the pyramid when the depth size changed, has to be recorded before anything samples it
+    void Resize(TPtr<VulkanCommandBuffer> commandBuffer, const VkExtent3D& depthExtent);
+    // The depth has to be in the depth read only layout
+    void Build(TPtr<VulkanCommandBuffer> commandBuffer, uint32_t frameIndex, TPtr<VulkanImageView> depthView);
+
+    // All levels, for texelFetch
+    TPtr<VulkanImageView> GetImageView();
+    VkExtent3D GetDepthExtent();
+    uint32_t GetMipLevels();
+
+private:
+    VkExtent3D GetMipExtent(uint32_t mipLevel);
+
+private:
+    TPtr<ShaderResource> _shaderResource;
+    TPtr<VulkanShader> _shader;
+    TPtr<VulkanDescriptorSetLayout> _descriptorSetLayout;
+    TPtr<VulkanDescriptorPool> _descriptorPool;
+    TPtr<VulkanPipelineLayout> _pipelineLayout;
+    TPtr<VulkanComputePipeline> _pipeline;
+    TPtr<VulkanSampler> _sampler;
+
+    VkExtent3D _depthExtent;
+    TPtr<VulkanImage> _image;
+    TPtr<VulkanImageView> _imageView;
+    TPtrArr<VulkanImageView> _mipViewArr;
+    // The depth target comes from the pool and may change every frame, level 0 is reduced through the set
+    // of the frame in flight. Every other level reads the previous one through a set of its own
+    TPtrArr<VulkanDescriptorSet> _depthDescriptorSetArr;
+    TPtrArr<VulkanDescriptorSet> _mipDescriptorSetArr;
+};
+
+} // namespace ZE
\ No newline at end of file
@@ -21,7 +21,7 @@ class VulkanDescriptorSet;
 class VulkanDescriptorSetLayout;
 class VulkanPipelineLayout;
 class VulkanGraphicPipeline;
-class VulkanCommandBuffer;
+class VulkanUploadBatch;
 class Mesh;
 
 struct VulkanImageBindingInfo
@@ -37,11 +37,10 @@ public:
     Pass(TPtr<PassResource> passResource);
     ~Pass();
 
-    void BuildRenderResource(TPtr<VulkanCommandBuffer> commandBuffer);
+    void BuildRenderResource(TPtr<VulkanUploadBatch> uploadBatch);
 
 private:
-    void CreateGraphicTextures(TPtr<VulkanCommandBuffer> commandBuffer);
-    void CreateGraphicBuffers(TPtr<VulkanCommandBuffer> commandBuffer);
+    void CreateGraphicTextures(TPtr<VulkanUploadBatch> uploadBatch);
     void CreateGraphicShaders();
 
     void CreateDescriptorSetLayout();
@@ -55,12 +54,9 @@ public:
     TPtr<VulkanPipelineLayout> GetPipelineLayout();
     void ApplyPipelineState(RHIPipelineState& state);
 
-    void UpdateUniformBuffer(TPtr<VulkanCommandBuffer> commandBuffer, const glm::mat4x4& mvp);
-
 private:
     TPtrUnorderedMap<VkShaderStageFlagBits, VulkanShader> _shaders;
     std::unordered_map<VkShaderStageFlagBits, std::list<VulkanImageBindingInfo>> _textures;
-    TPtr<VulkanBuffer> _uniformBuffer;
     TPtr<VulkanDescriptorSetLayout> _descriptorSetLayout;
     TPtr<VulkanDescriptorSet> _descriptorSet;
     TPtr<VulkanPipelineLayout> _pipelineLayout;
@@ -82,9 +78,14 @@ public:
     void SetPass(EPassType passType, TPtr<Pass> pass);
     TPtr<Pass> GetPass(EPassType passType);
 
+    // Value of the async upload carrying the textures, the material may only be drawn once it is ready
+    void SetUploadValue(uint64_t uploadValue);
+    bool IsReady();
+
 private:
     TPtrUnorderedMap<EPassType, Pass> _passMap;
     TWeakPtr<MaterialResource> _owner;
+    uint64_t _uploadValue;
 };
 
 } // namespace ZE
@@ -13,29 +13,39 @@ namespace ZE {
 class MeshResource;
 
 class VulkanBuffer;
-class VulkanCommandBuffer;
+class VulkanUploadBatch;
 class VulkanDevice;
 
 
 class Mesh
 {
+public:
+    // Vertex buffer binding of the per instance MVP matrices, bound by whoever records the draws
+    static constexpr uint32_t InstanceBinding = 1;
+
 public:
     Mesh(TPtr<MeshResource> meshResource);
     ~Mesh();
 
     uint32_t GetVerticesCount();
 
-    void CreateVertexBuffer(TPtr<VulkanCommandBuffer> commandBuffer);
+    void CreateVertexBuffer(TPtr<VulkanUploadBatch> uploadBatch);
     TPtr<VulkanBuffer> GetVertexBuffer();
 
-    void CreateIndexBuffer(TPtr<VulkanCommandBuffer> commandBuffer);
+    void CreateIndexBuffer(TPtr<VulkanUploadBatch> uploadBatch);
     TPtr<VulkanBuffer> GetIndexBuffer();
 
     void ApplyPipelineState(RHIPipelineState& state);
 
+    // Value of the async upload carrying the buffers, the mesh may only be drawn once it is ready
+    void SetUploadValue(uint64_t uploadValue);
+    bool IsReady();
+
 private:
     TPtr<VulkanBuffer> _vertexBuffer, _indexBuffer;
     uint32_t _verticesCount;
+    uint64_t _uploadValue;
+    bool _isReady;
 
     TWeakPtr<MeshResource> _owner;
 };
@@ -0,0 +1,170 @@
+#pragma once
+
+#include "CoreDefines.h"
+#include "CoreTypes.h"
+#include "RenderTargets.h"
+#include "RenderTargetPool.h"
+
+#include <vulkan/vulkan.h>
+
+#include <functional>
+
+
+namespace ZE {
+
+class Frame;
+class RenderGraph;
+class VulkanImageView;
+class VulkanRenderPass;
+class VulkanFramebuffer;
+class VulkanCommandBuffer;
+
+// Index of a virtual texture, only meaningful for the graph that returned it
+typedef uint32_t RenderGraphTextureHandle;
+
+// What a pass records into. Render pass and framebuffer are the ones the graph began for the pass,
+// nullptr when the pass has no attachments.
+struct RenderGraphPassContext
+{
+    TPtr<VulkanCommandBuffer> commandBuffer;
+    TPtr<VulkanRenderPass> renderPass;
+    TPtr<VulkanFramebuffer> framebuffer;
+    VkExtent2D extent;
+    TPtr<Frame> frame;
+};
+
+typedef std::function<void(const RenderGraphPassContext& context)> RenderGraphExecuteCallback;
+
+struct RenderGraphTextureDesc
+{
+    VkExtent3D extent;
+    VkFormat format;
+    VkImageAspectFlagBits aspect;
+};
+
+enum class ERenderGraphAccess : uint8_t
+{
+    ColorAttachment,
+    DepthAttachment,
+    // Depth loaded for testing, the material may still write to it
+    DepthAttachmentRead,
+    ShaderRead,
+};
+
+class RenderGraphPassBuilder
+{
+public:
+    RenderGraphPassBuilder(RenderGraph& graph, uint32_t passIndex);
+
+    RenderGraphPassBuilder& WriteColor(RenderGraphTextureHandle texture, ERenderTargetLoadAction loadAction);
+    RenderGraphPassBuilder& WriteDepth(RenderGraphTextureHandle texture, ERenderTargetLoadAction loadAction);
+    RenderGraphPassBuilder& ReadDepth(RenderGraphTextureHandle texture);
+    RenderGraphPassBuilder& ReadTexture(RenderGraphTextureHandle texture);
+    // The render pass is begun for secondary command buffers, the callback may only execute those inside it
+    RenderGraphPassBuilder& RecordSecondary();
+
+private:
+    RenderGraph& _graph;
+    uint32_t _passIndex;
+};
+
+// Per frame description of the passes and the textures they touch. Compile culls passes whose
+// outputs are never consumed, infers load/store ops, places transient textures with disjoint
+// lifetimes in the same pooled image and works out the barriers; Execute records everything.
+class RenderGraph
+{
+    friend class RenderGraphPassBuilder;
+
+public:
+    RenderGraph();
+    ~RenderGraph();
+
+    RenderGraphTextureHandle CreateTexture(const char* name, const RenderGraphTextureDesc& desc);
+    // External textures are always considered consumed and are left in finalLayout after the graph
+    RenderGraphTextureHandle ImportTexture(const char* name, TPtr<VulkanImageView> imageView, VkImageLayout finalLayout);
+
+    // Passes that write no texture have side effects the graph can't see and are never culled.
+    // Names are kept by the GPU profiler until the frame resolves, pass string literals.
+    RenderGraphPassBuilder AddPass(const char* name, RenderGraphExecuteCallback callback);
+
+    void Compile();
+    void Execute(TPtr<VulkanCommandBuffer> commandBuffer, TPtr<Frame> frame);
+
+    // Only valid after Compile
+    TPtr<VulkanImageView> GetImageView(RenderGraphTextureHandle texture);
+
+    uint32_t GetPassCount();
+    uint32_t GetCulledPassCount();
+    uint32_t GetTextureCount();
+    uint32_t GetPhysicalTextureCount();
+
+private:
+    struct TextureUsage
+    {
+        RenderGraphTextureHandle texture;
+        ERenderGraphAccess access;
+        ERenderTargetLoadAction loadAction;
+        VkAttachmentLoadOp loadOp;
+        VkAttachmentStoreOp storeOp;
+    };
+
+    struct PassNode
+    {
+        const char* name;
+        RenderGraphExecuteCallback callback;
+        std::vector<TextureUsage> usageArr;
+        uint32_t refCount;
+        bool isCulled;
+        VkSubpassContents contents;
+    };
+
+    struct TextureNode
+    {
+        const char* name;
+        RenderGraphTextureDesc desc;
+        bool isImported;
+        VkImageLayout finalLayout;
+        VkImageUsageFlags usage;
+        uint32_t refCount;
+        uint32_t firstPass;
+        uint32_t lastPass;
+        uint32_t physicalIndex;
+    };
+
+    // Synchronization state of an image while recording, shared by every texture aliasing it
+    struct PhysicalTexture
+    {
+        TPtr<VulkanImageView> imageView;
+        RenderTargetDesc desc;
+        uint32_t lastPass;
+        VkImageLayout layout;
+        VkPipelineStageFlags stageMask;
+        VkAccessFlags accessMask;
+        bool hasPendingWrite;
+    };
+
+private:
+    void AddUsage(uint32_t passIndex, RenderGraphTextureHandle texture, ERenderGraphAccess access, ERenderTargetLoadAction loadAction);
+
+    void CullPasses();
+    void ComputeLifetimes();
+    void InferAttachmentOps();
+    void AllocatePhysicalTextures();
+
+    void ExecutePass(PassNode& pass, TPtr<VulkanCommandBuffer> commandBuffer, TPtr<Frame> frame);
+    void AddBarrier(PhysicalTexture& physical, bool discardContents, VkImageLayout layout, VkPipelineStageFlags stageMask, VkAccessFlags accessMask, bool isWrite);
+    void FlushBarriers(TPtr<VulkanCommandBuffer> commandBuffer);
+
+private:
+    std::vector<PassNode> _passArr;
+    std::vector<TextureNode> _textureArr;
+    std::vector<PhysicalTexture> _physicalArr;
+
+    std::vector<VkImageMemoryBarrier> _pendingBarrierArr;
+    VkPipelineStageFlags _pendingSrcStageMask;
+    VkPipelineStageFlags _pendingDstStageMask;
+
+    bool _isCompiled;
+};
+
+} // namespace Z
\ No newline at end of file
@@ -2,9 +2,13 @@
 
 #include "CoreDefines.h"
 #include "CoreTypes.h"
+#include "RenderGraph.h"
+#include "Resource/MaterialResource.h"
 
 #include <glm/vec2.hpp>
+#include <glm/mat4x4.hpp>
 #include <optional>
+#include <span>
 
 namespace ZE {
 
@@ -14,22 +18,44 @@ class VulkanRenderPass;
 class SceneObject;
 class Scene;
 class Frame;
-struct RenderTargets;
+class GpuCuller;
 
 class RenderPass
 {
 public:
-    RenderPass();
+    // Objects are drawn with their material's pass of passType
+    RenderPass(EPassType passType);
     ~RenderPass();
 
-    virtual RenderTargets GetRenderTargets();
+    virtual const char* GetName();
 
-    virtual void Execute(TPtrArr<SceneObject> objectsToRender, TPtr<VulkanCommandBuffer> commandBuffer, const glm::ivec2& viewport);
+    void SetRenderPass(TPtr<VulkanRenderPass> renderPass);
+    void SetViewProjection(const glm::mat4x4& viewProjection);
+    // With a GPU culler the pass ignores the objects it is given and draws the culler's groups indirectly
+    void SetGpuCuller(TPtr<GpuCuller> gpuCuller);
 
-    virtual void Draw(TPtrArr<SceneObject> objectsToRender, TPtr<VulkanCommandBuffer> commandBuffer) = 0;
+    // Adds a graph pass that draws objectsToRender, the caller declares the textures it uses
+    RenderGraphPassBuilder AddToGraph(RenderGraph& graph, TPtrArr<SceneObject> objectsToRender);
+
+    virtual void Execute(const TPtrArr<SceneObject>& objectsToRender, TPtr<VulkanCommandBuffer> commandBuffer, const glm::ivec2& viewport);
+    // Records the draws in chunks on the job threads, each into a secondary command buffer of the frame,
+    // the primary executes them in chunk order so the result matches Execute
+    virtual void ExecuteParallel(const TPtrArr<SceneObject>& objectsToRender, const RenderGraphPassContext& context);
+
+    // Called concurrently for disjoint chunks when recording in parallel
+    void Draw(std::span<const TPtr<SceneObject>> objectsToRender, TPtr<VulkanCommandBuffer> commandBuffer);
+    // One indirect draw per group, the culler's dispatch for the frame has to be recorded before
+    void DrawIndirect(TPtr<GpuCuller> gpuCuller, TPtr<VulkanCommandBuffer> commandBuffer);
+
+protected:
+    bool IsParallelRecording(size_t drawCount);
+    void SetViewport(TPtr<VulkanCommandBuffer> commandBuffer, const glm::ivec2& viewport);
 
 protected:
- 
+    EPassType _passType;
+    TPtr<VulkanRenderPass> _renderPass;
+    TPtr<GpuCuller> _gpuCuller;
+    glm::mat4x4 _viewProjection;
 };
 
 }
\ No newline at end of file
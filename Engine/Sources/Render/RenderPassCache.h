@@ -0,0 +1,42 @@
+#pragma once
+
+#include "CoreDefines.h"
+#include "CoreTypes.h"
+#include "CoreHash.h"
+
+#include <vulkan/vulkan.h>
+
+#include <optional>
+
+
+namespace ZE {
+
+class VulkanDevice;
+class VulkanRenderPass;
+
+// Render passes keyed by their full attachment descriptions: formats, samples, load/store ops and layouts.
+// The set of distinct passes is small and stable, entries live until Clear.
+class RenderPassCache
+{
+public:
+    RenderPassCache(TPtr<VulkanDevice> device);
+    ~RenderPassCache();
+
+    TPtr<VulkanRenderPass> GetOrCreate(const std::vector<VkAttachmentDescription>& colorAttachmentArr, const std::optional<VkAttachmentDescription>& depthAttachment);
+
+    void Clear();
+
+    uint64_t GetHitCount();
+    uint64_t GetMissCount();
+    size_t GetSize();
+
+private:
+    TPtr<VulkanDevice> _device;
+
+    std::unordered_map<HashKey, TPtr<VulkanRenderPass>, HashKeyHasher> _renderPasses;
+
+    uint64_t _hitCount;
+    uint64_t _missCount;
+};
+
+} // namespace ZE
\ No newline at end of file
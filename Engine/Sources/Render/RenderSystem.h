@@ -9,23 +9,33 @@ namespace ZE {
 class VulkanGPU;
 class VulkanDevice;
 class VulkanQueue;
-class VulkanDescriptorPool;
+class VulkanDescriptorAllocator;
 class VulkanCommandBufferManager;
 class VulkanBufferManager;
-class VulkanGraphicPipeline;
+class GraphicPipelineCache;
+class RenderPassCache;
+class FramebufferCache;
+class RenderTargetPool;
+class VulkanRingBuffer;
+class VulkanPipelineCache;
+class VulkanMemoryDefragmenter;
+class VulkanAsyncUploader;
+class VulkanDeletionQueue;
+class VulkanTimelineSemaphore;
 
 class RenderSystem
 {
 public:
-    static void Initialize();
+    // A headless render system creates no surface or swapchain extensions
+    static void Initialize(bool isHeadless = false, uint32_t framesInFlight = 2);
     static void Cleanup();
     static RenderSystem& Get();
 
 private:
-    RenderSystem();
+    RenderSystem(bool isHeadless, uint32_t framesInFlight);
     ~RenderSystem();
 
-    void _CreateVulkanInstance();
+    void _CreateVulkanInstance(bool isHeadless);
     void _DestroyVulkanInstance();
 
 public:
@@ -33,22 +43,55 @@ public:
 
     TPtr<VulkanDevice> GetDevice();
     TPtr<VulkanQueue> GetQueue(VulkanQueue::EType type);
-    TPtr<VulkanDescriptorPool> GetDescriptorPool();
+    // Material descriptor sets, grows by a pool whenever the existing ones are full
+    TPtr<VulkanDescriptorAllocator> GetDescriptorAllocator();
     TPtr<VulkanCommandBufferManager> GetCommandBufferManager();
     TPtr<VulkanBufferManager> GetBufferManager();
-    TPtrSet<VulkanGraphicPipeline>& GetPipelineCache();
+    TPtr<GraphicPipelineCache> GetPipelineCache();
+    TPtr<VulkanPipelineCache> GetDriverPipelineCache();
+    TPtr<RenderPassCache> GetRenderPassCache();
+    TPtr<FramebufferCache> GetFramebufferCache();
+    TPtr<RenderTargetPool> GetRenderTargetPool();
+    // Per draw uniforms and instance data, one region per frame in flight
+    TPtr<VulkanRingBuffer> GetUniformRingBuffer();
+    TPtr<VulkanMemoryDefragmenter> GetMemoryDefragmenter();
+    // Streams uploads on the transfer queue
+    TPtr<VulkanAsyncUploader> GetAsyncUploader();
+    // Destroys released GPU objects once no frame in flight can use them
+    TPtr<VulkanDeletionQueue> GetDeletionQueue();
+
+    // Every frame submission signals its value on the frame timeline, values grow by one per frame
+    TPtr<VulkanTimelineSemaphore> GetFrameTimeline();
+    // Value the frame being recorded signals
+    uint64_t GetFrameValue();
+
+    bool IsHeadless();
+    uint32_t GetFramesInFlight();
 
 private:
     static RenderSystem* _instance;
     VkInstance _vkInstance;
+    bool _isHeadless;
+    uint32_t _framesInFlight;
 
     TPtr<VulkanGPU> _GPU;
     TPtr<VulkanDevice> _device;
     TPtrArr<VulkanQueue> _queueArr;
-    TPtr<VulkanDescriptorPool> _descriptorPool;
+    TPtr<VulkanDescriptorAllocator> _descriptorAllocator;
     TPtr<VulkanCommandBufferManager> _commandBufferManager;
     TPtr<VulkanBufferManager> _bufferManager;
-    TPtrSet<VulkanGraphicPipeline> _pipelineCache;
+    TPtr<VulkanPipelineCache> _driverPipelineCache;
+    TPtr<GraphicPipelineCache> _pipelineCache;
+    TPtr<RenderPassCache> _renderPassCache;
+    TPtr<FramebufferCache> _framebufferCache;
+    TPtr<RenderTargetPool> _renderTargetPool;
+    TPtr<VulkanRingBuffer> _uniformRingBuffer;
+    TPtr<VulkanMemoryDefragmenter> _memoryDefragmenter;
+    TPtr<VulkanAsyncUploader> _asyncUploader;
+    TPtr<VulkanDeletionQueue> _deletionQueue;
+    TPtr<VulkanTimelineSemaphore> _frameTimeline;
+    uint64_t _frameValue;
+    uint64_t _tickCount;
 };
 
 } // namespace ZE
\ No newline at end of file
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "CoreDefines.h"
+#include "CoreTypes.h"
+#include "CoreHash.h"
+
+#include <vulkan/vulkan.h>
+
+#include <unordered_map>
+
+
+namespace ZE {
+
+class VulkanDevice;
+class VulkanImageView;
+
+struct RenderTargetDesc
+{
+    VkExtent3D extent;
+    VkFormat format;
+    VkImageUsageFlags usage;
+    VkImageAspectFlagBits aspect;
+    // Contents are not needed once the frame is done, the target is created as a transient
+    // attachment in lazily allocated memory when the device supports it
+    bool isTransient;
+};
+
+// Render targets recycled across frames. A target is handed out again once nothing but the pool
+// references it, so callers must keep it alive (Frame::PutImage) until the GPU is done with it.
+class RenderTargetPool
+{
+public:
+    // Free targets unused for evictAfterFrames frames are destroyed
+    RenderTargetPool(TPtr<VulkanDevice> device, uint64_t evictAfterFrames = 600);
+    ~RenderTargetPool();
+
+    // The returned target starts in VK_IMAGE_LAYOUT_UNDEFINED, its previous contents are lost
+    TPtr<VulkanImageView> Acquire(const RenderTargetDesc& desc);
+
+    void Tick();
+    void Clear();
+
+    uint64_t GetAllocationCount();
+    uint64_t GetReuseCount();
+    size_t GetSize();
+
+private:
+    struct Entry
+    {
+        TPtr<VulkanImageView> imageView;
+        uint64_t lastUsedFrame;
+    };
+
+private:
+    TPtr<VulkanDevice> _device;
+
+    std::unordered_map<HashKey, std::vector<Entry>, HashKeyHasher> _entries;
+
+    uint64_t _frame;
+    uint64_t _evictAfterFrames;
+
+    uint64_t _allocationCount;
+    uint64_t _reuseCount;
+};
+
+} // namespace ZE
\ No newline at end of file
@@ -3,12 +3,8 @@
 #include "CoreDefines.h"
 #include "CoreTypes.h"
 
-#include <optional>
-
 namespace ZE {
 
-class VulkanImageView;
-
 enum class ERenderTargetLoadAction : uint8_t
 {
     Load,
@@ -16,21 +12,4 @@ enum class ERenderTargetLoadAction : uint8_t
     DontCare,
 };
 
-struct RenderTargetBinding
-{
-    RenderTargetBinding(TPtr<VulkanImageView> inTarget, ERenderTargetLoadAction inAction)
-        : target(inTarget), loadAction(inAction)
-    {
-    }
-
-    TPtr<VulkanImageView> target;
-    ERenderTargetLoadAction loadAction;
-};
-
-struct RenderTargets
-{
-    std::vector<RenderTargetBinding> colors;
-    std::optional<RenderTargetBinding> depthStencil;
-};
-
 } // namespace ZE
\ No newline at end of file
@@ -13,13 +13,19 @@
 #include "Graphic/VulkanPipeline.h"
 #include "Graphic/VulkanSwapchain.h"
 #include "Graphic/VulkanQueue.h"
+#include "Graphic/VulkanUploadBatch.h"
+#include "Graphic/VulkanAsyncUploader.h"
+#include "Graphic/VulkanTimelineSemaphore.h"
 #include "Frame.h"
 #include "RenderSystem.h"
-#include "RenderTargets.h"
+#include "RenderGraph.h"
 #include "Material.h"
 #include "Mesh.h"
 #include "DirectionalLightPass.h"
 #include "DepthPass.h"
+#include "FrustumCuller.h"
+#include "GpuCuller.h"
+#include "HiZPyramid.h"
 #include "Resource/MaterialResource.h"
 #include "Resource/MeshResource.h"
 #include "Scene/Scene.h"
@@ -27,99 +33,196 @@
 #include "Scene/TransformComponent.h"
 #include "Scene/CameraComponent.h"
 #include "Scene/MeshComponent.h"
+#include "Debug/CpuProfiler.h"
+#include "Debug/GpuProfiler.h"
 
 #include <algorithm>
+#include <chrono>
 
 
 namespace ZE {
 
-VkAttachmentLoadOp ConvertRenderTargetLoadActionToVulkan(ERenderTargetLoadAction loadAction)
-{
-    switch (loadAction)
-    {
-    case ERenderTargetLoadAction::Load:
-        return VkAttachmentLoadOp::VK_ATTACHMENT_LOAD_OP_LOAD;
-    case ERenderTargetLoadAction::Clear:
-        return VkAttachmentLoadOp::VK_ATTACHMENT_LOAD_OP_CLEAR;
-    case ERenderTargetLoadAction::DontCare:
-        return VkAttachmentLoadOp::VK_ATTACHMENT_LOAD_OP_DONT_CARE;
-    }
-
-    return VkAttachmentLoadOp::VK_ATTACHMENT_LOAD_OP_DONT_CARE;
-}
-
-ForwardRenderer::ForwardRenderer()
+ForwardRenderer::ForwardRenderer(VkDeviceSize uploadByteBudget, float uploadMillisecondBudget)
+    : _uploadByteBudget(uploadByteBudget), _uploadMillisecondBudget(uploadMillisecondBudget)
 {
     _inFlightFence = RenderSystem::Get().GetDevice()->CreateFence(true);
 
     _depthPass = std::make_shared<DepthPass>();
     _directionalLightPass = std::make_shared<DirectionalLightPass>();
+    _frustumCuller = std::make_shared<FrustumCuller>();
 }
 
 ForwardRenderer::~ForwardRenderer()
 {
+    if (TPtr<Scene> scene = _scene.lock())
+        scene->RemoveObserver(this);
+
     RenderSystem::Get().GetDevice()->DestroyFence(_inFlightFence);
 }
 
-void ForwardRenderer::Init(TPtr<Scene> scene)
+void ForwardRenderer::SetGpuCulling(bool isEnabled)
 {
-    TPtr<VulkanCommandBuffer> commandBuffer = RenderSystem::Get().GetCommandBufferManager()->GetCommandBuffer(VulkanQueue::EType::Graphic);
+    if (isEnabled && RenderSystem::Get().GetDevice()->IsDrawIndirectCountSupported())
+    {
+        if (_gpuCuller == nullptr)
+        {
+            _hiZPyramid = std::make_shared<HiZPyramid>();
+            _gpuCuller = std::make_shared<GpuCuller>(_hiZPyramid);
+        }
+    }
+    else
+    {
+        _gpuCuller.reset();
+        _hiZPyramid.reset();
+    }
 
-    commandBuffer->Begin();
+    _depthPass->SetGpuCuller(_gpuCuller);
+    _directionalLightPass->SetGpuCuller(_gpuCuller);
+}
 
-    const TPtrArr<SceneObject>& objects = scene->GetObjects();
+void ForwardRenderer::Init(TPtr<Scene> scene)
+{
+    _scene = scene;
+    scene->AddObserver(this);
 
+    const TPtrArr<SceneObject>& objects = scene->GetObjects();
     for (TPtr<SceneObject> object : objects)
+        _pendingObjectQueue.push_back(object);
+}
+
+void ForwardRenderer::OnObjectAdded(TPtr<SceneObject> object)
+{
+    _pendingObjectQueue.push_back(object);
+}
+
+void ForwardRenderer::OnObjectRemoved(TPtr<SceneObject> object)
+{
+    auto it = _objectResourceMap.find(object.get());
+    if (it == _objectResourceMap.end())
     {
-        TPtr<MeshComponent> meshComponent = object->GetComponent<MeshComponent>();
-        if (meshComponent == nullptr)
-            continue;
+        std::erase_if(_pendingObjectQueue, [&object](const TWeakPtr<SceneObject>& pendingObject) { return pendingObject.lock() == object; });
+        return;
+    }
 
-        TPtr<MeshResource> meshResource = meshComponent->GetMesh();
-        if (meshResource != nullptr)
+    if (_gpuCuller != nullptr)
+        _gpuCuller->RemoveObject(object.get());
+
+    // Frames in flight may still draw the object, the deletion queue keeps its GPU objects until they are done
+    TPtr<MeshResource> meshResource = it->second.meshResource;
+    if (meshResource != nullptr && --_meshRefCountMap[meshResource.get()] == 0)
+    {
+        _meshRefCountMap.erase(meshResource.get());
+        meshResource->SetMesh(nullptr);
+    }
+
+    TPtr<MaterialResource> materialResource = it->second.materialResource;
+    if (materialResource != nullptr && --_materialRefCountMap[materialResource.get()] == 0)
+    {
+        _materialRefCountMap.erase(materialResource.get());
+        materialResource->SetMaterial(nullptr);
+    }
+
+    _objectResourceMap.erase(it);
+}
+
+void ForwardRenderer::BuildPendingResources()
+{
+    ZE_CPU_SCOPE("ForwardRenderer::BuildPendingResources");
+
+    if (_pendingObjectQueue.empty())
+        return;
+
+    // Everything built this frame goes out in one transfer submission, objects are drawn once it landed
+    TPtr<VulkanAsyncUploader> asyncUploader = RenderSystem::Get().GetAsyncUploader();
+    TPtr<VulkanUploadBatch> uploadBatch = asyncUploader->GetBatch();
+
+    TPtrArr<Mesh> meshArr;
+    TPtrArr<Material> materialArr;
+
+    std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+    bool isAnyBuilt = false;
+
+    while (!_pendingObjectQueue.empty())
+    {
+        if (isAnyBuilt)
         {
-            TPtr<Mesh> mesh = std::make_shared<Mesh>(meshResource);
-            mesh->CreateVertexBuffer(commandBuffer);
-            mesh->CreateIndexBuffer(commandBuffer);
-            meshResource->SetMesh(mesh);
+            std::chrono::duration<float, std::milli> elapsed = std::chrono::steady_clock::now() - startTime;
+            if (uploadBatch->GetPendingSize() >= _uploadByteBudget || elapsed.count() >= _uploadMillisecondBudget)
+                break;
         }
 
-        TPtr<MaterialResource> materialResource = meshComponent->GetMaterial(0);
-        if (materialResource != nullptr)
+        TPtr<SceneObject> object = _pendingObjectQueue.front().lock();
+        _pendingObjectQueue.pop_front();
+
+        if (object != nullptr)
+            isAnyBuilt |= BuildResources(object, meshArr, materialArr);
+    }
+
+    uint64_t uploadValue = asyncUploader->Submit();
+    for (TPtr<Mesh> mesh : meshArr)
+        mesh->SetUploadValue(uploadValue);
+    for (TPtr<Material> material : materialArr)
+        material->SetUploadValue(uploadValue);
+}
+
+bool ForwardRenderer::BuildResources(TPtr<SceneObject> object, TPtrArr<Mesh>& meshArr, TPtrArr<Material>& materialArr)
+{
+    TPtr<MeshComponent> meshComponent = object->GetComponent<MeshComponent>();
+    if (meshComponent == nullptr || _objectResourceMap.contains(object.get()))
+        return false;
+
+    TPtr<VulkanUploadBatch> uploadBatch = RenderSystem::Get().GetAsyncUploader()->GetBatch();
+    bool isBuilt = false;
+
+    TPtr<MeshResource> meshResource = meshComponent->GetMesh();
+    if (meshResource != nullptr && _meshRefCountMap[meshResource.get()]++ == 0)
+    {
+        TPtr<Mesh> mesh = std::make_shared<Mesh>(meshResource);
+        mesh->CreateVertexBuffer(uploadBatch);
+        mesh->CreateIndexBuffer(uploadBatch);
+        meshResource->SetMesh(mesh);
+        meshArr.push_back(mesh);
+        isBuilt = true;
+    }
+
+    TPtr<MaterialResource> materialResource = meshComponent->GetMaterial(0);
+    if (materialResource != nullptr && _materialRefCountMap[materialResource.get()]++ == 0)
+    {
+        TPtr<Material> material = std::make_shared<Material>(materialResource);
+        materialResource->SetMaterial(material);
+        materialArr.push_back(material);
+
+        for (int i = 0; i < static_cast<int>(EPassType::PassCount); i++)
         {
-            TPtr<Material> material = std::make_shared<Material>(materialResource);
-            materialResource->SetMaterial(material);
+            EPassType passType = static_cast<EPassType>(i);
 
-            for (int i = 0; i < static_cast<int>(EPassType::PassCount); i++)
+            TPtr<PassResource> passResource = materialResource->GetPass(passType);
+            if (passResource != nullptr)
             {
-                EPassType passType = static_cast<EPassType>(i);
-
-                TPtr<PassResource> passResource = materialResource->GetPass(passType);
-                if (passResource != nullptr)
-                {
-                    TPtr<Pass> pass = std::make_shared<Pass>(passResource);
-                    material->SetPass(passType, pass);
-                    pass->BuildRenderResource(commandBuffer);
-                }
+                TPtr<Pass> pass = std::make_shared<Pass>(passResource);
+                material->SetPass(passType, pass);
+                pass->BuildRenderResource(uploadBatch);
             }
         }
+        isBuilt = true;
     }
 
-    commandBuffer->End();
+    _objectResourceMap.insert(std::make_pair(object.get(), ObjectResources{meshResource, materialResource}));
+
+    if (_gpuCuller != nullptr && meshResource != nullptr && materialResource != nullptr)
+        _gpuCuller->AddObject(object, meshResource->GetMesh(), materialResource->GetMaterial());
 
-    TPtr<VulkanQueue> transferQueue = RenderSystem::Get().GetQueue(VulkanQueue::EType::Graphic);
-    VkFence fence = RenderSystem::Get().GetDevice()->CreateFence(false);
-    transferQueue->Submit(commandBuffer, {}, {}, {}, fence);
-    vkWaitForFences(RenderSystem::Get().GetDevice()->GetRawDevice(), 1, &fence, VK_TRUE, UINT64_MAX);
-    RenderSystem::Get().GetDevice()->DestroyFence(fence);
+    return isBuilt;
 }
 
-TPtrArr<SceneObject> ForwardRenderer::Prepare(TPtr<VulkanCommandBuffer> commandBuffer, TPtr<Scene> scene)
+TPtrArr<SceneObject> ForwardRenderer::Prepare(TPtr<Scene> scene)
 {
+    ZE_CPU_SCOPE("ForwardRenderer::Prepare");
+
     //Filter Objects
     const TPtrArr<SceneObject>& allObjects = scene->GetObjects();
-    TPtrArr<SceneObject> objectsToRender;
-    std::copy_if(allObjects.begin(), allObjects.end(), std::back_inserter(objectsToRender), [](TPtr<SceneObject> object) {
+    TPtrArr<SceneObject> readyObjects;
+    std::copy_if(allObjects.begin(), allObjects.end(), std::back_inserter(readyObjects), [](TPtr<SceneObject> object) {
         TPtr<MeshComponent> meshComponent = object->GetComponent<MeshComponent>();
         if (meshComponent == nullptr)
             return false;
@@ -134,146 +237,88 @@ TPtrArr<SceneObject> ForwardRenderer::Prepare(TPtr<VulkanCommandBuffer> commandB
         if (mesh == nullptr || material == nullptr)
             return false;
 
-        return true;
+        return mesh->IsReady() && material->IsReady();
     });
 
-
-    // Update Uniform Buffer
-    {
-        TPtr<CameraComponent> cameraComponent = scene->GetCamera();
-        glm::mat4x4 VP = cameraComponent->GetProjectMatrix() * cameraComponent->GetViewMatrix();
-
-        for (TPtr<SceneObject>& object : objectsToRender)
-        {
-            TPtr<MeshComponent> meshComponent = object->GetComponent<MeshComponent>();
-
-            TPtr<MeshResource> meshResource = meshComponent->GetMesh();
-            TPtr<MaterialResource> materialResource = meshComponent->GetMaterial(0);
-
-            TPtr<Mesh> mesh = meshResource->GetMesh();
-            TPtr<Material> material = materialResource->GetMaterial();
-
-            TPtr<TransformComponent> transformComponent = object->GetComponent<TransformComponent>();
-            glm::mat4x4 MVP = VP * transformComponent->GetTransform();
-
-            for (int i = 0; i < static_cast<int>(EPassType::PassCount); i++)
-            {
-                EPassType passType = static_cast<EPassType>(i);
-
-                TPtr<Pass> pass = material->GetPass(passType);
-                if (pass)
-                {
-                    // Update Global DescriptorSet
-                    pass->UpdateUniformBuffer(commandBuffer, MVP);
-                }
-            }
-        }
-    }
+    TPtrArr<SceneObject> objectsToRender;
+    _frustumCuller->Cull(scene->GetCamera()->GetFrustum(), readyObjects, objectsToRender);
 
     return objectsToRender;
 }
 
-void ForwardRenderer::SetupFrame(TPtr<VulkanCommandBuffer> commandBuffer, TPtr<Frame> frame)
+TPtr<FrustumCuller> ForwardRenderer::GetFrustumCuller()
 {
-    TPtr<VulkanDevice> device = commandBuffer->GetDevice();
-
-    //Depth Pass
-    TPtr<VulkanImage> depthImage = std::make_shared<VulkanImage>(device, frame->GetExtent(), VkFormat::VK_FORMAT_D32_SFLOAT, VkImageUsageFlagBits::VK_IMAGE_USAGE_TRANSFER_DST_BIT | VkImageUsageFlagBits::VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT);
-    TPtr<VulkanImageView> depthImageView = std::make_shared<VulkanImageView>(depthImage, VkFormat::VK_FORMAT_D32_SFLOAT, VkImageAspectFlagBits::VK_IMAGE_ASPECT_DEPTH_BIT);
-    TPtr<RenderTargets> depthRenderTargets = std::make_shared<RenderTargets>();
-    depthRenderTargets->depthStencil = RenderTargetBinding{depthImageView, ERenderTargetLoadAction::Clear};
-
-    _depthPass->Setup(depthImageView);
-
-    TPtr<RenderTargets> lightingRenderTargets = std::make_shared<RenderTargets>();
-    lightingRenderTargets->colors = {RenderTargetBinding{frame->GetFrameBuffer(), ERenderTargetLoadAction::Clear}};
-    lightingRenderTargets->depthStencil = RenderTargetBinding{depthImageView, ERenderTargetLoadAction::Load};
-
-    _directionalLightPass->Setup(frame->GetFrameBuffer(), depthImageView);
+    return _frustumCuller;
 }
 
-void ForwardRenderer::RenderFrame(TPtr<VulkanCommandBuffer> commandBuffer, TPtr<Scene> scene, TPtr<Frame> frame)
+TPtr<GpuCuller> ForwardRenderer::GetGpuCuller()
 {
-    TPtr<VulkanDevice> device = commandBuffer->GetDevice();
+    return _gpuCuller;
+}
 
-    commandBuffer->Begin();
+void ForwardRenderer::SetupFrame(RenderGraph& graph, TPtr<Frame> frame, const TPtrArr<SceneObject>& objectsToRender)
+{
+    RenderGraphTextureHandle backBuffer = graph.ImportTexture("BackBuffer", frame->GetFrameBuffer(), frame->GetFinalLayout());
+    RenderGraphTextureHandle sceneDepth = graph.CreateTexture("SceneDepth", RenderGraphTextureDesc{frame->GetExtent(), VkFormat::VK_FORMAT_D32_SFLOAT, VkImageAspectFlagBits::VK_IMAGE_ASPECT_DEPTH_BIT});
 
-    TPtrArr<SceneObject> objectsToRender = Prepare(commandBuffer, scene);
+    _depthPass->Setup(graph, sceneDepth, objectsToRender);
 
-    for (TPtr<RenderPass>& renderPass : _passes)
+    // The depth pass drew everything inside the frustum, the lighting pass only draws what its depth doesn't hide
+    if (_gpuCuller != nullptr)
     {
-        RenderTargets renderTargets = renderPass->GetRenderTargets();
+        graph.AddPass("HiZCull", [this, &graph, sceneDepth](const RenderGraphPassContext& context) {
+            uint32_t frameIndex = context.frame->GetIndex();
+            _hiZPyramid->Build(context.commandBuffer, frameIndex, graph.GetImageView(sceneDepth));
+            _gpuCuller->DispatchOcclusion(context.commandBuffer, frameIndex);
+        }).ReadTexture(sceneDepth);
+    }
 
-        VkExtent3D extent3D = renderTargets.colors.empty() ? renderTargets.depthStencil.value().target->GetExtent() : renderTargets.colors[0].target->GetExtent();
-        VkExtent2D extent2D{extent3D.width, extent3D.height};
+    _directionalLightPass->Setup(graph, backBuffer, sceneDepth, objectsToRender);
+}
 
-        TPtrArr<VulkanImageView> framebufferImageArr;
-        std::vector<VkAttachmentDescription> colorAttachmentArr;
-        std::vector<VkClearValue> clearValues;
+void ForwardRenderer::RenderFrame(TPtr<VulkanCommandBuffer> commandBuffer, TPtr<Scene> scene, TPtr<Frame> frame)
+{
+    ZE_CPU_SCOPE("ForwardRenderer::RenderFrame");
 
-        TPtr<VulkanRenderPass> vkRenderPass;
-        for (auto& bindings : renderTargets.colors)
-        {
-            TPtr<VulkanImageView> imageView = bindings.target;
-
-            VkAttachmentDescription attachment{};
-            attachment.format = imageView->GetImage()->GetFormat();
-            attachment.samples = VK_SAMPLE_COUNT_1_BIT;
-            attachment.loadOp = ConvertRenderTargetLoadActionToVulkan(bindings.loadAction);
-            attachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
-            attachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
-            attachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-            attachment.initialLayout = imageView->GetImage()->GetLayout();
-            attachment.finalLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
-
-            colorAttachmentArr.emplace_back(attachment);
-            framebufferImageArr.emplace_back(imageView);
-
-            VkClearValue clearValue;
-            clearValue.color = {0.0f, 0.0f, 0.0f, 0.0f};
-            clearValues.push_back(clearValue);
-
-            imageView->GetImage()->SetLayout(VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
-        }
+    BuildPendingResources();
 
-        if (renderTargets.depthStencil.has_value())
-        {
-            RenderTargetBinding& depthBinding = renderTargets.depthStencil.value();
-            VkAttachmentDescription depthAttachment{};
-            depthAttachment.format = depthBinding.target->GetFormat();
-            depthAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
-            depthAttachment.loadOp = ConvertRenderTargetLoadActionToVulkan(depthBinding.loadAction);
-            depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
-            depthAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
-            depthAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-            depthAttachment.initialLayout = depthBinding.target->GetImage()->GetLayout();
-            depthAttachment.finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
-
-            vkRenderPass = std::make_shared<VulkanRenderPass>(device, colorAttachmentArr, depthAttachment);
-            framebufferImageArr.emplace_back(renderTargets.depthStencil.value().target);
-
-            VkClearValue clearValue;
-            clearValue.depthStencil.depth = 0.0f;
-            clearValue.depthStencil.stencil = 0;
-            clearValues.push_back(clearValue);
-
-            depthBinding.target->GetImage()->SetLayout(VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL);
-        }
-        else
-        {
-            vkRenderPass = std::make_shared<VulkanRenderPass>(device, colorAttachmentArr);
-        }
+    commandBuffer->Begin();
 
-        TPtr<VulkanFramebuffer> framebuffer = std::make_shared<VulkanFramebuffer>(device, vkRenderPass, framebufferImageArr, extent2D);
-        frame->PutFramebuffer(framebuffer);
-        commandBuffer->BeginRenderPass(vkRenderPass, framebuffer, {{0, 0}, extent2D}, clearValues);
+#ifdef ZE_GPU_PROFILER
+    if (GpuProfiler* gpuProfiler = GpuProfiler::TryGet())
+        gpuProfiler->BeginFrame(commandBuffer, frame->GetIndex());
+#endif
 
-        renderPass->Execute(objectsToRender, commandBuffer, frame->GetViewport());
+    // Takes over whatever the transfer queue finished since the last frame, before readiness is checked
+    TPtr<VulkanAsyncUploader> asyncUploader = RenderSystem::Get().GetAsyncUploader();
+    uint64_t acquiredValue = asyncUploader->RecordAcquire(commandBuffer);
+    if (acquiredValue > 0)
+        frame->AddWaitSemaphore(asyncUploader->GetTimelineSemaphore()->GetRawSemaphore(), VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, acquiredValue);
 
-        commandBuffer->EndRenderPass();
-    }
+    TPtr<CameraComponent> cameraComponent = scene->GetCamera();
+    glm::mat4x4 VP = cameraComponent->GetProjectMatrix() * cameraComponent->GetViewMatrix();
+    _depthPass->SetViewProjection(VP);
+    _directionalLightPass->SetViewProjection(VP);
 
-    frame->GetFrameBuffer()->GetImage()->TransitionLayout(commandBuffer, VkImageLayout::VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VkImageLayout::VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
+    // The GPU culler's passes draw its groups, they need no object list
+    TPtrArr<SceneObject> objectsToRender;
+    if (_gpuCuller != nullptr)
+    {
+        _hiZPyramid->Resize(commandBuffer, frame->GetExtent());
+        _gpuCuller->Dispatch(commandBuffer, frame->GetIndex(), VP, cameraComponent->GetFrustum());
+    }
+    else
+        objectsToRender = Prepare(scene);
+
+    RenderGraph graph;
+    SetupFrame(graph, frame, objectsToRender);
+    graph.Compile();
+    graph.Execute(commandBuffer, frame);
+
+#ifdef ZE_GPU_PROFILER
+    if (GpuProfiler* gpuProfiler = GpuProfiler::TryGet())
+        gpuProfiler->EndFrame();
+#endif
 
     commandBuffer->End();
 }
@@ -1,38 +1,177 @@
 #include "Frame.h"
 #include "RenderSystem.h"
-#include "RenderTargets.h"
 #include "Graphic/VulkanDevice.h"
 #include "Graphic/VulkanSwapchain.h"
+#include "Graphic/VulkanImage.h"
 #include "Graphic/VulkanImageView.h"
-#include "Graphic/VulkanCommandBufferManager.h"
+#include "Graphic/VulkanBuffer.h"
+#include "Graphic/VulkanFramebuffer.h"
+#include "Graphic/VulkanCommandPool.h"
+#include "Graphic/VulkanCommandBuffer.h"
+#include "Graphic/VulkanRingBuffer.h"
+#include "Graphic/VulkanTimelineSemaphore.h"
+#include "Debug/CpuProfiler.h"
+#include "Job/JobSystem.h"
+
+#include <stdexcept>
 
 namespace ZE {
 
-Frame::Frame(TPtr<VulkanDevice> device, TPtr<VulkanSwapchain> swapchain)
-    : _cachedDevice(device)
+Frame::Frame(TPtr<VulkanDevice> device, uint32_t index)
+    : _index(index), _cachedDevice(device), _renderTarget(nullptr), _isHeadless(false), _extent{0, 0, 0}, _timelineValue(0),
+      _readbackFrameNumber(0), _hasPendingReadback(false)
 {
     _imageAvailableSemaphore = device->CreateGraphicSemaphore();
-    _fence = device->CreateFence(false);
+    _renderFinishedSemaphore = device->CreateGraphicSemaphore();
+
+    _commandPool = std::make_shared<VulkanCommandPool>(device, device->GetGraphicQueueFamilyIndex(), VK_COMMAND_POOL_CREATE_TRANSIENT_BIT);
+    _cachedCommandBuffer = std::make_shared<VulkanCommandBuffer>(_commandPool);
+
+    _threadCommandPoolArr.resize(JobSystem::Get().GetThreadCount());
+}
+
+Frame::~Frame()
+{
+    FlushReadback();
+    ReleaseResources();
+
+    _readbackCommandBuffer.reset();
+    _readbackBuffer.reset();
+    _cachedCommandBuffer.reset();
+    _commandPool.reset();
+    _threadCommandPoolArr.clear();
+
+    _cachedDevice->DestroyGraphicSemaphore(_renderFinishedSemaphore);
+    _cachedDevice->DestroyGraphicSemaphore(_imageAvailableSemaphore);
+}
 
+bool Frame::Begin(TPtr<VulkanSwapchain> swapchain)
+{
+    FlushReadback();
+    ReleaseResources();
+
+    ZE_CPU_SCOPE("VulkanSwapchain::AcquireNextImage");
     TPtr<VulkanImage> sceneImage = swapchain->AcquireNextImage(UINT64_MAX, _imageAvailableSemaphore, VK_NULL_HANDLE);
-    _renderTarget = std::make_shared<VulkanImageView>(sceneImage);
+    if (sceneImage == nullptr)
+        return false;
+
+    _isHeadless = false;
+    _renderTarget = swapchain->GetImageView(swapchain->GetCurrentAcquiredIndex());
+    BeginInternal();
 
+    AddWaitSemaphore(_imageAvailableSemaphore, VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT);
+
+    return true;
+}
+
+void Frame::Begin(TPtr<VulkanImageView> renderTarget)
+{
+    FlushReadback();
+    ReleaseResources();
+
+    _isHeadless = true;
+    _renderTarget = renderTarget;
+    BeginInternal();
+}
+
+void Frame::BeginInternal()
+{
     _extent = _renderTarget->GetExtent();
 
-    _cachedCommandBuffer = RenderSystem::Get().GetCommandBufferManager()->GetCommandBuffer(VulkanQueue::EType::Graphic);
+    _waitArr.clear();
+
+    // Only taken once we know a submission will follow, otherwise the next Begin would wait forever
+    _timelineValue = RenderSystem::Get().GetFrameValue();
+    _commandPool->Reset();
+
+    for (ThreadCommandPool& threadCommandPool : _threadCommandPoolArr)
+    {
+        if (threadCommandPool.commandPool == nullptr)
+            continue;
+
+        threadCommandPool.commandPool->Reset();
+        threadCommandPool.usedCount = 0;
+    }
+
+    // The timeline wait in Begin retired the last frame that wrote this slot's uniforms
+    RenderSystem::Get().GetUniformRingBuffer()->BeginRegion(_index);
 }
 
-Frame::~Frame()
+TPtr<VulkanCommandBuffer> Frame::RecordReadback(uint64_t frameNumber, ReadbackCallback callback)
+{
+    if (!_isHeadless)
+        throw std::runtime_error("readback is only supported for headless frames!");
+
+    TPtr<VulkanImage> image = _renderTarget->GetImage();
+    uint32_t size = _extent.width * _extent.height * 4;
+
+    if (_readbackBuffer == nullptr || _readbackBuffer->GetSize() != size)
+        _readbackBuffer = std::make_shared<VulkanBuffer>(_cachedDevice, size, VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+
+    if (_readbackCommandBuffer == nullptr)
+        _readbackCommandBuffer = std::make_shared<VulkanCommandBuffer>(_commandPool);
+
+    _readbackCommandBuffer->Begin();
+    image->CopyToBuffer(_readbackCommandBuffer, _readbackBuffer, {0, 0, 0}, _extent);
+    _readbackCommandBuffer->End();
+
+    _readbackFrameNumber = frameNumber;
+    _readbackCallback = callback;
+    _hasPendingReadback = true;
+
+    return _readbackCommandBuffer;
+}
+
+void Frame::FlushReadback()
 {
-    RenderSystem::Get().GetDevice()->DestroyFence(_fence);
-    RenderSystem::Get().GetDevice()->DestroyGraphicSemaphore(_imageAvailableSemaphore);
+    WaitForCompletion();
 
-    for (VkSemaphore sem : _semaphoreArr)
+    if (!_hasPendingReadback)
+        return;
+
+    _hasPendingReadback = false;
+
+    if (_readbackCallback)
     {
-        RenderSystem::Get().GetDevice()->DestroyGraphicSemaphore(sem);
+        void* data = _readbackBuffer->MapMemory(0, _readbackBuffer->GetSize());
+        _readbackCallback(_readbackFrameNumber, data, _extent, _renderTarget->GetImage()->GetFormat());
+        _readbackBuffer->UnmapMemory();
     }
 }
 
+bool Frame::IsHeadless()
+{
+    return _isHeadless;
+}
+
+VkImageLayout Frame::GetFinalLayout()
+{
+    return _isHeadless ? VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL : VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+}
+
+void Frame::WaitForCompletion()
+{
+    ZE_CPU_SCOPE("Frame::WaitForCompletion");
+    RenderSystem::Get().GetFrameTimeline()->Wait(_timelineValue);
+}
+
+void Frame::ReleaseResources()
+{
+    _framebufferArr.clear();
+    _imageViewArr.clear();
+    _renderTarget.reset();
+}
+
+uint32_t Frame::GetIndex()
+{
+    return _index;
+}
+
+const glm::ivec2 Frame::GetViewport()
+{
+    return glm::ivec2{_extent.width, _extent.height};
+}
+
 TPtr<VulkanImageView> Frame::GetFrameBuffer()
 {
     return _renderTarget;
@@ -48,9 +187,24 @@ VkSemaphore Frame::GetAvailableSemaphore()
     return _imageAvailableSemaphore;
 }
 
-VkFence Frame::GetFence()
+VkSemaphore Frame::GetRenderFinishedSemaphore()
+{
+    return _renderFinishedSemaphore;
+}
+
+uint64_t Frame::GetTimelineValue()
+{
+    return _timelineValue;
+}
+
+void Frame::AddWaitSemaphore(VkSemaphore semaphore, VkPipelineStageFlags2 stage, uint64_t value)
+{
+    _waitArr.push_back({semaphore, value, stage});
+}
+
+const std::vector<VulkanSemaphoreSubmit>& Frame::GetWaitArr()
 {
-    return _fence;
+    return _waitArr;
 }
 
 TPtr<VulkanCommandBuffer> Frame::GetCachedCommandBuffer()
@@ -58,6 +212,22 @@ TPtr<VulkanCommandBuffer> Frame::GetCachedCommandBuffer()
     return _cachedCommandBuffer;
 }
 
+TPtr<VulkanCommandBuffer> Frame::GetSecondaryCommandBuffer()
+{
+    uint32_t threadIndex = JobSystem::Get().GetThreadIndex();
+    if (threadIndex >= _threadCommandPoolArr.size())
+        throw std::runtime_error("secondary command buffers can only be recorded on job threads!");
+
+    ThreadCommandPool& threadCommandPool = _threadCommandPoolArr[threadIndex];
+    if (threadCommandPool.commandPool == nullptr)
+        threadCommandPool.commandPool = std::make_shared<VulkanCommandPool>(_cachedDevice, _cachedDevice->GetGraphicQueueFamilyIndex(), VK_COMMAND_POOL_CREATE_TRANSIENT_BIT);
+
+    if (threadCommandPool.usedCount == threadCommandPool.commandBufferArr.size())
+        threadCommandPool.commandBufferArr.push_back(std::make_shared<VulkanCommandBuffer>(threadCommandPool.commandPool, VK_COMMAND_BUFFER_LEVEL_SECONDARY));
+
+    return threadCommandPool.commandBufferArr[threadCommandPool.usedCount++];
+}
+
 void Frame::PutImage(TPtr<VulkanImageView> imageView)
 {
     _imageViewArr.push_back(imageView);
@@ -68,8 +238,4 @@ void Frame::PutFramebuffer(TPtr<VulkanFramebuffer> framebuffer)
     _framebufferArr.push_back(framebuffer);
 }
 
-void Frame::PutSemaphore(VkSemaphore sem)
-{
-    _semaphoreArr.push_back(sem);
-}
 } // namespace ZE
\ No newline at end of file
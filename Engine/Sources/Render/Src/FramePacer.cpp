@@ -0,0 +1,118 @@
+#include "FramePacer.h"
+#include "RenderSystem.h"
+#include "Graphic/VulkanDevice.h"
+#include "Graphic/VulkanSwapchain.h"
+#include "Graphic/VulkanTimelineSemaphore.h"
+#include "Debug/CpuProfiler.h"
+
+#include <thread>
+
+
+namespace ZE {
+
+// The tail of a limiter wait is spun, sleeping that close to the deadline risks overshooting it
+const std::chrono::microseconds LimiterSpinDuration(1000);
+
+// Nanoseconds, a minimized window may never present
+const uint64_t PresentWaitTimeout = 100 * 1000 * 1000;
+
+FramePacer::FramePacer(TPtr<VulkanSwapchain> swapchain)
+    : _swapchain(swapchain), _isPresentWaitEnabled(false), _maxQueuedFrames(0), _lastPresentId(0),
+      _frameInterval(0), _queueWaitTime(0), _limiterWaitTime(0)
+{
+    _isPresentWaitEnabled = swapchain != nullptr && RenderSystem::Get().GetDevice()->IsPresentWaitSupported();
+}
+
+FramePacer::~FramePacer()
+{
+}
+
+void FramePacer::SetMaxFrameRate(float frameRate)
+{
+    if (frameRate > 0.0f)
+        _frameInterval = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(1.0 / frameRate));
+    else
+        _frameInterval = std::chrono::steady_clock::duration(0);
+}
+
+void FramePacer::SetMaxQueuedFrames(uint32_t maxQueuedFrames)
+{
+    _maxQueuedFrames = maxQueuedFrames;
+}
+
+void FramePacer::WaitForNextFrame()
+{
+    ZE_CPU_SCOPE("FramePacer::WaitForNextFrame");
+
+    std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+    WaitForQueue();
+
+    std::chrono::steady_clock::time_point queueTime = std::chrono::steady_clock::now();
+    _queueWaitTime += queueTime - startTime;
+
+    WaitForLimiter(queueTime);
+    _limiterWaitTime += std::chrono::steady_clock::now() - queueTime;
+}
+
+void FramePacer::WaitForQueue()
+{
+    if (_maxQueuedFrames == 0)
+        return;
+
+    // The frame about to start is the last one allowed in the queue
+    if (_isPresentWaitEnabled)
+    {
+        if (_lastPresentId >= _maxQueuedFrames)
+            _swapchain->WaitForPresent(_lastPresentId + 1 - _maxQueuedFrames, PresentWaitTimeout);
+
+        return;
+    }
+
+    // Without present wait, GPU completion is the closest observable point
+    uint64_t frameValue = RenderSystem::Get().GetFrameValue();
+    if (frameValue > _maxQueuedFrames)
+        RenderSystem::Get().GetFrameTimeline()->Wait(frameValue - _maxQueuedFrames);
+}
+
+void FramePacer::WaitForLimiter(std::chrono::steady_clock::time_point now)
+{
+    if (_frameInterval.count() == 0)
+        return;
+
+    // More than a frame behind, catching up would only produce a burst of frames
+    if (now > _nextFrameTime + _frameInterval)
+        _nextFrameTime = now;
+
+    if (now + LimiterSpinDuration < _nextFrameTime)
+        std::this_thread::sleep_for(_nextFrameTime - LimiterSpinDuration - now);
+
+    while (std::chrono::steady_clock::now() < _nextFrameTime)
+        std::this_thread::yield();
+
+    _nextFrameTime += _frameInterval;
+}
+
+uint64_t FramePacer::NextPresentId()
+{
+    if (!_isPresentWaitEnabled)
+        return 0;
+
+    return ++_lastPresentId;
+}
+
+bool FramePacer::IsPresentWaitEnabled()
+{
+    return _isPresentWaitEnabled;
+}
+
+double FramePacer::GetQueueWaitTime()
+{
+    return _queueWaitTime.count();
+}
+
+double FramePacer::GetLimiterWaitTime()
+{
+    return _limiterWaitTime.count();
+}
+
+} // namespace ZE
\ No newline at end of file
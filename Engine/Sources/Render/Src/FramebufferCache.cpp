@@ -0,0 +1,88 @@
+#include "FramebufferCache.h"
+#include "Graphic/VulkanDevice.h"
+#include "Graphic/VulkanRenderPass.h"
+#include "Graphic/VulkanImageView.h"
+#include "Graphic/VulkanFramebuffer.h"
+
+
+namespace ZE {
+
+FramebufferCache::FramebufferCache(TPtr<VulkanDevice> device, uint64_t evictAfterFrames)
+    : _device(device), _frame(0), _evictAfterFrames(evictAfterFrames), _hitCount(0), _missCount(0)
+{
+}
+
+FramebufferCache::~FramebufferCache()
+{
+    Clear();
+}
+
+TPtr<VulkanFramebuffer> FramebufferCache::GetOrCreate(TPtr<VulkanRenderPass> renderPass, const TPtrArr<VulkanImageView>& imageViewArr, const VkExtent2D& extent)
+{
+    // Addresses are only used to find the entry, a reused address is caught by IsAttachedTo
+    HashWriter writer;
+    writer.Write(reinterpret_cast<uintptr_t>(renderPass.get()));
+    writer.Write(static_cast<uint32_t>(imageViewArr.size()));
+    for (const TPtr<VulkanImageView>& imageView : imageViewArr)
+        writer.Write(reinterpret_cast<uintptr_t>(imageView.get()));
+    writer.Write(extent);
+
+    HashKey key(writer);
+
+    auto iter = _entries.find(key);
+    if (iter != _entries.end())
+    {
+        TPtr<VulkanFramebuffer> framebuffer = iter->second.framebuffer;
+        if (framebuffer->GetRenderPass() == renderPass && framebuffer->IsAttachedTo(imageViewArr))
+        {
+            _hitCount++;
+            iter->second.lastUsedFrame = _frame;
+            return framebuffer;
+        }
+
+        _entries.erase(iter);
+    }
+
+    _missCount++;
+
+    TPtr<VulkanFramebuffer> framebuffer = std::make_shared<VulkanFramebuffer>(_device, renderPass, imageViewArr, extent);
+    _entries.emplace(std::move(key), Entry{framebuffer, _frame});
+
+    return framebuffer;
+}
+
+void FramebufferCache::Tick()
+{
+    _frame++;
+
+    // In flight frames hold their framebuffers, so dropping an entry here never destroys one in use
+    for (auto iter = _entries.begin(); iter != _entries.end();)
+    {
+        if (!iter->second.framebuffer->IsValid() || _frame - iter->second.lastUsedFrame > _evictAfterFrames)
+            iter = _entries.erase(iter);
+        else
+            iter++;
+    }
+}
+
+void FramebufferCache::Clear()
+{
+    _entries.clear();
+}
+
+uint64_t FramebufferCache::GetHitCount()
+{
+    return _hitCount;
+}
+
+uint64_t FramebufferCache::GetMissCount()
+{
+    return _missCount;
+}
+
+size_t FramebufferCache::GetSize()
+{
+    return _entries.size();
+}
+
+} // namespace ZE
\ No newline at end of file
@@ -0,0 +1,209 @@
+#include "FrustumCuller.h"
+#include "Resource/MeshResource.h"
+#include "Scene/SceneObject.h"
+#include "Scene/MeshComponent.h"
+#include "Scene/TransformComponent.h"
+#include "Job/JobSystem.h"
+#include "Debug/CpuProfiler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#if defined(__AVX__)
+    #include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define ZE_CULL_SSE
+    #include <emmintrin.h>
+#endif
+
+
+namespace ZE {
+
+const size_t CullBlockSize = 8;
+
+// Blocks per job range, smaller scenes are culled on the calling thread
+const size_t MinCullGrainBlocks = 64;
+
+struct CullPlanes
+{
+    float normalX[6];
+    float normalY[6];
+    float normalZ[6];
+    float distance[6];
+};
+
+// Writes 1 for every object of the block that is inside or crossing all planes
+void TestBlock(const CullPlanes& planes, const float* centerX, const float* centerY, const float* centerZ,
+               const float* extentX, const float* extentY, const float* extentZ, const float* radius, uint8_t* visible)
+{
+#if defined(__AVX__)
+    __m256 cx = _mm256_loadu_ps(centerX);
+    __m256 cy = _mm256_loadu_ps(centerY);
+    __m256 cz = _mm256_loadu_ps(centerZ);
+    __m256 ex = _mm256_loadu_ps(extentX);
+    __m256 ey = _mm256_loadu_ps(extentY);
+    __m256 ez = _mm256_loadu_ps(extentZ);
+    __m256 r = _mm256_loadu_ps(radius);
+
+    __m256 outside = _mm256_setzero_ps();
+    for (uint32_t i = 0; i < 6; i++)
+    {
+        __m256 nx = _mm256_set1_ps(planes.normalX[i]);
+        __m256 ny = _mm256_set1_ps(planes.normalY[i]);
+        __m256 nz = _mm256_set1_ps(planes.normalZ[i]);
+
+        __m256 distance = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(nx, cx), _mm256_mul_ps(ny, cy)), _mm256_add_ps(_mm256_mul_ps(nz, cz), _mm256_set1_ps(planes.distance[i])));
+        __m256 reach = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(std::abs(planes.normalX[i])), ex), _mm256_mul_ps(_mm256_set1_ps(std::abs(planes.normalY[i])), ey)), _mm256_mul_ps(_mm256_set1_ps(std::abs(planes.normalZ[i])), ez));
+        reach = _mm256_min_ps(reach, r);
+
+        outside = _mm256_or_ps(outside, _mm256_cmp_ps(_mm256_add_ps(distance, reach), _mm256_setzero_ps(), _CMP_LT_OQ));
+    }
+
+    int outsideMask = _mm256_movemask_ps(outside);
+    for (size_t i = 0; i < CullBlockSize; i++)
+        visible[i] = ((outsideMask >> i) & 1) == 0;
+#elif defined(ZE_CULL_SSE)
+    for (size_t half = 0; half < CullBlockSize; half += 4)
+    {
+        __m128 cx = _mm_loadu_ps(centerX + half);
+        __m128 cy = _mm_loadu_ps(centerY + half);
+        __m128 cz = _mm_loadu_ps(centerZ + half);
+        __m128 ex = _mm_loadu_ps(extentX + half);
+        __m128 ey = _mm_loadu_ps(extentY + half);
+        __m128 ez = _mm_loadu_ps(extentZ + half);
+        __m128 r = _mm_loadu_ps(radius + half);
+
+        __m128 outside = _mm_setzero_ps();
+        for (uint32_t i = 0; i < 6; i++)
+        {
+            __m128 nx = _mm_set1_ps(planes.normalX[i]);
+            __m128 ny = _mm_set1_ps(planes.normalY[i]);
+            __m128 nz = _mm_set1_ps(planes.normalZ[i]);
+
+            __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, cx), _mm_mul_ps(ny, cy)), _mm_add_ps(_mm_mul_ps(nz, cz), _mm_set1_ps(planes.distance[i])));
+            __m128 reach = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(std::abs(planes.normalX[i])), ex), _mm_mul_ps(_mm_set1_ps(std::abs(planes.normalY[i])), ey)), _mm_mul_ps(_mm_set1_ps(std::abs(planes.normalZ[i])), ez));
+            reach = _mm_min_ps(reach, r);
+
+            outside = _mm_or_ps(outside, _mm_cmplt_ps(_mm_add_ps(distance, reach), _mm_setzero_ps()));
+        }
+
+        int outsideMask = _mm_movemask_ps(outside);
+        for (size_t i = 0; i < 4; i++)
+            visible[half + i] = ((outsideMask >> i) & 1) == 0;
+    }
+#else
+    for (size_t j = 0; j < CullBlockSize; j++)
+    {
+        bool isOutside = false;
+        for (uint32_t i = 0; i < 6; i++)
+        {
+            float distance = planes.normalX[i] * centerX[j] + planes.normalY[i] * centerY[j] + planes.normalZ[i] * centerZ[j] + planes.distance[i];
+            float reach = std::abs(planes.normalX[i]) * extentX[j] + std::abs(planes.normalY[i]) * extentY[j] + std::abs(planes.normalZ[i]) * extentZ[j];
+            isOutside |= distance + std::min(reach, radius[j]) < 0.0f;
+        }
+
+        visible[j] = !isOutside;
+    }
+#endif
+}
+
+FrustumCuller::FrustumCuller() : _testedCount(0), _culledCount(0)
+{
+}
+
+FrustumCuller::~FrustumCuller()
+{
+}
+
+void FrustumCuller::Cull(const Frustum& frustum, const TPtrArr<SceneObject>& objects, TPtrArr<SceneObject>& visibleObjects)
+{
+    ZE_CPU_SCOPE("FrustumCuller::Cull");
+
+    size_t blockCount = (objects.size() + CullBlockSize - 1) / CullBlockSize;
+    size_t paddedCount = blockCount * CullBlockSize;
+    for (std::vector<float>* stream : {&_centerX, &_centerY, &_centerZ, &_extentX, &_extentY, &_extentZ, &_radius})
+        stream->resize(paddedCount);
+    _visibleArr.resize(paddedCount);
+
+    CullPlanes planes;
+    for (uint32_t i = 0; i < 6; i++)
+    {
+        planes.normalX[i] = frustum.planes[i].x;
+        planes.normalY[i] = frustum.planes[i].y;
+        planes.normalZ[i] = frustum.planes[i].z;
+        planes.distance[i] = frustum.planes[i].w;
+    }
+
+    // Gathered and tested per range, the blocks are still in cache when they are tested
+    JobSystem::Get().ParallelFor(blockCount, [this, &objects, &planes](size_t beginBlock, size_t endBlock) {
+        GatherBlocks(objects, beginBlock, endBlock);
+
+        for (size_t block = beginBlock; block < endBlock; block++)
+        {
+            size_t first = block * CullBlockSize;
+            TestBlock(planes, &_centerX[first], &_centerY[first], &_centerZ[first], &_extentX[first], &_extentY[first], &_extentZ[first], &_radius[first], &_visibleArr[first]);
+        }
+    }, MinCullGrainBlocks);
+
+    visibleObjects.clear();
+    visibleObjects.reserve(objects.size());
+    for (size_t i = 0; i < objects.size(); i++)
+    {
+        if (_visibleArr[i])
+            visibleObjects.push_back(objects[i]);
+    }
+
+    _testedCount += objects.size();
+    _culledCount += objects.size() - visibleObjects.size();
+}
+
+void FrustumCuller::GatherBlocks(const TPtrArr<SceneObject>& objects, size_t beginBlock, size_t endBlock)
+{
+    size_t end = std::min(endBlock * CullBlockSize, objects.size());
+    for (size_t i = beginBlock * CullBlockSize; i < endBlock * CullBlockSize; i++)
+    {
+        TPtr<MeshResource> meshResource = i < end ? objects[i]->GetComponent<MeshComponent>()->GetMesh() : nullptr;
+
+        // Padding, and meshes without bounds, are never culled
+        if (meshResource == nullptr || meshResource->GetMeshCount() == 0)
+        {
+            _centerX[i] = _centerY[i] = _centerZ[i] = 0.0f;
+            _extentX[i] = _extentY[i] = _extentZ[i] = std::numeric_limits<float>::max();
+            _radius[i] = std::numeric_limits<float>::max();
+            continue;
+        }
+
+        // Only the first submesh is drawn
+        const MeshBounds& bounds = meshResource->GetBounds(0);
+
+        TPtr<TransformComponent> transformComponent = objects[i]->GetComponent<TransformComponent>();
+        glm::mat4x4 transform = transformComponent != nullptr ? transformComponent->GetRenderTransform() : glm::mat4x4(1.0f);
+
+        glm::vec3 center = glm::vec3(transform * glm::vec4(bounds.center, 1.0f));
+        _centerX[i] = center.x;
+        _centerY[i] = center.y;
+        _centerZ[i] = center.z;
+
+        // Box of the rotated box, the absolute matrix maps half extents to half extents
+        glm::vec3 extent = (bounds.max - bounds.min) * 0.5f;
+        _extentX[i] = std::abs(transform[0][0]) * extent.x + std::abs(transform[1][0]) * extent.y + std::abs(transform[2][0]) * extent.z;
+        _extentY[i] = std::abs(transform[0][1]) * extent.x + std::abs(transform[1][1]) * extent.y + std::abs(transform[2][1]) * extent.z;
+        _extentZ[i] = std::abs(transform[0][2]) * extent.x + std::abs(transform[1][2]) * extent.y + std::abs(transform[2][2]) * extent.z;
+
+        float scale = std::max({glm::length(glm::vec3(transform[0])), glm::length(glm::vec3(transform[1])), glm::length(glm::vec3(transform[2]))});
+        _radius[i] = bounds.radius * scale;
+    }
+}
+
+uint64_t FrustumCuller::GetTestedCount()
+{
+    return _testedCount;
+}
+
+uint64_t FrustumCuller::GetCulledCount()
+{
+    return _culledCount;
+}
+
+} // namespace ZE
\ No newline at end of file
@@ -0,0 +1,368 @@
+#include "GpuCuller.h"
+#include "Mesh.h"
+#include "Material.h"
+#include "HiZPyramid.h"
+#include "RenderSystem.h"
+#include "Resource/ShaderResource.h"
+#include "Resource/MeshResource.h"
+#include "Scene/SceneObject.h"
+#include "Scene/MeshComponent.h"
+#include "Scene/TransformComponent.h"
+#include "Graphic/VulkanDevice.h"
+#include "Graphic/VulkanBuffer.h"
+#include "Graphic/VulkanCommandBuffer.h"
+#include "Graphic/VulkanImageView.h"
+#include "Graphic/VulkanSampler.h"
+#include "Graphic/VulkanShader.h"
+#include "Graphic/VulkanDescriptorPool.h"
+#include "Graphic/VulkanDescriptorSetLayout.h"
+#include "Graphic/VulkanDescriptorSet.h"
+#include "Graphic/VulkanPipelineLayout.h"
+#include "Graphic/VulkanPipeline.h"
+#include "Graphic/VulkanPipelineCache.h"
+#include "Job/JobSystem.h"
+#include "Debug/CpuProfiler.h"
+#include "Debug/GpuProfiler.h"
+
+#include <algorithm>
+#include <bit>
+#include <iterator>
+
+
+namespace ZE {
+
+// Has to match local_size_x of the cull shader
+const uint32_t CullGroupSize = 64;
+
+// Objects written per job range, smaller scenes are written on the calling thread
+const size_t MinObjectWriteGrainSize = 1024;
+
+// Layouts of the cull shader's buffers
+struct GpuCullView
+{
+    glm::mat4x4 viewProjection;
+    glm::vec4 frustumPlanes[6];
+};
+
+struct GpuCullObject
+{
+    glm::mat4x4 transform;
+    glm::vec4 sphere;
+    glm::vec3 extent;
+    uint32_t groupIndex;
+};
+
+struct GpuCullConstants
+{
+    uint32_t objectCount;
+    uint32_t isOcclusionCulled;
+    glm::vec2 depthSize;
+};
+
+struct GpuCullGroup
+{
+    uint32_t indexCount;
+    uint32_t firstIndex;
+    int32_t vertexOffset;
+    uint32_t commandOffset;
+};
+
+static_assert(sizeof(GpuCullObject) == 96, "GpuCullObject has to match the std430 layout of CullObject");
+
+// Grows to the next power of two, buffers still used by frames in flight go through the deletion queue
+void ReserveBuffer(TPtr<VulkanBuffer>& buffer, VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties, EVulkanMemoryCategory category)
+{
+    size = std::max<VkDeviceSize>(size, sizeof(glm::vec4));
+    if (buffer != nullptr && buffer->GetSize() >= size)
+        return;
+
+    buffer = std::make_shared<VulkanBuffer>(RenderSystem::Get().GetDevice(), static_cast<uint32_t>(std::bit_ceil(size)), usage, properties, category);
+}
+
+GpuCuller::GpuCuller(TPtr<HiZPyramid> hiZPyramid)
+    : _hiZPyramid(hiZPyramid), _commandCount(0)
+{
+    TPtr<VulkanDevice> device = RenderSystem::Get().GetDevice();
+    uint32_t framesInFlight = RenderSystem::Get().GetFramesInFlight();
+
+    _shaderResource = std::make_shared<ShaderResource>(EShaderStage::Compute, "GpuCullComputeShader.glsl");
+    _shaderResource->Load();
+    _shader = std::make_shared<VulkanShader>(device, _shaderResource->GetByteCode());
+
+    // Objects, groups, commands, counts, instances and the depth pyramid
+    std::vector<VkDescriptorSetLayoutBinding> layoutBindingArr(6);
+    for (uint32_t i = 0; i < layoutBindingArr.size(); i++)
+    {
+        layoutBindingArr[i].binding = i;
+        layoutBindingArr[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        layoutBindingArr[i].descriptorCount = 1;
+        layoutBindingArr[i].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    }
+    layoutBindingArr[5].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    _descriptorSetLayout = std::make_shared<VulkanDescriptorSetLayout>(device, layoutBindingArr);
+
+    std::vector<VkDescriptorPoolSize> poolSizeArr = {{VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 5 * framesInFlight}, {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, framesInFlight}};
+    _descriptorPool = std::make_shared<VulkanDescriptorPool>(device, poolSizeArr, framesInFlight);
+
+    VkPushConstantRange pushConstantRange{VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(GpuCullConstants)};
+    TPtrArr<VulkanDescriptorSetLayout> descriptorSetLayoutArr{_descriptorSetLayout};
+    _pipelineLayout = std::make_shared<VulkanPipelineLayout>(device, descriptorSetLayoutArr, std::vector<VkPushConstantRange>{pushConstantRange});
+
+    VkPipelineCache pipelineCache = RenderSystem::Get().GetDriverPipelineCache()->GetRawPipelineCache();
+    _pipeline = std::make_shared<VulkanComputePipeline>(device, _shader, _pipelineLayout, pipelineCache);
+
+    _sampler = std::make_shared<VulkanSampler>(device);
+
+    _frameResourcesArr.resize(framesInFlight);
+    for (FrameResources& frameResources : _frameResourcesArr)
+        frameResources.descriptorSet = std::make_shared<VulkanDescriptorSet>(_descriptorPool, _descriptorSetLayout);
+}
+
+GpuCuller::~GpuCuller()
+{
+}
+
+void GpuCuller::AddObject(TPtr<SceneObject> object, TPtr<Mesh> mesh, TPtr<Material> material)
+{
+    TPtr<TransformComponent> transformComponent = object->GetComponent<TransformComponent>();
+    if (transformComponent == nullptr || mesh == nullptr || material == nullptr || _objectIndexMap.contains(object.get()))
+        return;
+
+    ObjectSlot slot{object.get(), transformComponent, glm::vec4(0.0f, 0.0f, 0.0f, -1.0f), glm::vec3(0.0f), AcquireDrawGroup(mesh, material)};
+
+    // Only the first submesh is drawn, meshes without bounds are never culled
+    TPtr<MeshResource> meshResource = object->GetComponent<MeshComponent>()->GetMesh();
+    if (meshResource->GetMeshCount() > 0)
+    {
+        const MeshBounds& bounds = meshResource->GetBounds(0);
+        slot.sphere = glm::vec4(bounds.center, bounds.radius);
+        slot.extent = (bounds.max - bounds.min) * 0.5f;
+    }
+
+    _objectIndexMap.insert(std::make_pair(object.get(), static_cast<uint32_t>(_objectArr.size())));
+    _objectArr.push_back(slot);
+}
+
+void GpuCuller::RemoveObject(SceneObject* object)
+{
+    auto it = _objectIndexMap.find(object);
+    if (it == _objectIndexMap.end())
+        return;
+
+    uint32_t index = it->second;
+    ReleaseDrawGroup(_objectArr[index].groupIndex);
+    _objectIndexMap.erase(it);
+
+    // Slots stay dense, the last object takes the freed one
+    if (index != _objectArr.size() - 1)
+    {
+        _objectArr[index] = std::move(_objectArr.back());
+        _objectIndexMap[_objectArr[index].object] = index;
+    }
+    _objectArr.pop_back();
+}
+
+uint32_t GpuCuller::AcquireDrawGroup(TPtr<Mesh> mesh, TPtr<Material> material)
+{
+    std::pair<Mesh*, Material*> key{mesh.get(), material.get()};
+    auto it = _drawGroupIndexMap.find(key);
+    if (it != _drawGroupIndexMap.end())
+    {
+        _drawGroupArr[it->second].objectCount++;
+        return it->second;
+    }
+
+    uint32_t groupIndex;
+    if (!_freeDrawGroupArr.empty())
+    {
+        groupIndex = _freeDrawGroupArr.back();
+        _freeDrawGroupArr.pop_back();
+    }
+    else
+    {
+        groupIndex = static_cast<uint32_t>(_drawGroupArr.size());
+        _drawGroupArr.emplace_back();
+    }
+
+    _drawGroupArr[groupIndex] = GpuDrawGroup{mesh, material, 1, 0};
+    _drawGroupIndexMap.insert(std::make_pair(key, groupIndex));
+
+    return groupIndex;
+}
+
+void GpuCuller::ReleaseDrawGroup(uint32_t groupIndex)
+{
+    GpuDrawGroup& drawGroup = _drawGroupArr[groupIndex];
+    if (--drawGroup.objectCount > 0)
+        return;
+
+    _drawGroupIndexMap.erase(std::make_pair(drawGroup.mesh.get(), drawGroup.material.get()));
+    drawGroup = GpuDrawGroup{nullptr, nullptr, 0, 0};
+    _freeDrawGroupArr.push_back(groupIndex);
+}
+
+void GpuCuller::Dispatch(TPtr<VulkanCommandBuffer> commandBuffer, uint32_t frameIndex, const glm::mat4x4& viewProjection, const Frustum& frustum)
+{
+    ZE_CPU_SCOPE("GpuCuller::Dispatch");
+
+    if (_objectArr.empty())
+        return;
+
+    // Every group gets a range as large as its object count, all of them may be visible
+    _commandCount = 0;
+    for (GpuDrawGroup& drawGroup : _drawGroupArr)
+    {
+        drawGroup.commandOffset = _commandCount;
+        _commandCount += drawGroup.objectCount;
+    }
+
+    VkBufferUsageFlags outputUsage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+    ReserveBuffer(_indirectBuffer, _commandCount * sizeof(VkDrawIndexedIndirectCommand), outputUsage | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, EVulkanMemoryCategory::Other);
+    ReserveBuffer(_drawCountBuffer, _drawGroupArr.size() * sizeof(uint32_t), outputUsage | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, EVulkanMemoryCategory::Other);
+    ReserveBuffer(_instanceBuffer, _objectArr.size() * sizeof(glm::mat4x4), outputUsage | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, EVulkanMemoryCategory::Other);
+
+    FrameResources& frameResources = _frameResourcesArr[frameIndex % _frameResourcesArr.size()];
+    WriteObjects(frameResources, viewProjection, frustum);
+    WriteDrawGroups(frameResources);
+    UpdateDescriptorSet(frameResources);
+
+    ZE_GPU_SCOPE(commandBuffer, "GpuCull");
+
+    RecordCull(commandBuffer, frameResources, false);
+}
+
+void GpuCuller::DispatchOcclusion(TPtr<VulkanCommandBuffer> commandBuffer, uint32_t frameIndex)
+{
+    ZE_CPU_SCOPE("GpuCuller::DispatchOcclusion");
+
+    if (_objectArr.empty())
+        return;
+
+    // Objects, groups and ranges are still the ones Dispatch wrote for the frame
+    RecordCull(commandBuffer, _frameResourcesArr[frameIndex % _frameResourcesArr.size()], true);
+}
+
+void GpuCuller::RecordCull(TPtr<VulkanCommandBuffer> commandBuffer, FrameResources& frameResources, bool isOcclusionCulled)
+{
+    VkCommandBuffer vkCommandBuffer = commandBuffer->GetRawCommandBuffer();
+
+    // Earlier draws, the previous frame's or the depth pass', are done reading the outputs, the same queue runs them in order
+    vkCmdPipelineBarrier(vkCommandBuffer, VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 0, nullptr);
+
+    vkCmdFillBuffer(vkCommandBuffer, _drawCountBuffer->GetRawBuffer(), 0, _drawGroupArr.size() * sizeof(uint32_t), 0);
+
+    VkMemoryBarrier clearBarrier{};
+    clearBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    clearBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    clearBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+    vkCmdPipelineBarrier(vkCommandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &clearBarrier, 0, nullptr, 0, nullptr);
+
+    VkExtent3D depthExtent = _hiZPyramid->GetDepthExtent();
+    GpuCullConstants constants{};
+    constants.objectCount = static_cast<uint32_t>(_objectArr.size());
+    constants.isOcclusionCulled = isOcclusionCulled ? 1 : 0;
+    constants.depthSize = glm::vec2(depthExtent.width, depthExtent.height);
+
+    vkCmdBindPipeline(vkCommandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, _pipeline->GetRawPipeline());
+    vkCmdBindDescriptorSets(vkCommandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, _pipelineLayout->GetRawPipelineLayout(), 0, 1, &frameResources.descriptorSet->GetRawDescriptorSet(), 0, nullptr);
+    vkCmdPushConstants(vkCommandBuffer, _pipelineLayout->GetRawPipelineLayout(), VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(constants), &constants);
+    vkCmdDispatch(vkCommandBuffer, (constants.objectCount + CullGroupSize - 1) / CullGroupSize, 1, 1);
+
+    VkMemoryBarrier cullBarrier{};
+    cullBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    cullBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    cullBarrier.dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT;
+    vkCmdPipelineBarrier(vkCommandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, 0, 1, &cullBarrier, 0, nullptr, 0, nullptr);
+}
+
+void GpuCuller::WriteObjects(FrameResources& frameResources, const glm::mat4x4& viewProjection, const Frustum& frustum)
+{
+    ZE_CPU_SCOPE("GpuCuller::WriteObjects");
+
+    VkDeviceSize size = sizeof(GpuCullView) + _objectArr.size() * sizeof(GpuCullObject);
+    ReserveBuffer(frameResources.objectBuffer, size, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, EVulkanMemoryCategory::Uniform);
+
+    uint8_t* address = static_cast<uint8_t*>(frameResources.objectBuffer->MapMemory(0, size));
+
+    GpuCullView* view = reinterpret_cast<GpuCullView*>(address);
+    view->viewProjection = viewProjection;
+    std::copy(std::begin(frustum.planes), std::end(frustum.planes), view->frustumPlanes);
+
+    // Only the transforms change from frame to frame, everything else is copied from the slots
+    GpuCullObject* objects = reinterpret_cast<GpuCullObject*>(address + sizeof(GpuCullView));
+    JobSystem::Get().ParallelFor(_objectArr.size(), [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++)
+        {
+            const ObjectSlot& slot = _objectArr[i];
+            objects[i] = GpuCullObject{slot.transformComponent->GetRenderTransform(), slot.sphere, slot.extent, slot.groupIndex};
+        }
+    }, MinObjectWriteGrainSize);
+
+    frameResources.objectBuffer->UnmapMemory();
+}
+
+void GpuCuller::WriteDrawGroups(FrameResources& frameResources)
+{
+    VkDeviceSize size = _drawGroupArr.size() * sizeof(GpuCullGroup);
+    ReserveBuffer(frameResources.groupBuffer, size, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, EVulkanMemoryCategory::Uniform);
+
+    GpuCullGroup* groups = static_cast<GpuCullGroup*>(frameResources.groupBuffer->MapMemory(0, size));
+    for (size_t i = 0; i < _drawGroupArr.size(); i++)
+    {
+        const GpuDrawGroup& drawGroup = _drawGroupArr[i];
+        uint32_t indexCount = drawGroup.mesh != nullptr ? drawGroup.mesh->GetVerticesCount() : 0;
+        groups[i] = GpuCullGroup{indexCount, 0, 0, drawGroup.commandOffset};
+    }
+    frameResources.groupBuffer->UnmapMemory();
+}
+
+void GpuCuller::UpdateDescriptorSet(FrameResources& frameResources)
+{
+    // Any of the buffers may have grown since the frame last ran, its previous use is done
+    TPtr<VulkanBuffer> bufferArr[] = {frameResources.objectBuffer, frameResources.groupBuffer, _indirectBuffer, _drawCountBuffer, _instanceBuffer};
+    for (uint32_t i = 0; i < std::size(bufferArr); i++)
+    {
+        VkDescriptorBufferInfo bufferInfo{};
+        bufferInfo.buffer = bufferArr[i]->GetRawBuffer();
+        bufferInfo.offset = 0;
+        bufferInfo.range = VK_WHOLE_SIZE;
+
+        frameResources.descriptorSet->Update(i, 0, bufferInfo, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER);
+    }
+
+    // Only sampled by the occlusion dispatch, the pyramid is recreated when the depth is resized
+    VkDescriptorImageInfo pyramidInfo{_sampler->GetRawSampler(), _hiZPyramid->GetImageView()->GetRawImageView(), VK_IMAGE_LAYOUT_GENERAL};
+    frameResources.descriptorSet->Update(5, 0, pyramidInfo);
+}
+
+const std::vector<GpuDrawGroup>& GpuCuller::GetDrawGroups()
+{
+    return _drawGroupArr;
+}
+
+TPtr<VulkanBuffer> GpuCuller::GetIndirectBuffer()
+{
+    return _indirectBuffer;
+}
+
+TPtr<VulkanBuffer> GpuCuller::GetDrawCountBuffer()
+{
+    return _drawCountBuffer;
+}
+
+TPtr<VulkanBuffer> GpuCuller::GetInstanceBuffer()
+{
+    return _instanceBuffer;
+}
+
+uint32_t GpuCuller::GetObjectCount()
+{
+    return static_cast<uint32_t>(_objectArr.size());
+}
+
+uint32_t GpuCuller::GetDrawGroupCount()
+{
+    return static_cast<uint32_t>(_drawGroupIndexMap.size());
+}
+
+} // namespace ZE
\ No newline at end of file
@@ -0,0 +1,160 @@
+#include "GraphicPipelineCache.h"
+#include "Graphic/VulkanDevice.h"
+#include "Graphic/VulkanPipeline.h"
+#include "Graphic/VulkanPipelineCache.h"
+#include "Graphic/VulkanRenderPass.h"
+
+#include <algorithm>
+#include <assert.h>
+
+
+namespace ZE {
+
+GraphicPipelineCache::GraphicPipelineCache(TPtr<VulkanDevice> device, TPtr<VulkanPipelineCache> driverCache, uint64_t evictAfterFrames)
+    : _device(device), _driverCache(driverCache), _frame(0), _evictAfterFrames(evictAfterFrames), _hitCount(0), _missCount(0), _evictionCount(0)
+{
+}
+
+GraphicPipelineCache::~GraphicPipelineCache()
+{
+    Clear();
+}
+
+HashKey GraphicPipelineCache::MakeKey(const RHIPipelineState& state, TPtr<VulkanRenderPass> renderPass)
+{
+    HashWriter writer;
+
+    // Vertex input
+    writer.Write(static_cast<uint32_t>(state.vertexInputBindings.size()));
+    for (const VkVertexInputBindingDescription& binding : state.vertexInputBindings)
+        writer.Write(binding.binding).Write(binding.stride).Write(binding.inputRate);
+    writer.Write(static_cast<uint32_t>(state.vertexInputAttributes.size()));
+    for (const VkVertexInputAttributeDescription& attribute : state.vertexInputAttributes)
+        writer.Write(attribute.location).Write(attribute.binding).Write(attribute.format).Write(attribute.offset);
+
+    writer.Write(state.inputAssemblyState.topology).Write(state.inputAssemblyState.primitiveRestartEnable);
+
+    // Rasterization
+    const VkPipelineRasterizationStateCreateInfo& rasterization = state.rasterizeationState;
+    writer.Write(rasterization.depthClampEnable).Write(rasterization.rasterizerDiscardEnable).Write(rasterization.polygonMode);
+    writer.Write(rasterization.cullMode).Write(rasterization.frontFace).Write(rasterization.lineWidth);
+    writer.Write(rasterization.depthBiasEnable).Write(rasterization.depthBiasConstantFactor).Write(rasterization.depthBiasClamp).Write(rasterization.depthBiasSlopeFactor);
+
+    // Depth stencil
+    const VkPipelineDepthStencilStateCreateInfo& depthStencil = state.depthStencilState;
+    writer.Write(depthStencil.depthTestEnable).Write(depthStencil.depthWriteEnable).Write(depthStencil.depthCompareOp);
+    writer.Write(depthStencil.depthBoundsTestEnable).Write(depthStencil.minDepthBounds).Write(depthStencil.maxDepthBounds);
+    writer.Write(depthStencil.stencilTestEnable).Write(depthStencil.front).Write(depthStencil.back);
+
+    // Blend
+    writer.Write(static_cast<uint32_t>(state.colorBlendAttachments.size()));
+    for (const VkPipelineColorBlendAttachmentState& attachment : state.colorBlendAttachments)
+        writer.Write(attachment);
+    writer.Write(state.colorBlendState.logicOpEnable).Write(state.colorBlendState.logicOp).Write(state.colorBlendState.blendConstants);
+
+    // Shaders and layout by content, materials are destroyed at runtime and their handle values reused.
+    // A pipeline may be bound with any identically defined layout, materials sharing shaders share pipelines
+    assert(state.shaderCodeHashes.size() == state.shaderStages.size());
+    writer.Write(static_cast<uint32_t>(state.shaderStages.size()));
+    for (size_t i = 0; i < state.shaderStages.size(); i++)
+    {
+        const VkPipelineShaderStageCreateInfo& stage = state.shaderStages[i];
+        writer.Write(stage.stage).Write(state.shaderCodeHashes[i]);
+        writer.Write(std::string(stage.pName != nullptr ? stage.pName : ""));
+    }
+    writer.Write(state.layoutHash);
+
+    writer.Write(renderPass->GetCompatibilityHash());
+
+    return HashKey(writer);
+}
+
+TPtr<VulkanGraphicPipeline> GraphicPipelineCache::GetOrCreate(const RHIPipelineState& state, TPtr<VulkanRenderPass> renderPass)
+{
+    HashKey key = MakeKey(state, renderPass);
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        auto iter = _entries.find(key);
+        if (iter != _entries.end())
+        {
+            _hitCount++;
+            iter->second.lastUsedFrame = _frame;
+            return iter->second.pipeline;
+        }
+
+        _missCount++;
+    }
+
+    // Compiling takes long, other threads keep hitting the cache meanwhile. Threads missing the same
+    // key at once each build it and the first one inserted wins, the driver cache makes the others cheap
+    TPtr<VulkanGraphicPipeline> pipeline = std::make_shared<VulkanGraphicPipeline>(_device, state, renderPass, _driverCache->GetRawPipelineCache());
+
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    auto iter = _entries.try_emplace(std::move(key), Entry{pipeline, _frame}).first;
+    iter->second.lastUsedFrame = _frame;
+
+    return iter->second.pipeline;
+}
+
+void GraphicPipelineCache::Tick()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    _frame++;
+
+    if (_frame <= _evictAfterFrames)
+        return;
+
+    for (auto iter = _entries.begin(); iter != _entries.end();)
+    {
+        if (_frame - iter->second.lastUsedFrame > _evictAfterFrames)
+        {
+            iter = _entries.erase(iter);
+            _evictionCount++;
+        }
+        else
+        {
+            iter++;
+        }
+    }
+}
+
+void GraphicPipelineCache::Clear()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    _entries.clear();
+}
+
+uint64_t GraphicPipelineCache::GetHitCount()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    return _hitCount;
+}
+
+uint64_t GraphicPipelineCache::GetMissCount()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    return _missCount;
+}
+
+uint64_t GraphicPipelineCache::GetEvictionCount()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    return _evictionCount;
+}
+
+size_t GraphicPipelineCache::GetSize()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    return _entries.size();
+}
+
+} // namespace ZE
\ No newline at end of file
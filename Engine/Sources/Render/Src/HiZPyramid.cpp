@@ -0,0 +1,179 @@
+#include "HiZPyramid.h"
+#include "RenderSystem.h"
+#include "Resource/ShaderResource.h"
+#include "Graphic/VulkanDevice.h"
+#include "Graphic/VulkanImage.h"
+#include "Graphic/VulkanImageView.h"
+#include "Graphic/VulkanSampler.h"
+#include "Graphic/VulkanShader.h"
+#include "Graphic/VulkanCommandBuffer.h"
+#include "Graphic/VulkanDescriptorPool.h"
+#include "Graphic/VulkanDescriptorSetLayout.h"
+#include "Graphic/VulkanDescriptorSet.h"
+#include "Graphic/VulkanPipelineLayout.h"
+#include "Graphic/VulkanPipeline.h"
+#include "Graphic/VulkanPipelineCache.h"
+#include "Debug/CpuProfiler.h"
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <bit>
+
+
+namespace ZE {
+
+// Has to match the local size of the reduce shader
+const uint32_t ReduceGroupSize = 8;
+
+struct HiZReduceConstants
+{
+    glm::ivec2 sourceSize;
+    glm::ivec2 destinationSize;
+    uint32_t isDepthSource;
+};
+
+HiZPyramid::HiZPyramid()
+    : _depthExtent{0, 0, 0}
+{
+    TPtr<VulkanDevice> device = RenderSystem::Get().GetDevice();
+
+    _shaderResource = std::make_shared<ShaderResource>(EShaderStage::Compute, "HiZReduceComputeShader.glsl");
+    _shaderResource->Load();
+    _shader = std::make_shared<VulkanShader>(device, _shaderResource->GetByteCode());
+
+    // Source level and destination level
+    std::vector<VkDescriptorSetLayoutBinding> layoutBindingArr(2);
+    layoutBindingArr[0] = {0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr};
+    layoutBindingArr[1] = {1, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr};
+    _descriptorSetLayout = std::make_shared<VulkanDescriptorSetLayout>(device, layoutBindingArr);
+
+    VkPushConstantRange pushConstantRange{VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(HiZReduceConstants)};
+    TPtrArr<VulkanDescriptorSetLayout> descriptorSetLayoutArr{_descriptorSetLayout};
+    _pipelineLayout = std::make_shared<VulkanPipelineLayout>(device, descriptorSetLayoutArr, std::vector<VkPushConstantRange>{pushConstantRange});
+
+    VkPipelineCache pipelineCache = RenderSystem::Get().GetDriverPipelineCache()->GetRawPipelineCache();
+    _pipeline = std::make_shared<VulkanComputePipeline>(device, _shader, _pipelineLayout, pipelineCache);
+
+    _sampler = std::make_shared<VulkanSampler>(device);
+}
+
+HiZPyramid::~HiZPyramid()
+{
+}
+
+void HiZPyramid::Resize(TPtr<VulkanCommandBuffer> commandBuffer, const VkExtent3D& depthExtent)
+{
+    if (_image != nullptr && depthExtent.width == _depthExtent.width && depthExtent.height == _depthExtent.height)
+        return;
+
+    TPtr<VulkanDevice> device = RenderSystem::Get().GetDevice();
+    uint32_t framesInFlight = RenderSystem::Get().GetFramesInFlight();
+
+    _depthExtent = depthExtent;
+
+    // Halving down to a single texel, frames in flight still sampling the old pyramid keep it through the deletion queue
+    uint32_t mipLevels = std::max<uint32_t>(std::bit_width(std::max(depthExtent.width, depthExtent.height)) - 1, 1);
+    _image = std::make_shared<VulkanImage>(device, GetMipExtent(0), VK_FORMAT_R32G32_SFLOAT, VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, EVulkanMemoryCategory::RenderTarget, mipLevels);
+    _image->TransitionLayout(commandBuffer, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_GENERAL);
+    _imageView = std::make_shared<VulkanImageView>(_image, VK_FORMAT_UNDEFINED, VK_IMAGE_ASPECT_COLOR_BIT, 0, mipLevels);
+
+    _mipViewArr.clear();
+    for (uint32_t i = 0; i < mipLevels; i++)
+        _mipViewArr.push_back(std::make_shared<VulkanImageView>(_image, VK_FORMAT_UNDEFINED, VK_IMAGE_ASPECT_COLOR_BIT, i, 1));
+
+    // The sets keep their pool alive until they are freed, the old ones may still be in use
+    uint32_t setCount = framesInFlight + mipLevels - 1;
+    std::vector<VkDescriptorPoolSize> poolSizeArr = {{VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, setCount}, {VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, setCount}};
+    _descriptorPool = std::make_shared<VulkanDescriptorPool>(device, poolSizeArr, setCount);
+
+    auto createDescriptorSet = [this](TPtr<VulkanImageView> sourceView, TPtr<VulkanImageView> destinationView) {
+        TPtr<VulkanDescriptorSet> descriptorSet = std::make_shared<VulkanDescriptorSet>(_descriptorPool, _descriptorSetLayout);
+
+        if (sourceView != nullptr)
+        {
+            VkDescriptorImageInfo sourceInfo{_sampler->GetRawSampler(), sourceView->GetRawImageView(), VK_IMAGE_LAYOUT_GENERAL};
+            descriptorSet->Update(0, 0, sourceInfo);
+        }
+
+        VkDescriptorImageInfo destinationInfo{VK_NULL_HANDLE, destinationView->GetRawImageView(), VK_IMAGE_LAYOUT_GENERAL};
+        descriptorSet->Update(1, 0, destinationInfo, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE);
+
+        return descriptorSet;
+    };
+
+    _depthDescriptorSetArr.clear();
+    for (uint32_t i = 0; i < framesInFlight; i++)
+        _depthDescriptorSetArr.push_back(createDescriptorSet(nullptr, _mipViewArr[0]));
+
+    _mipDescriptorSetArr.clear();
+    for (uint32_t i = 1; i < mipLevels; i++)
+        _mipDescriptorSetArr.push_back(createDescriptorSet(_mipViewArr[i - 1], _mipViewArr[i]));
+}
+
+void HiZPyramid::Build(TPtr<VulkanCommandBuffer> commandBuffer, uint32_t frameIndex, TPtr<VulkanImageView> depthView)
+{
+    ZE_CPU_SCOPE("HiZPyramid::Build");
+
+    VkCommandBuffer vkCommandBuffer = commandBuffer->GetRawCommandBuffer();
+    VkPipelineLayout vkPipelineLayout = _pipelineLayout->GetRawPipelineLayout();
+
+    // The set was last used by the frame that ran in this slot, it is done with it
+    TPtr<VulkanDescriptorSet> depthDescriptorSet = _depthDescriptorSetArr[frameIndex % _depthDescriptorSetArr.size()];
+    VkDescriptorImageInfo depthInfo{_sampler->GetRawSampler(), depthView->GetRawImageView(), VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL};
+    depthDescriptorSet->Update(0, 0, depthInfo);
+
+    // Earlier reads and writes of the pyramid are done before it is overwritten
+    VkMemoryBarrier reuseBarrier{};
+    reuseBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    reuseBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    reuseBarrier.dstAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    vkCmdPipelineBarrier(vkCommandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &reuseBarrier, 0, nullptr, 0, nullptr);
+
+    vkCmdBindPipeline(vkCommandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, _pipeline->GetRawPipeline());
+
+    for (uint32_t i = 0; i < _mipViewArr.size(); i++)
+    {
+        VkExtent3D sourceExtent = i == 0 ? _depthExtent : GetMipExtent(i - 1);
+        VkExtent3D destinationExtent = GetMipExtent(i);
+        TPtr<VulkanDescriptorSet> descriptorSet = i == 0 ? depthDescriptorSet : _mipDescriptorSetArr[i - 1];
+
+        HiZReduceConstants constants{};
+        constants.sourceSize = glm::ivec2(sourceExtent.width, sourceExtent.height);
+        constants.destinationSize = glm::ivec2(destinationExtent.width, destinationExtent.height);
+        constants.isDepthSource = i == 0 ? 1 : 0;
+
+        vkCmdBindDescriptorSets(vkCommandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, vkPipelineLayout, 0, 1, &descriptorSet->GetRawDescriptorSet(), 0, nullptr);
+        vkCmdPushConstants(vkCommandBuffer, vkPipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(constants), &constants);
+        vkCmdDispatch(vkCommandBuffer, (destinationExtent.width + ReduceGroupSize - 1) / ReduceGroupSize, (destinationExtent.height + ReduceGroupSize - 1) / ReduceGroupSize, 1);
+
+        // The next level reads this one, after the last level the occlusion tests do
+        VkMemoryBarrier levelBarrier{};
+        levelBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        levelBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+        levelBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+        vkCmdPipelineBarrier(vkCommandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &levelBarrier, 0, nullptr, 0, nullptr);
+    }
+}
+
+TPtr<VulkanImageView> HiZPyramid::GetImageView()
+{
+    return _imageView;
+}
+
+VkExtent3D HiZPyramid::GetDepthExtent()
+{
+    return _depthExtent;
+}
+
+uint32_t HiZPyramid::GetMipLevels()
+{
+    return static_cast<uint32_t>(_mipViewArr.size());
+}
+
+VkExtent3D HiZPyramid::GetMipExtent(uint32_t mipLevel)
+{
+    return VkExtent3D{std::max(_depthExtent.width >> (mipLevel + 1), 1u), std::max(_depthExtent.height >> (mipLevel + 1), 1u), 1};
+}
+
+} // namespace ZE
\ No newline at end of file
@@ -4,8 +4,9 @@
 #include "Mesh.h"
 #include "RenderSystem.h"
 #include "Graphic/VulkanBuffer.h"
-#include "Graphic/VulkanBufferManager.h"
-#include "Graphic/VulkanDescriptorPool.h"
+#include "Graphic/VulkanUploadBatch.h"
+#include "Graphic/VulkanAsyncUploader.h"
+#include "Graphic/VulkanDescriptorAllocator.h"
 #include "Graphic/VulkanDescriptorSetLayout.h"
 #include "Graphic/VulkanDescriptorSet.h"
 #include "Graphic/VulkanImage.h"
@@ -14,7 +15,6 @@
 #include "Graphic/VulkanPipelineLayout.h"
 #include "Graphic/VulkanPipeline.h"
 #include "Graphic/VulkanShader.h"
-#include "Graphic/VulkanCommandBuffer.h"
 #include "Resource/ShaderResource.h"
 #include "Resource/TextureResource.h"
 
@@ -29,6 +29,8 @@ VkShaderStageFlagBits ConvertShaderStageToVulkanBit(EShaderStage stage)
         return VkShaderStageFlagBits::VK_SHADER_STAGE_VERTEX_BIT;
     case EShaderStage::Fragment:
         return VkShaderStageFlagBits::VK_SHADER_STAGE_FRAGMENT_BIT;
+    case EShaderStage::Compute:
+        return VkShaderStageFlagBits::VK_SHADER_STAGE_COMPUTE_BIT;
 
     default:
         return VkShaderStageFlagBits::VK_SHADER_STAGE_VERTEX_BIT;
@@ -196,6 +198,8 @@ VkShaderStageFlagBits ConvertShaderStageToVulkan(EShaderStage shaderStage)
         return VkShaderStageFlagBits::VK_SHADER_STAGE_VERTEX_BIT;
     case EShaderStage::Fragment:
         return VkShaderStageFlagBits::VK_SHADER_STAGE_FRAGMENT_BIT;
+    case EShaderStage::Compute:
+        return VkShaderStageFlagBits::VK_SHADER_STAGE_COMPUTE_BIT;
     }
 
     return VkShaderStageFlagBits::VK_SHADER_STAGE_VERTEX_BIT;
@@ -219,6 +223,7 @@ Pass::Pass(TPtr<PassResource> passResource)
 
         shaderState.name = "main";
         shaderState.shaderModule = VK_NULL_HANDLE;
+        shaderState.codeHash = 0;
         shaderState.stage = ConvertShaderStageToVulkan(shaderStage);
 
         shaderStates.push_back(shaderState);
@@ -229,10 +234,9 @@ Pass::~Pass()
 {
 }
 
-void Pass::BuildRenderResource(TPtr<VulkanCommandBuffer> commandBuffer)
+void Pass::BuildRenderResource(TPtr<VulkanUploadBatch> uploadBatch)
 {
-    CreateGraphicTextures(commandBuffer);
-    CreateGraphicBuffers(commandBuffer);
+    CreateGraphicTextures(uploadBatch);
     CreateGraphicShaders();
 
     CreateDescriptorSetLayout();
@@ -244,17 +248,15 @@ void Pass::BuildRenderResource(TPtr<VulkanCommandBuffer> commandBuffer)
 
 
 
-TPtr<VulkanImageView> CreateGraphicImage(TPtr<VulkanDevice> device, TPtr<VulkanCommandBuffer> commandBuffer, TPtr<TextureResource> texture)
+TPtr<VulkanImageView> CreateGraphicImage(TPtr<VulkanDevice> device, TPtr<VulkanUploadBatch> uploadBatch, TPtr<TextureResource> texture)
 {
     assert(texture->IsLoaded());
 
     uint32_t imageSize = texture->GetWidth() * texture->GetHeight() * 4;
     VkExtent3D extent{texture->GetWidth(), texture->GetHeight(), 1};
 
-    TPtr<VulkanBuffer> stagingBuffer = RenderSystem::Get().GetBufferManager()->AcquireStagingBuffer(imageSize);
     TPtr<VulkanImage> vulkanImage = std::make_shared<VulkanImage>(device, extent, VkFormat::VK_FORMAT_R8G8B8A8_SRGB);
-    vulkanImage->TransferData(commandBuffer, stagingBuffer, texture->GetData(), imageSize);
-    RenderSystem::Get().GetBufferManager()->ReleaseStagingBuffer(stagingBuffer, commandBuffer);
+    uploadBatch->UploadImage(vulkanImage, texture->GetData(), imageSize);
 
     TPtr<VulkanImageView> vulkanImageView = std::make_shared<VulkanImageView>(vulkanImage);
 
@@ -262,7 +264,7 @@ TPtr<VulkanImageView> CreateGraphicImage(TPtr<VulkanDevice> device, TPtr<VulkanC
 }
 
 
-void Pass::CreateGraphicTextures(TPtr<VulkanCommandBuffer> commandBuffer)
+void Pass::CreateGraphicTextures(TPtr<VulkanUploadBatch> uploadBatch)
 {
     assert(_owner.expired() == false);
 
@@ -283,7 +285,7 @@ void Pass::CreateGraphicTextures(TPtr<VulkanCommandBuffer> commandBuffer)
             VulkanImageBindingInfo vulkanBindingInfo;
 
             vulkanBindingInfo.bindingPoint = bindingInfo.bindingPoint;
-            vulkanBindingInfo.vulkanImageView = CreateGraphicImage(device, commandBuffer, bindingInfo.texture);
+            vulkanBindingInfo.vulkanImageView = CreateGraphicImage(device, uploadBatch, bindingInfo.texture);
             vulkanBindingInfo.vulkanSampler = std::make_shared<VulkanSampler>(device);
 
             vulkanBindingInfoList.push_back(vulkanBindingInfo);
@@ -294,11 +296,6 @@ void Pass::CreateGraphicTextures(TPtr<VulkanCommandBuffer> commandBuffer)
     }
 }
 
-void Pass::CreateGraphicBuffers(TPtr<VulkanCommandBuffer> commandBuffer)
-{
-    _uniformBuffer = std::make_shared<VulkanBuffer>(commandBuffer->GetDevice(), sizeof(glm::mat4x4), VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
-}
-
 TPtr<VulkanShader> CreateGraphicShader(TPtr<VulkanDevice> device, VkShaderStageFlagBits shaderStage,
                                        TPtr<ShaderResource> shader)
 {
@@ -326,6 +323,7 @@ void Pass::CreateGraphicShaders()
             if (shaderState.stage == vulkanBit)
             {
                 shaderState.shaderModule = vulkanShader->GetRawShader();
+                shaderState.codeHash = vulkanShader->GetCodeHash();
             }
         }
     }
@@ -335,42 +333,27 @@ void Pass::CreateDescriptorSetLayout()
 {
     TPtr<VulkanDevice> device = RenderSystem::Get().GetDevice();
 
-    VkDescriptorSetLayoutBinding matrixDescriptorSetlayoutBinding{};
-    matrixDescriptorSetlayoutBinding.binding = 0;
-    matrixDescriptorSetlayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-    matrixDescriptorSetlayoutBinding.descriptorCount = 1;
-    matrixDescriptorSetlayoutBinding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
-
+    // Per draw matrices are instance attributes, see Mesh::InstanceBinding, binding 0 is left free for them
     VkDescriptorSetLayoutBinding samplerDescriptorSetlayoutBinding{};
     samplerDescriptorSetlayoutBinding.binding = 1;
     samplerDescriptorSetlayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
     samplerDescriptorSetlayoutBinding.descriptorCount = 1;
     samplerDescriptorSetlayoutBinding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
 
-    std::vector<VkDescriptorSetLayoutBinding> localDescriptorSetLayoutBindings = {
-        matrixDescriptorSetlayoutBinding, samplerDescriptorSetlayoutBinding};
+    std::vector<VkDescriptorSetLayoutBinding> localDescriptorSetLayoutBindings = {samplerDescriptorSetlayoutBinding};
 
     _descriptorSetLayout = std::make_shared<VulkanDescriptorSetLayout>(device, localDescriptorSetLayoutBindings);
 }
 
 void Pass::CreateDescriptorSet()
 {
-    TPtr<VulkanDescriptorPool> descriptorPool = RenderSystem::Get().GetDescriptorPool();
+    TPtr<VulkanDescriptorAllocator> descriptorAllocator = RenderSystem::Get().GetDescriptorAllocator();
 
-    _descriptorSet = std::make_shared<VulkanDescriptorSet>(descriptorPool, _descriptorSetLayout);
+    _descriptorSet = descriptorAllocator->Allocate(_descriptorSetLayout);
 }
 
 void Pass::LinkDescriptorSet()
 {
-    {
-        VkDescriptorBufferInfo bufferInfo{};
-        bufferInfo.buffer = _uniformBuffer->GetRawBuffer();
-        bufferInfo.offset = 0;
-        bufferInfo.range = _uniformBuffer->GetSize();
-
-        _descriptorSet->Update(0, 0, bufferInfo);
-    }
-
     {
         if (_textures.find(VkShaderStageFlagBits::VK_SHADER_STAGE_FRAGMENT_BIT) == _textures.end())
             return;
@@ -424,6 +407,7 @@ void Pass::ApplyPipelineState(RHIPipelineState& state)
         vkFragmentShaderStageCreateInfo.module = shaderState.shaderModule;
 
         shaderStages.push_back(vkFragmentShaderStageCreateInfo);
+        state.shaderCodeHashes.push_back(shaderState.codeHash);
     }
 
     VkPipelineRasterizationStateCreateInfo& rasterizer = state.rasterizeationState;
@@ -470,17 +454,11 @@ void Pass::ApplyPipelineState(RHIPipelineState& state)
     colorBlending.blendConstants[3] = 0.0f; // Optional
 
     state.layout = _pipelineLayout->GetRawPipelineLayout();
-}
-
-void Pass::UpdateUniformBuffer(TPtr<VulkanCommandBuffer> commandBuffer, const glm::mat4x4& mvp)
-{
-    TPtr<VulkanBuffer> stagingBuffer = RenderSystem::Get().GetBufferManager()->AcquireStagingBuffer(sizeof(mvp));
-    _uniformBuffer->TransferData(commandBuffer, stagingBuffer, &mvp, sizeof(mvp));
-    RenderSystem::Get().GetBufferManager()->ReleaseStagingBuffer(stagingBuffer, commandBuffer);
+    state.layoutHash = _pipelineLayout->GetLayoutHash();
 }
 
 Material::Material(TPtr<MaterialResource> materialResource)
-    : _owner(materialResource)
+    : _owner(materialResource), _uploadValue(0)
 {
 }
 
@@ -501,4 +479,14 @@ TPtr<Pass> Material::GetPass(EPassType passType)
         return _passMap[passType];
 }
 
+void Material::SetUploadValue(uint64_t uploadValue)
+{
+    _uploadValue = uploadValue;
+}
+
+bool Material::IsReady()
+{
+    return RenderSystem::Get().GetAsyncUploader()->IsReady(_uploadValue);
+}
+
 } // namespace ZE
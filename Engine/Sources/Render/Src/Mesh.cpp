@@ -1,15 +1,16 @@
 #include "Mesh.h"
 #include "RenderSystem.h"
 #include "Graphic/VulkanBuffer.h"
-#include "Graphic/VulkanBufferManager.h"
-#include "Graphic/VulkanCommandBuffer.h"
+#include "Graphic/VulkanUploadBatch.h"
+#include "Graphic/VulkanMemoryDefragmenter.h"
+#include "Graphic/VulkanAsyncUploader.h"
 #include "Resource/MeshResource.h"
 
 
 namespace ZE {
 
 Mesh::Mesh(TPtr<MeshResource> meshResource)
-    : _owner(meshResource), _vertexBuffer(nullptr), _indexBuffer(nullptr), _verticesCount(0)
+    : _owner(meshResource), _vertexBuffer(nullptr), _indexBuffer(nullptr), _verticesCount(0), _uploadValue(0), _isReady(false)
 {
 }
 
@@ -22,7 +23,7 @@ uint32_t Mesh::GetVerticesCount()
     return _verticesCount;
 }
 
-void Mesh::CreateVertexBuffer(TPtr<VulkanCommandBuffer> commandBuffer)
+void Mesh::CreateVertexBuffer(TPtr<VulkanUploadBatch> uploadBatch)
 {
     assert(_owner.expired() == false);
 
@@ -31,12 +32,10 @@ void Mesh::CreateVertexBuffer(TPtr<VulkanCommandBuffer> commandBuffer)
     const std::vector<VertexData>& vertices = MeshResource->GetVertices(0);
     uint32_t byteSize = vertices.size() * sizeof(VertexData);
 
-    TPtr<VulkanBuffer> stagingBuffer = RenderSystem::Get().GetBufferManager()->AcquireStagingBuffer(byteSize);
-    _vertexBuffer = std::make_shared<VulkanBuffer>(commandBuffer->GetDevice(), byteSize,
-                                                   VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
-                                                   VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
-    _vertexBuffer->TransferData(commandBuffer, stagingBuffer, vertices.data(), byteSize);
-    RenderSystem::Get().GetBufferManager()->ReleaseStagingBuffer(stagingBuffer, commandBuffer);
+    _vertexBuffer = std::make_shared<VulkanBuffer>(RenderSystem::Get().GetDevice(), byteSize,
+                                                   VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+                                                   VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, EVulkanMemoryCategory::Mesh);
+    uploadBatch->UploadBuffer(_vertexBuffer, vertices.data(), byteSize);
 }
 
 TPtr<VulkanBuffer> Mesh::GetVertexBuffer()
@@ -44,7 +43,7 @@ TPtr<VulkanBuffer> Mesh::GetVertexBuffer()
     return _vertexBuffer;
 }
 
-void Mesh::CreateIndexBuffer(TPtr<VulkanCommandBuffer> commandBuffer)
+void Mesh::CreateIndexBuffer(TPtr<VulkanUploadBatch> uploadBatch)
 {
     assert(_owner.expired() == false);
 
@@ -53,12 +52,10 @@ void Mesh::CreateIndexBuffer(TPtr<VulkanCommandBuffer> commandBuffer)
     const std::vector<uint32_t>& indexes = MeshResource->GetIndexes(0);
     uint32_t byteSize = indexes.size() * sizeof(uint32_t);
 
-    TPtr<VulkanBuffer> stagingBuffer = RenderSystem::Get().GetBufferManager()->AcquireStagingBuffer(byteSize);
-    _indexBuffer = std::make_shared<VulkanBuffer>(commandBuffer->GetDevice(), byteSize,
-                                                  VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
-                                                  VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
-    _indexBuffer->TransferData(commandBuffer, stagingBuffer, indexes.data(), byteSize);
-    RenderSystem::Get().GetBufferManager()->ReleaseStagingBuffer(stagingBuffer, commandBuffer);
+    _indexBuffer = std::make_shared<VulkanBuffer>(RenderSystem::Get().GetDevice(), byteSize,
+                                                  VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
+                                                  VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, EVulkanMemoryCategory::Mesh);
+    uploadBatch->UploadBuffer(_indexBuffer, indexes.data(), byteSize);
 
     _verticesCount = indexes.size();
 }
@@ -68,15 +65,42 @@ TPtr<VulkanBuffer> Mesh::GetIndexBuffer()
     return _indexBuffer;
 }
 
+void Mesh::SetUploadValue(uint64_t uploadValue)
+{
+    _uploadValue = uploadValue;
+}
+
+bool Mesh::IsReady()
+{
+    if (_isReady)
+        return true;
+
+    if (!RenderSystem::Get().GetAsyncUploader()->IsReady(_uploadValue))
+        return false;
+
+    // Draws fetch the raw buffers when recording, so the defragmenter is free to move them once the graphic family owns them
+    RenderSystem::Get().GetMemoryDefragmenter()->Register(_vertexBuffer);
+    RenderSystem::Get().GetMemoryDefragmenter()->Register(_indexBuffer);
+    _isReady = true;
+
+    return true;
+}
+
 void Mesh::ApplyPipelineState(RHIPipelineState& state)
 {
-    VkVertexInputBindingDescription& bindingDescription = state.vertexInputBinding;
-    bindingDescription.binding = 0;
-    bindingDescription.stride = sizeof(VertexData);
-    bindingDescription.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+    std::vector<VkVertexInputBindingDescription>& bindingDescriptions = state.vertexInputBindings;
+    bindingDescriptions.resize(2);
+    bindingDescriptions[0].binding = 0;
+    bindingDescriptions[0].stride = sizeof(VertexData);
+    bindingDescriptions[0].inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+
+    // The MVP of every draw comes per instance, the first instance of a draw selects its matrix
+    bindingDescriptions[1].binding = InstanceBinding;
+    bindingDescriptions[1].stride = sizeof(glm::mat4x4);
+    bindingDescriptions[1].inputRate = VK_VERTEX_INPUT_RATE_INSTANCE;
 
     std::vector<VkVertexInputAttributeDescription>& attributeDescriptions = state.vertexInputAttributes;
-    attributeDescriptions.resize(3);
+    attributeDescriptions.resize(7);
     attributeDescriptions[0].binding = 0;
     attributeDescriptions[0].location = 0;
     attributeDescriptions[0].format = VK_FORMAT_R32G32B32_SFLOAT;
@@ -92,11 +116,20 @@ void Mesh::ApplyPipelineState(RHIPipelineState& state)
     attributeDescriptions[2].format = VK_FORMAT_R32G32_SFLOAT;
     attributeDescriptions[2].offset = offsetof(VertexData, texCoord);
 
+    // A matrix attribute takes one location per column
+    for (uint32_t column = 0; column < 4; column++)
+    {
+        attributeDescriptions[3 + column].binding = InstanceBinding;
+        attributeDescriptions[3 + column].location = 3 + column;
+        attributeDescriptions[3 + column].format = VK_FORMAT_R32G32B32A32_SFLOAT;
+        attributeDescriptions[3 + column].offset = column * sizeof(glm::vec4);
+    }
+
     VkPipelineVertexInputStateCreateInfo& vertexInputInfo = state.vertexInputState;
     vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
-    vertexInputInfo.vertexBindingDescriptionCount = 1;
+    vertexInputInfo.vertexBindingDescriptionCount = static_cast<uint32_t>(bindingDescriptions.size());
     vertexInputInfo.vertexAttributeDescriptionCount = static_cast<uint32_t>(attributeDescriptions.size());
-    vertexInputInfo.pVertexBindingDescriptions = &bindingDescription;
+    vertexInputInfo.pVertexBindingDescriptions = bindingDescriptions.data();
     vertexInputInfo.pVertexAttributeDescriptions = attributeDescriptions.data();
 
     VkPipelineInputAssemblyStateCreateInfo& inputAssembly = state.inputAssemblyState;
@@ -0,0 +1,550 @@
+#include "RenderGraph.h"
+#include "Frame.h"
+#include "RenderSystem.h"
+#include "RenderPassCache.h"
+#include "FramebufferCache.h"
+#include "RenderTargetPool.h"
+#include "Graphic/VulkanImage.h"
+#include "Graphic/VulkanImageView.h"
+#include "Graphic/VulkanRenderPass.h"
+#include "Graphic/VulkanFramebuffer.h"
+#include "Graphic/VulkanCommandBuffer.h"
+#include "Debug/CpuProfiler.h"
+#include "Debug/GpuProfiler.h"
+
+#include <algorithm>
+#include <optional>
+#include <stdexcept>
+
+
+namespace ZE {
+
+const uint32_t InvalidIndex = UINT32_MAX;
+
+const VkAccessFlags WriteAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT | VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+
+static VkAttachmentLoadOp ConvertRenderTargetLoadActionToVulkan(ERenderTargetLoadAction loadAction)
+{
+    switch (loadAction)
+    {
+    case ERenderTargetLoadAction::Load:
+        return VkAttachmentLoadOp::VK_ATTACHMENT_LOAD_OP_LOAD;
+    case ERenderTargetLoadAction::Clear:
+        return VkAttachmentLoadOp::VK_ATTACHMENT_LOAD_OP_CLEAR;
+    case ERenderTargetLoadAction::DontCare:
+        return VkAttachmentLoadOp::VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    }
+
+    return VkAttachmentLoadOp::VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+}
+
+static bool IsReadAccess(ERenderGraphAccess access)
+{
+    return access == ERenderGraphAccess::DepthAttachmentRead || access == ERenderGraphAccess::ShaderRead;
+}
+
+static bool IsWriteAccess(ERenderGraphAccess access)
+{
+    return access == ERenderGraphAccess::ColorAttachment || access == ERenderGraphAccess::DepthAttachment;
+}
+
+// Whether the pass needs what earlier passes left in the texture
+static bool ReadsContents(ERenderGraphAccess access, ERenderTargetLoadAction loadAction)
+{
+    return IsReadAccess(access) || loadAction == ERenderTargetLoadAction::Load;
+}
+
+static void GetAccessState(ERenderGraphAccess access, VkFormat format, VkImageLayout& layout, VkPipelineStageFlags& stageMask, VkAccessFlags& accessMask, bool& isWrite)
+{
+    switch (access)
+    {
+    case ERenderGraphAccess::ColorAttachment:
+        layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+        stageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+        accessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+        isWrite = true;
+        break;
+    case ERenderGraphAccess::DepthAttachment:
+    case ERenderGraphAccess::DepthAttachmentRead:
+        layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+        stageMask = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+        accessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+        isWrite = true;
+        break;
+    case ERenderGraphAccess::ShaderRead:
+        layout = (VulkanImage::GetAspectMask(format) & VK_IMAGE_ASPECT_COLOR_BIT) ? VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL : VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
+        stageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+        accessMask = VK_ACCESS_SHADER_READ_BIT;
+        isWrite = false;
+        break;
+    }
+}
+
+static bool IsSameDesc(const RenderTargetDesc& lhs, const RenderTargetDesc& rhs)
+{
+    return lhs.extent.width == rhs.extent.width && lhs.extent.height == rhs.extent.height && lhs.extent.depth == rhs.extent.depth &&
+           lhs.format == rhs.format && lhs.usage == rhs.usage && lhs.aspect == rhs.aspect && lhs.isTransient == rhs.isTransient;
+}
+
+RenderGraphPassBuilder::RenderGraphPassBuilder(RenderGraph& graph, uint32_t passIndex)
+    : _graph(graph), _passIndex(passIndex)
+{
+}
+
+RenderGraphPassBuilder& RenderGraphPassBuilder::WriteColor(RenderGraphTextureHandle texture, ERenderTargetLoadAction loadAction)
+{
+    _graph.AddUsage(_passIndex, texture, ERenderGraphAccess::ColorAttachment, loadAction);
+    return *this;
+}
+
+RenderGraphPassBuilder& RenderGraphPassBuilder::WriteDepth(RenderGraphTextureHandle texture, ERenderTargetLoadAction loadAction)
+{
+    _graph.AddUsage(_passIndex, texture, ERenderGraphAccess::DepthAttachment, loadAction);
+    return *this;
+}
+
+RenderGraphPassBuilder& RenderGraphPassBuilder::ReadDepth(RenderGraphTextureHandle texture)
+{
+    _graph.AddUsage(_passIndex, texture, ERenderGraphAccess::DepthAttachmentRead, ERenderTargetLoadAction::Load);
+    return *this;
+}
+
+RenderGraphPassBuilder& RenderGraphPassBuilder::ReadTexture(RenderGraphTextureHandle texture)
+{
+    _graph.AddUsage(_passIndex, texture, ERenderGraphAccess::ShaderRead, ERenderTargetLoadAction::Load);
+    return *this;
+}
+
+RenderGraphPassBuilder& RenderGraphPassBuilder::RecordSecondary()
+{
+    _graph._passArr[_passIndex].contents = VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS;
+    return *this;
+}
+
+RenderGraph::RenderGraph()
+    : _pendingSrcStageMask(0), _pendingDstStageMask(0), _isCompiled(false)
+{
+}
+
+RenderGraph::~RenderGraph()
+{
+}
+
+RenderGraphTextureHandle RenderGraph::CreateTexture(const char* name, const RenderGraphTextureDesc& desc)
+{
+    _textureArr.push_back(TextureNode{name, desc, false, VK_IMAGE_LAYOUT_UNDEFINED, 0, 0, InvalidIndex, 0, InvalidIndex});
+    return static_cast<RenderGraphTextureHandle>(_textureArr.size() - 1);
+}
+
+RenderGraphTextureHandle RenderGraph::ImportTexture(const char* name, TPtr<VulkanImageView> imageView, VkImageLayout finalLayout)
+{
+    RenderGraphTextureDesc desc{imageView->GetExtent(), imageView->GetImage()->GetFormat(), static_cast<VkImageAspectFlagBits>(VulkanImage::GetAspectMask(imageView->GetImage()->GetFormat()))};
+
+    TPtr<VulkanImage> image = imageView->GetImage();
+
+    PhysicalTexture physical{};
+    physical.imageView = imageView;
+    physical.lastPass = InvalidIndex;
+    physical.layout = image->GetLayout();
+    VulkanImage::GetLayoutUsage(physical.layout, physical.stageMask, physical.accessMask);
+    // Swapchain images become available at this stage through the acquire semaphore
+    physical.stageMask |= VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+    physical.hasPendingWrite = (physical.accessMask & WriteAccessMask) != 0;
+    _physicalArr.push_back(physical);
+
+    _textureArr.push_back(TextureNode{name, desc, true, finalLayout, image->GetUsage(), 0, InvalidIndex, 0, static_cast<uint32_t>(_physicalArr.size() - 1)});
+    return static_cast<RenderGraphTextureHandle>(_textureArr.size() - 1);
+}
+
+RenderGraphPassBuilder RenderGraph::AddPass(const char* name, RenderGraphExecuteCallback callback)
+{
+    _passArr.push_back(PassNode{name, callback, {}, 0, false, VK_SUBPASS_CONTENTS_INLINE});
+    return RenderGraphPassBuilder(*this, static_cast<uint32_t>(_passArr.size() - 1));
+}
+
+void RenderGraph::AddUsage(uint32_t passIndex, RenderGraphTextureHandle texture, ERenderGraphAccess access, ERenderTargetLoadAction loadAction)
+{
+    if (texture >= _textureArr.size())
+        throw std::runtime_error("render graph texture handle is invalid!");
+
+    TextureNode& textureNode = _textureArr[texture];
+    switch (access)
+    {
+    case ERenderGraphAccess::ColorAttachment:
+        textureNode.usage |= VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+        break;
+    case ERenderGraphAccess::DepthAttachment:
+    case ERenderGraphAccess::DepthAttachmentRead:
+        textureNode.usage |= VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+        break;
+    case ERenderGraphAccess::ShaderRead:
+        textureNode.usage |= VK_IMAGE_USAGE_SAMPLED_BIT;
+        break;
+    }
+
+    _passArr[passIndex].usageArr.push_back(TextureUsage{texture, access, loadAction, VK_ATTACHMENT_LOAD_OP_DONT_CARE, VK_ATTACHMENT_STORE_OP_DONT_CARE});
+}
+
+void RenderGraph::Compile()
+{
+    ZE_CPU_SCOPE("RenderGraph::Compile");
+
+    CullPasses();
+    ComputeLifetimes();
+    InferAttachmentOps();
+    AllocatePhysicalTextures();
+
+    _isCompiled = true;
+}
+
+void RenderGraph::CullPasses()
+{
+    // A texture is needed while a live pass reads it or it leaves the graph, a pass while any texture it writes is needed
+    for (TextureNode& texture : _textureArr)
+        texture.refCount = texture.isImported ? 1 : 0;
+
+    for (PassNode& pass : _passArr)
+    {
+        pass.refCount = 0;
+        pass.isCulled = false;
+
+        for (TextureUsage& usage : pass.usageArr)
+        {
+            if (IsWriteAccess(usage.access))
+                pass.refCount++;
+            if (IsReadAccess(usage.access))
+                _textureArr[usage.texture].refCount++;
+        }
+    }
+
+    std::vector<RenderGraphTextureHandle> unusedArr;
+    for (uint32_t i = 0; i < _textureArr.size(); i++)
+    {
+        if (_textureArr[i].refCount == 0)
+            unusedArr.push_back(i);
+    }
+
+    while (!unusedArr.empty())
+    {
+        RenderGraphTextureHandle unused = unusedArr.back();
+        unusedArr.pop_back();
+
+        for (PassNode& pass : _passArr)
+        {
+            if (pass.isCulled)
+                continue;
+
+            bool isWriter = std::any_of(pass.usageArr.begin(), pass.usageArr.end(), [unused](const TextureUsage& usage) { return usage.texture == unused && IsWriteAccess(usage.access); });
+            if (!isWriter || --pass.refCount > 0)
+                continue;
+
+            pass.isCulled = true;
+            for (TextureUsage& usage : pass.usageArr)
+            {
+                if (IsReadAccess(usage.access) && --_textureArr[usage.texture].refCount == 0)
+                    unusedArr.push_back(usage.texture);
+            }
+        }
+    }
+}
+
+void RenderGraph::ComputeLifetimes()
+{
+    for (TextureNode& texture : _textureArr)
+    {
+        texture.firstPass = InvalidIndex;
+        texture.lastPass = 0;
+    }
+
+    for (uint32_t i = 0; i < _passArr.size(); i++)
+    {
+        if (_passArr[i].isCulled)
+            continue;
+
+        for (TextureUsage& usage : _passArr[i].usageArr)
+        {
+            TextureNode& texture = _textureArr[usage.texture];
+            texture.firstPass = std::min(texture.firstPass, i);
+            texture.lastPass = std::max(texture.lastPass, i);
+        }
+    }
+}
+
+void RenderGraph::InferAttachmentOps()
+{
+    for (uint32_t i = 0; i < _passArr.size(); i++)
+    {
+        if (_passArr[i].isCulled)
+            continue;
+
+        for (TextureUsage& usage : _passArr[i].usageArr)
+        {
+            if (usage.access == ERenderGraphAccess::ShaderRead)
+                continue;
+
+            TextureNode& texture = _textureArr[usage.texture];
+
+            // Nothing was written before the first use of a graph owned texture
+            bool hasContents = texture.isImported || i != texture.firstPass;
+            usage.loadOp = usage.loadAction == ERenderTargetLoadAction::Load && !hasContents ? VK_ATTACHMENT_LOAD_OP_DONT_CARE : ConvertRenderTargetLoadActionToVulkan(usage.loadAction);
+
+            // Store only when the next user loads the contents, or when they leave the graph
+            std::optional<bool> isNextUseReading;
+            for (uint32_t j = i + 1; j < _passArr.size() && !isNextUseReading.has_value(); j++)
+            {
+                if (_passArr[j].isCulled)
+                    continue;
+
+                for (TextureUsage& nextUsage : _passArr[j].usageArr)
+                {
+                    if (nextUsage.texture == usage.texture)
+                    {
+                        isNextUseReading = ReadsContents(nextUsage.access, nextUsage.loadAction);
+                        break;
+                    }
+                }
+            }
+
+            bool isStored = isNextUseReading.has_value() ? isNextUseReading.value() : texture.isImported;
+            usage.storeOp = isStored ? VK_ATTACHMENT_STORE_OP_STORE : VK_ATTACHMENT_STORE_OP_DONT_CARE;
+        }
+    }
+}
+
+void RenderGraph::AllocatePhysicalTextures()
+{
+    std::vector<RenderGraphTextureHandle> orderArr;
+    for (uint32_t i = 0; i < _textureArr.size(); i++)
+    {
+        if (!_textureArr[i].isImported && _textureArr[i].firstPass != InvalidIndex)
+            orderArr.push_back(i);
+    }
+
+    std::sort(orderArr.begin(), orderArr.end(), [this](RenderGraphTextureHandle lhs, RenderGraphTextureHandle rhs) { return _textureArr[lhs].firstPass < _textureArr[rhs].firstPass; });
+
+    TPtr<RenderTargetPool> renderTargetPool = RenderSystem::Get().GetRenderTargetPool();
+    for (RenderGraphTextureHandle handle : orderArr)
+    {
+        TextureNode& texture = _textureArr[handle];
+
+        // Attachment only textures never leave the tile on tilers, they can live in lazily allocated memory
+        VkImageUsageFlags attachmentUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+        RenderTargetDesc desc{texture.desc.extent, texture.desc.format, texture.usage, texture.desc.aspect, (texture.usage & ~attachmentUsage) == 0};
+
+        // Alias an image whose previous textures are all dead by the time this one is first used
+        auto iter = std::find_if(_physicalArr.begin(), _physicalArr.end(), [&](const PhysicalTexture& physical) {
+            return physical.lastPass != InvalidIndex && physical.lastPass < texture.firstPass && IsSameDesc(physical.desc, desc);
+        });
+
+        if (iter == _physicalArr.end())
+        {
+            PhysicalTexture physical{};
+            physical.imageView = renderTargetPool->Acquire(desc);
+            physical.desc = desc;
+            physical.layout = VK_IMAGE_LAYOUT_UNDEFINED;
+            physical.stageMask = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+            physical.accessMask = VK_ACCESS_NONE;
+            physical.hasPendingWrite = false;
+            _physicalArr.push_back(physical);
+            iter = _physicalArr.end() - 1;
+        }
+
+        iter->lastPass = texture.lastPass;
+        texture.physicalIndex = static_cast<uint32_t>(iter - _physicalArr.begin());
+    }
+}
+
+void RenderGraph::Execute(TPtr<VulkanCommandBuffer> commandBuffer, TPtr<Frame> frame)
+{
+    ZE_CPU_SCOPE("RenderGraph::Execute");
+
+    if (!_isCompiled)
+        Compile();
+
+    // Keep the pooled images alive until the GPU is done with this frame, the pool recycles them afterwards
+    for (PhysicalTexture& physical : _physicalArr)
+        frame->PutImage(physical.imageView);
+
+    for (uint32_t i = 0; i < _passArr.size(); i++)
+    {
+        if (!_passArr[i].isCulled)
+            ExecutePass(_passArr[i], commandBuffer, frame);
+    }
+
+    // Leave imported textures the way their owner expects them
+    for (TextureNode& texture : _textureArr)
+    {
+        if (!texture.isImported || texture.finalLayout == VK_IMAGE_LAYOUT_UNDEFINED)
+            continue;
+
+        VkPipelineStageFlags stageMask;
+        VkAccessFlags accessMask;
+        VulkanImage::GetLayoutUsage(texture.finalLayout, stageMask, accessMask);
+        AddBarrier(_physicalArr[texture.physicalIndex], false, texture.finalLayout, stageMask, accessMask, false);
+    }
+    FlushBarriers(commandBuffer);
+
+    for (PhysicalTexture& physical : _physicalArr)
+        physical.imageView->GetImage()->SetLayout(physical.layout);
+}
+
+void RenderGraph::ExecutePass(PassNode& pass, TPtr<VulkanCommandBuffer> commandBuffer, TPtr<Frame> frame)
+{
+    ZE_GPU_SCOPE(commandBuffer, pass.name);
+
+    TPtrArr<VulkanImageView> framebufferImageArr;
+    std::vector<VkAttachmentDescription> colorAttachmentArr;
+    std::optional<VkAttachmentDescription> depthAttachment;
+    TPtr<VulkanImageView> depthImageView;
+    VkExtent2D extent{0, 0};
+
+    for (TextureUsage& usage : pass.usageArr)
+    {
+        TextureNode& texture = _textureArr[usage.texture];
+        PhysicalTexture& physical = _physicalArr[texture.physicalIndex];
+
+        VkImageLayout layout;
+        VkPipelineStageFlags stageMask;
+        VkAccessFlags accessMask;
+        bool isWrite;
+        GetAccessState(usage.access, texture.desc.format, layout, stageMask, accessMask, isWrite);
+
+        bool discardContents = usage.access != ERenderGraphAccess::ShaderRead && usage.loadOp != VK_ATTACHMENT_LOAD_OP_LOAD;
+        AddBarrier(physical, discardContents, layout, stageMask, accessMask, isWrite);
+
+        if (usage.access == ERenderGraphAccess::ShaderRead)
+            continue;
+
+        // The barrier above already moved the image, the render pass itself transitions nothing
+        VkAttachmentDescription attachment{};
+        attachment.format = texture.desc.format;
+        attachment.samples = VK_SAMPLE_COUNT_1_BIT;
+        attachment.loadOp = usage.loadOp;
+        attachment.storeOp = usage.storeOp;
+        attachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+        attachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+        attachment.initialLayout = layout;
+        attachment.finalLayout = layout;
+
+        extent = VkExtent2D{texture.desc.extent.width, texture.desc.extent.height};
+
+        if (usage.access == ERenderGraphAccess::ColorAttachment)
+        {
+            colorAttachmentArr.push_back(attachment);
+            framebufferImageArr.push_back(physical.imageView);
+        }
+        else
+        {
+            depthAttachment = attachment;
+            depthImageView = physical.imageView;
+        }
+    }
+
+    FlushBarriers(commandBuffer);
+
+    if (colorAttachmentArr.empty() && !depthAttachment.has_value())
+    {
+        pass.callback(RenderGraphPassContext{commandBuffer, nullptr, nullptr, extent, frame});
+        return;
+    }
+
+    std::vector<VkClearValue> clearValues(colorAttachmentArr.size());
+    for (VkClearValue& clearValue : clearValues)
+        clearValue.color = {0.0f, 0.0f, 0.0f, 0.0f};
+
+    if (depthAttachment.has_value())
+    {
+        framebufferImageArr.push_back(depthImageView);
+
+        // Reversed depth, far plane is 0
+        VkClearValue clearValue;
+        clearValue.depthStencil.depth = 0.0f;
+        clearValue.depthStencil.stencil = 0;
+        clearValues.push_back(clearValue);
+    }
+
+    TPtr<VulkanRenderPass> renderPass = RenderSystem::Get().GetRenderPassCache()->GetOrCreate(colorAttachmentArr, depthAttachment);
+    TPtr<VulkanFramebuffer> framebuffer = RenderSystem::Get().GetFramebufferCache()->GetOrCreate(renderPass, framebufferImageArr, extent);
+    // Cached framebuffers may be evicted, the frame keeps this one alive until the GPU is done
+    frame->PutFramebuffer(framebuffer);
+
+    commandBuffer->BeginRenderPass(renderPass, framebuffer, {{0, 0}, extent}, clearValues, pass.contents);
+    pass.callback(RenderGraphPassContext{commandBuffer, renderPass, framebuffer, extent, frame});
+    commandBuffer->EndRenderPass();
+}
+
+void RenderGraph::AddBarrier(PhysicalTexture& physical, bool discardContents, VkImageLayout layout, VkPipelineStageFlags stageMask, VkAccessFlags accessMask, bool isWrite)
+{
+    // Reads in the same layout can overlap, anything else has to wait for the previous accesses
+    bool isNeeded = physical.layout != layout || physical.hasPendingWrite || (isWrite && physical.accessMask != VK_ACCESS_NONE);
+    if (!isNeeded)
+    {
+        physical.stageMask |= stageMask;
+        physical.accessMask |= accessMask;
+        return;
+    }
+
+    VkImageMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.oldLayout = discardContents ? VK_IMAGE_LAYOUT_UNDEFINED : physical.layout;
+    barrier.newLayout = layout;
+    barrier.srcAccessMask = physical.hasPendingWrite ? physical.accessMask & WriteAccessMask : VK_ACCESS_NONE;
+    barrier.dstAccessMask = accessMask;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = physical.imageView->GetImage()->GetRawImage();
+    barrier.subresourceRange.aspectMask = VulkanImage::GetAspectMask(physical.imageView->GetImage()->GetFormat());
+    barrier.subresourceRange.baseMipLevel = 0;
+    barrier.subresourceRange.levelCount = 1;
+    barrier.subresourceRange.baseArrayLayer = 0;
+    barrier.subresourceRange.layerCount = 1;
+
+    _pendingBarrierArr.push_back(barrier);
+    _pendingSrcStageMask |= physical.stageMask;
+    _pendingDstStageMask |= stageMask;
+
+    physical.layout = layout;
+    physical.stageMask = stageMask;
+    physical.accessMask = accessMask;
+    physical.hasPendingWrite = isWrite;
+}
+
+void RenderGraph::FlushBarriers(TPtr<VulkanCommandBuffer> commandBuffer)
+{
+    if (_pendingBarrierArr.empty())
+        return;
+
+    vkCmdPipelineBarrier(commandBuffer->GetRawCommandBuffer(), _pendingSrcStageMask, _pendingDstStageMask, 0, 0, nullptr, 0, nullptr, static_cast<uint32_t>(_pendingBarrierArr.size()), _pendingBarrierArr.data());
+
+    _pendingBarrierArr.clear();
+    _pendingSrcStageMask = 0;
+    _pendingDstStageMask = 0;
+}
+
+TPtr<VulkanImageView> RenderGraph::GetImageView(RenderGraphTextureHandle texture)
+{
+    uint32_t physicalIndex = _textureArr[texture].physicalIndex;
+    return physicalIndex == InvalidIndex ? nullptr : _physicalArr[physicalIndex].imageView;
+}
+
+uint32_t RenderGraph::GetPassCount()
+{
+    return static_cast<uint32_t>(_passArr.size());
+}
+
+uint32_t RenderGraph::GetCulledPassCount()
+{
+    return static_cast<uint32_t>(std::count_if(_passArr.begin(), _passArr.end(), [](const PassNode& pass) { return pass.isCulled; }));
+}
+
+uint32_t RenderGraph::GetTextureCount()
+{
+    return static_cast<uint32_t>(_textureArr.size());
+}
+
+uint32_t RenderGraph::GetPhysicalTextureCount()
+{
+    return static_cast<uint32_t>(_physicalArr.size());
+}
+
+} // namespace Z
\ No newline at end of file
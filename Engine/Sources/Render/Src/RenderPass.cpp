@@ -1,18 +1,40 @@
 #include "RenderPass.h"
-#include "RenderTargets.h"
 #include "Frame.h"
+#include "Mesh.h"
+#include "Material.h"
+#include "RenderSystem.h"
+#include "GraphicPipelineCache.h"
+#include "GpuCuller.h"
+#include "Scene/SceneObject.h"
+#include "Scene/MeshComponent.h"
+#include "Scene/TransformComponent.h"
+#include "Resource/MeshResource.h"
 #include "Graphic/VulkanCommandBuffer.h"
 #include "Graphic/VulkanRenderPass.h"
 #include "Graphic/VulkanFramebuffer.h"
 #include "Graphic/VulkanImage.h"
 #include "Graphic/VulkanImageView.h"
 #include "Graphic/VulkanBuffer.h"
+#include "Graphic/VulkanRingBuffer.h"
+#include "Graphic/VulkanPipeline.h"
+#include "Graphic/VulkanPipelineLayout.h"
+#include "Graphic/VulkanDescriptorSet.h"
+#include "Job/JobSystem.h"
+#include "Debug/CpuProfiler.h"
+#include "Debug/GpuProfiler.h"
 
-namespace ZE {
+#include <algorithm>
 
+namespace ZE {
 
+// Below this many draws a pass is recorded inline, spreading it costs more than it saves
+const size_t MinParallelDrawCount = 512;
+// Draws per secondary command buffer, more chunks than threads even out uneven chunks
+const size_t MinDrawChunkSize = 128;
+const size_t DrawChunksPerThread = 4;
 
-RenderPass::RenderPass()
+RenderPass::RenderPass(EPassType passType)
+    : _passType(passType), _viewProjection(1.0f)
 {
 }
 
@@ -20,17 +42,237 @@ RenderPass::~RenderPass()
 {
 }
 
-void RenderPass::Execute(TPtrArr<SceneObject> objectsToRender, TPtr<VulkanCommandBuffer> commandBuffer, const glm::ivec2& viewportSize)
+const char* RenderPass::GetName()
 {
-    VkViewport viewport{0.0f, 0.0f, static_cast<float>(viewportSize.x), static_cast<float>(viewportSize.y), 0.0f, 1.0f};
-    vkCmdSetViewport(commandBuffer->GetRawCommandBuffer(), 0, 1, &viewport);
+    return "RenderPass";
+}
 
-    VkRect2D scissor{0, 0, static_cast<int32_t>(viewportSize.x), static_cast<int32_t>(viewportSize.y)};
-    vkCmdSetScissor(commandBuffer->GetRawCommandBuffer(), 0, 1, &scissor);
+RenderGraphPassBuilder RenderPass::AddToGraph(RenderGraph& graph, TPtrArr<SceneObject> objectsToRender)
+{
+    // A handful of indirect draws, not worth spreading over threads
+    if (_gpuCuller != nullptr)
+    {
+        return graph.AddPass(GetName(), [this, gpuCuller = _gpuCuller](const RenderGraphPassContext& context) {
+            SetRenderPass(context.renderPass);
+            SetViewport(context.commandBuffer, glm::ivec2{static_cast<int>(context.extent.width), static_cast<int>(context.extent.height)});
+            DrawIndirect(gpuCuller, context.commandBuffer);
+        });
+    }
+
+    // Decided while setting up, the graph has to begin the render pass for secondary command buffers
+    bool isParallel = IsParallelRecording(objectsToRender.size());
+
+    // Passes are owned by the renderer and outlive the per frame graph
+    RenderGraphPassBuilder builder = graph.AddPass(GetName(), [this, objectsToRender, isParallel](const RenderGraphPassContext& context) {
+        SetRenderPass(context.renderPass);
+
+        if (isParallel)
+            ExecuteParallel(objectsToRender, context);
+        else
+            Execute(objectsToRender, context.commandBuffer, glm::ivec2{static_cast<int>(context.extent.width), static_cast<int>(context.extent.height)});
+    });
+
+    if (isParallel)
+        builder.RecordSecondary();
+
+    return builder;
+}
+
+bool RenderPass::IsParallelRecording(size_t drawCount)
+{
+    if (drawCount < MinParallelDrawCount || JobSystem::Get().GetWorkerCount() == 0)
+        return false;
+
+#ifdef ZE_GPU_PROFILER
+    // Draw scopes share the profiler's scope stack, they have to be recorded by a single thread
+    if (GpuProfiler* gpuProfiler = GpuProfiler::TryGet())
+        return !gpuProfiler->IsDrawScopesEnabled();
+#endif
+
+    return true;
+}
+
+void RenderPass::SetRenderPass(TPtr<VulkanRenderPass> renderPass)
+{
+    _renderPass = renderPass;
+}
+
+void RenderPass::SetViewProjection(const glm::mat4x4& viewProjection)
+{
+    _viewProjection = viewProjection;
+}
+
+void RenderPass::SetGpuCuller(TPtr<GpuCuller> gpuCuller)
+{
+    _gpuCuller = gpuCuller;
+}
+
+void RenderPass::Execute(const TPtrArr<SceneObject>& objectsToRender, TPtr<VulkanCommandBuffer> commandBuffer, const glm::ivec2& viewportSize)
+{
+    SetViewport(commandBuffer, viewportSize);
 
     Draw(objectsToRender, commandBuffer);
+}
+
+void RenderPass::ExecuteParallel(const TPtrArr<SceneObject>& objectsToRender, const RenderGraphPassContext& context)
+{
+    ZE_CPU_SCOPE("RenderPass::ExecuteParallel");
+
+    JobSystem& jobSystem = JobSystem::Get();
+    size_t chunkSize = std::max(MinDrawChunkSize, objectsToRender.size() / (jobSystem.GetThreadCount() * DrawChunksPerThread));
+    size_t chunkCount = (objectsToRender.size() + chunkSize - 1) / chunkSize;
+
+    glm::ivec2 viewportSize{static_cast<int>(context.extent.width), static_cast<int>(context.extent.height)};
+    std::span<const TPtr<SceneObject>> objectSpan(objectsToRender);
+
+    // Every chunk has its own slot, whichever thread records it
+    TPtrArr<VulkanCommandBuffer> commandBufferArr(chunkCount);
+    jobSystem.ParallelFor(chunkCount, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++)
+        {
+            size_t first = i * chunkSize;
+            size_t count = std::min(chunkSize, objectsToRender.size() - first);
+
+            TPtr<VulkanCommandBuffer> commandBuffer = context.frame->GetSecondaryCommandBuffer();
+            commandBuffer->BeginSecondary(context.renderPass, context.framebuffer);
+            // Secondary command buffers inherit no dynamic state
+            SetViewport(commandBuffer, viewportSize);
+            Draw(objectSpan.subspan(first, count), commandBuffer);
+            commandBuffer->End();
+
+            commandBufferArr[i] = commandBuffer;
+        }
+    });
+
+    context.commandBuffer->ExecuteCommands(commandBufferArr);
+}
 
-    commandBuffer->EndRenderPass();
+void RenderPass::Draw(std::span<const TPtr<SceneObject>> objectsToRender, TPtr<VulkanCommandBuffer> commandBuffer)
+{
+    ZE_CPU_SCOPE("RenderPass::Draw");
+
+    if (objectsToRender.empty())
+        return;
+
+    VkCommandBuffer vkCommandBuffer = commandBuffer->GetRawCommandBuffer();
+    TPtr<VulkanRingBuffer> uniformRingBuffer = RenderSystem::Get().GetUniformRingBuffer();
+
+    // The MVPs of the chunk are packed into one allocation bound as instance data, every draw selects its own
+    // through the first instance. Threads recording other chunks barely touch the ring's lock
+    void* instanceAddress;
+    VkDeviceSize instanceOffset = uniformRingBuffer->Allocate(sizeof(glm::mat4x4) * static_cast<uint32_t>(objectsToRender.size()), instanceAddress);
+    glm::mat4x4* instanceMatrices = static_cast<glm::mat4x4*>(instanceAddress);
+
+    VkBuffer instanceBuffer = uniformRingBuffer->GetBuffer()->GetRawBuffer();
+    vkCmdBindVertexBuffers(vkCommandBuffer, Mesh::InstanceBinding, 1, &instanceBuffer, &instanceOffset);
+
+    // Consecutive objects mostly share mesh and material, state is only looked up and bound when they change
+    Mesh* boundMesh = nullptr;
+    Pass* boundPass = nullptr;
+
+    for (size_t i = 0; i < objectsToRender.size(); i++)
+    {
+        ZE_GPU_DRAW_SCOPE(commandBuffer, "Draw");
+
+        const TPtr<SceneObject>& object = objectsToRender[i];
+        TPtr<MeshComponent> meshComponent = object->GetComponent<MeshComponent>();
+
+        TPtr<MeshResource> meshResource = meshComponent->GetMesh();
+        TPtr<MaterialResource> materialResource = meshComponent->GetMaterial(0);
+
+        TPtr<Mesh> mesh = meshResource->GetMesh();
+        TPtr<Material> material = materialResource->GetMaterial();
+        TPtr<Pass> pass = material->GetPass(_passType);
+
+        if (mesh.get() != boundMesh || pass.get() != boundPass)
+        {
+            RHIPipelineState pipelineState;
+            mesh->ApplyPipelineState(pipelineState);
+            pass->ApplyPipelineState(pipelineState);
+            TPtr<VulkanGraphicPipeline> pipeline = RenderSystem::Get().GetPipelineCache()->GetOrCreate(pipelineState, _renderPass);
+
+            vkCmdBindPipeline(vkCommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline->GetRawPipeline());
+        }
+
+        if (mesh.get() != boundMesh)
+        {
+            // Vertex Input
+            VkBuffer vertexBuffers[] = {mesh->GetVertexBuffer()->GetRawBuffer()};
+            VkDeviceSize offsets[] = {0};
+            vkCmdBindVertexBuffers(vkCommandBuffer, 0, 1, vertexBuffers, offsets);
+            vkCmdBindIndexBuffer(vkCommandBuffer, mesh->GetIndexBuffer()->GetRawBuffer(), 0, VK_INDEX_TYPE_UINT32);
+        }
+
+        if (pass.get() != boundPass)
+            vkCmdBindDescriptorSets(vkCommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pass->GetPipelineLayout()->GetRawPipelineLayout(), 0, 1, &pass->GetDescriptorSet()->GetRawDescriptorSet(), 0, nullptr);
+
+        boundMesh = mesh.get();
+        boundPass = pass.get();
+
+        // Instance data
+        instanceMatrices[i] = _viewProjection * object->GetComponent<TransformComponent>()->GetRenderTransform();
+
+        // Draw
+        vkCmdDrawIndexed(vkCommandBuffer, mesh->GetVerticesCount(), 1, 0, 0, static_cast<uint32_t>(i));
+    }
+}
+
+void RenderPass::DrawIndirect(TPtr<GpuCuller> gpuCuller, TPtr<VulkanCommandBuffer> commandBuffer)
+{
+    ZE_CPU_SCOPE("RenderPass::DrawIndirect");
+
+    // Nothing was dispatched yet
+    if (gpuCuller->GetIndirectBuffer() == nullptr)
+        return;
+
+    VkCommandBuffer vkCommandBuffer = commandBuffer->GetRawCommandBuffer();
+
+    VkBuffer instanceBuffer = gpuCuller->GetInstanceBuffer()->GetRawBuffer();
+    VkDeviceSize instanceOffset = 0;
+    vkCmdBindVertexBuffers(vkCommandBuffer, Mesh::InstanceBinding, 1, &instanceBuffer, &instanceOffset);
+
+    VkBuffer indirectBuffer = gpuCuller->GetIndirectBuffer()->GetRawBuffer();
+    VkBuffer drawCountBuffer = gpuCuller->GetDrawCountBuffer()->GetRawBuffer();
+
+    const std::vector<GpuDrawGroup>& drawGroupArr = gpuCuller->GetDrawGroups();
+    for (size_t i = 0; i < drawGroupArr.size(); i++)
+    {
+        const GpuDrawGroup& drawGroup = drawGroupArr[i];
+        if (drawGroup.objectCount == 0 || !drawGroup.mesh->IsReady() || !drawGroup.material->IsReady())
+            continue;
+
+        ZE_GPU_DRAW_SCOPE(commandBuffer, "DrawIndirect");
+
+        TPtr<Mesh> mesh = drawGroup.mesh;
+        TPtr<Pass> pass = drawGroup.material->GetPass(_passType);
+
+        RHIPipelineState pipelineState;
+        mesh->ApplyPipelineState(pipelineState);
+        pass->ApplyPipelineState(pipelineState);
+        TPtr<VulkanGraphicPipeline> pipeline = RenderSystem::Get().GetPipelineCache()->GetOrCreate(pipelineState, _renderPass);
+        vkCmdBindPipeline(vkCommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline->GetRawPipeline());
+
+        VkBuffer vertexBuffers[] = {mesh->GetVertexBuffer()->GetRawBuffer()};
+        VkDeviceSize offsets[] = {0};
+        vkCmdBindVertexBuffers(vkCommandBuffer, 0, 1, vertexBuffers, offsets);
+        vkCmdBindIndexBuffer(vkCommandBuffer, mesh->GetIndexBuffer()->GetRawBuffer(), 0, VK_INDEX_TYPE_UINT32);
+
+        vkCmdBindDescriptorSets(vkCommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pass->GetPipelineLayout()->GetRawPipelineLayout(), 0, 1, &pass->GetDescriptorSet()->GetRawDescriptorSet(), 0, nullptr);
+
+        // The group's range holds one command per visible object, the cull dispatch wrote their count
+        VkDeviceSize commandOffset = drawGroup.commandOffset * sizeof(VkDrawIndexedIndirectCommand);
+        VkDeviceSize countOffset = i * sizeof(uint32_t);
+        vkCmdDrawIndexedIndirectCount(vkCommandBuffer, indirectBuffer, commandOffset, drawCountBuffer, countOffset, drawGroup.objectCount, sizeof(VkDrawIndexedIndirectCommand));
+    }
+}
+
+void RenderPass::SetViewport(TPtr<VulkanCommandBuffer> commandBuffer, const glm::ivec2& viewportSize)
+{
+    VkViewport viewport{0.0f, 0.0f, static_cast<float>(viewportSize.x), static_cast<float>(viewportSize.y), 0.0f, 1.0f};
+    vkCmdSetViewport(commandBuffer->GetRawCommandBuffer(), 0, 1, &viewport);
+
+    VkRect2D scissor{0, 0, static_cast<uint32_t>(viewportSize.x), static_cast<uint32_t>(viewportSize.y)};
+    vkCmdSetScissor(commandBuffer->GetRawCommandBuffer(), 0, 1, &scissor);
 }
 
 } // namespace ZE
\ No newline at end of file
@@ -0,0 +1,71 @@
+#include "RenderPassCache.h"
+#include "Graphic/VulkanDevice.h"
+#include "Graphic/VulkanRenderPass.h"
+
+
+namespace ZE {
+
+RenderPassCache::RenderPassCache(TPtr<VulkanDevice> device)
+    : _device(device), _hitCount(0), _missCount(0)
+{
+}
+
+RenderPassCache::~RenderPassCache()
+{
+    Clear();
+}
+
+TPtr<VulkanRenderPass> RenderPassCache::GetOrCreate(const std::vector<VkAttachmentDescription>& colorAttachmentArr, const std::optional<VkAttachmentDescription>& depthAttachment)
+{
+    HashWriter writer;
+    writer.Write(static_cast<uint32_t>(colorAttachmentArr.size()));
+    for (const VkAttachmentDescription& attachment : colorAttachmentArr)
+        writer.Write(attachment);
+
+    writer.Write(depthAttachment.has_value());
+    if (depthAttachment.has_value())
+        writer.Write(depthAttachment.value());
+
+    HashKey key(writer);
+
+    auto iter = _renderPasses.find(key);
+    if (iter != _renderPasses.end())
+    {
+        _hitCount++;
+        return iter->second;
+    }
+
+    _missCount++;
+
+    TPtr<VulkanRenderPass> renderPass;
+    if (depthAttachment.has_value())
+        renderPass = std::make_shared<VulkanRenderPass>(_device, colorAttachmentArr, depthAttachment.value());
+    else
+        renderPass = std::make_shared<VulkanRenderPass>(_device, colorAttachmentArr);
+
+    _renderPasses.emplace(std::move(key), renderPass);
+
+    return renderPass;
+}
+
+void RenderPassCache::Clear()
+{
+    _renderPasses.clear();
+}
+
+uint64_t RenderPassCache::GetHitCount()
+{
+    return _hitCount;
+}
+
+uint64_t RenderPassCache::GetMissCount()
+{
+    return _missCount;
+}
+
+size_t RenderPassCache::GetSize()
+{
+    return _renderPasses.size();
+}
+
+} // namespace ZE
\ No newline at end of file
@@ -1,15 +1,28 @@
 #include "RenderSystem.h"
+#include "GraphicPipelineCache.h"
+#include "RenderPassCache.h"
+#include "FramebufferCache.h"
+#include "RenderTargetPool.h"
 #include "Graphic/VulkanGPU.h"
 #include "Graphic/VulkanDevice.h"
 #include "Graphic/VulkanQueue.h"
-#include "Graphic/VulkanDescriptorPool.h"
+#include "Graphic/VulkanDescriptorAllocator.h"
 #include "Graphic/VulkanCommandBufferManager.h"
 #include "Graphic/VulkanCommandPool.h"
 #include "Graphic/VulkanBufferManager.h"
+#include "Graphic/VulkanPipelineCache.h"
+#include "Graphic/VulkanRingBuffer.h"
+#include "Graphic/VulkanMemoryAllocator.h"
+#include "Graphic/VulkanMemoryDefragmenter.h"
+#include "Graphic/VulkanAsyncUploader.h"
+#include "Graphic/VulkanDeletionQueue.h"
+#include "Graphic/VulkanTimelineSemaphore.h"
 
 #include <vulkan/vulkan.h>
+#include <glm/mat4x4.hpp>
 
 #include <stdexcept>
+#include <filesystem>
 #include <assert.h>
 
 
@@ -17,14 +30,35 @@ namespace ZE {
 
 RenderSystem* RenderSystem::_instance{nullptr};
 
-void RenderSystem::Initialize()
+// Flush the driver pipeline cache to disk every this many frames, a crash keeps most of the warmup
+const uint64_t PipelineCacheSaveInterval = 3600;
+
+// Room for 64k draws a frame, the per draw MVPs are packed as instance data
+const uint32_t UniformRingRegionSize = 4 * 1024 * 1024;
+
+// Uploads larger than a quarter of the ring get a temporary staging buffer
+const VkDeviceSize StagingRingSize = 32 * 1024 * 1024;
+
+// The budget query is cheap but the numbers only move as fast as allocations do
+const uint64_t MemoryBudgetUpdateInterval = 30;
+
+// Sets per descriptor pool, every material pass takes one
+const uint32_t DescriptorSetsPerPool = 256;
+
+// Bytes the defragmenter may copy per frame
+const VkDeviceSize MaxDefragmentationMoveSize = 8 * 1024 * 1024;
+
+// Objects destroyed per frame, unloading a level spreads its destruction over a few frames
+const uint32_t MaxDeletionsPerTick = 256;
+
+void RenderSystem::Initialize(bool isHeadless, uint32_t framesInFlight)
 {
     assert(_instance == nullptr);
 
     if (_instance != nullptr)
         return;
 
-    _instance = new RenderSystem();
+    _instance = new RenderSystem(isHeadless, framesInFlight);
 }
 
 void RenderSystem::Cleanup()
@@ -46,44 +80,83 @@ RenderSystem& RenderSystem::Get()
     return *_instance;
 }
 
-RenderSystem::RenderSystem()
-    : _GPU(nullptr), _device(nullptr)
+RenderSystem::RenderSystem(bool isHeadless, uint32_t framesInFlight)
+    : _isHeadless(isHeadless), _framesInFlight(framesInFlight), _GPU(nullptr), _device(nullptr), _frameValue(1), _tickCount(0)
 {
-    _CreateVulkanInstance();
+    _CreateVulkanInstance(isHeadless);
+
+    std::vector<const char*> deviceExtensions;
+    if (!isHeadless)
+        deviceExtensions.push_back(VK_KHR_SWAPCHAIN_EXTENSION_NAME);
 
-    _GPU = std::make_shared<VulkanGPU>(_vkInstance);
+    _GPU = std::make_shared<VulkanGPU>(_vkInstance, deviceExtensions);
     _device = std::make_shared<VulkanDevice>(_GPU);
 
+    _frameTimeline = std::make_shared<VulkanTimelineSemaphore>(_device, 0);
+
+    _deletionQueue = std::make_shared<VulkanDeletionQueue>(_frameTimeline, MaxDeletionsPerTick);
+    _device->SetDeletionQueue(_deletionQueue);
+
     TPtr<VulkanQueue> graphicQueue = std::make_shared<VulkanQueue>(_device, VulkanQueue::EType::Graphic, _device->GetGraphicQueueFamilyIndex());
     TPtr<VulkanQueue> computeQueue = std::make_shared<VulkanQueue>(_device, VulkanQueue::EType::Compute, _device->GetComputeQueueFamilyIndex());
     TPtr<VulkanQueue> transferQueue = std::make_shared<VulkanQueue>(_device, VulkanQueue::EType::Transfer, _device->GetTransferQueueFamilyIndex());
 
     _queueArr = {graphicQueue, computeQueue, transferQueue};
 
-    std::vector<VkDescriptorPoolSize> poolSizeArr = {{VkDescriptorType::VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 10}, {VkDescriptorType::VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 10}};
-    _descriptorPool = std::make_shared<VulkanDescriptorPool>(_device, poolSizeArr);
+    // Material passes only bind their texture, per draw data comes in as instance attributes
+    std::vector<VkDescriptorPoolSize> poolSizeArr = {{VkDescriptorType::VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, DescriptorSetsPerPool}};
+    _descriptorAllocator = std::make_shared<VulkanDescriptorAllocator>(_device, poolSizeArr, DescriptorSetsPerPool);
 
     _commandBufferManager = std::make_shared<VulkanCommandBufferManager>(_device, _queueArr);
 
-    _bufferManager = std::make_shared<VulkanBufferManager>(_device);
+    _bufferManager = std::make_shared<VulkanBufferManager>(_device, StagingRingSize, _frameTimeline);
+
+    _driverPipelineCache = std::make_shared<VulkanPipelineCache>(_device, std::filesystem::temp_directory_path() / "ZEnginePipelineCache.bin");
+    _pipelineCache = std::make_shared<GraphicPipelineCache>(_device, _driverPipelineCache);
+    _renderPassCache = std::make_shared<RenderPassCache>(_device);
+    _framebufferCache = std::make_shared<FramebufferCache>(_device);
+    _renderTargetPool = std::make_shared<RenderTargetPool>(_device);
+
+    // Only read as instance vertex data, allocations are aligned to the attribute stride
+    _uniformRingBuffer = std::make_shared<VulkanRingBuffer>(_device, UniformRingRegionSize, _framesInFlight, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, static_cast<uint32_t>(sizeof(glm::mat4x4)));
+
+    // Moved buffers are exclusive to the graphic family, a transfer queue of another family would need ownership transfers
+    TPtr<VulkanQueue> defragmentationQueue = transferQueue->GetFamilyIndex() == graphicQueue->GetFamilyIndex() ? transferQueue : graphicQueue;
+    _memoryDefragmenter = std::make_shared<VulkanMemoryDefragmenter>(_device, defragmentationQueue, MaxDefragmentationMoveSize);
+
+    _asyncUploader = std::make_shared<VulkanAsyncUploader>(_device, _bufferManager, transferQueue, graphicQueue);
 }
 
 RenderSystem::~RenderSystem()
 {
     _device->WaitIdle();
 
-    _pipelineCache.clear();
+    // Nothing is in flight anymore, from here on objects are destroyed right away
+    _device->SetDeletionQueue(nullptr);
+    _deletionQueue->Flush();
+    _deletionQueue.reset();
+
+    _framebufferCache.reset();
+    _renderTargetPool.reset();
+    _uniformRingBuffer.reset();
+    _memoryDefragmenter.reset();
+    _asyncUploader.reset();
+    _pipelineCache.reset();
+    _renderPassCache.reset();
+    _driverPipelineCache->Save();
+    _driverPipelineCache.reset();
     _bufferManager.reset();
     _commandBufferManager.reset();
-    _descriptorPool.reset();
+    _descriptorAllocator.reset();
     _queueArr.clear();
+    _frameTimeline.reset();
     _device.reset();
     _GPU.reset();
 
     _DestroyVulkanInstance();
 }
 
-void RenderSystem::_CreateVulkanInstance()
+void RenderSystem::_CreateVulkanInstance(bool isHeadless)
 {
     const std::string appName{"ZEngine"};
 
@@ -96,17 +169,21 @@ void RenderSystem::_CreateVulkanInstance()
     vkAppInfo.engineVersion = VK_MAKE_VERSION(1, 0, 0);
     vkAppInfo.apiVersion = VK_HEADER_VERSION_COMPLETE;
 
-    const std::vector<const char*> extensions = {
-        "VK_KHR_surface",
-#ifdef ZE_PLATFORM_WINDOWS
-        "VK_KHR_win32_surface",
-#endif
+    std::vector<const char*> extensions = {
 #ifdef ZE_PLATFORM_MACOS
         VK_KHR_PORTABILITY_ENUMERATION_EXTENSION_NAME,
         VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME
 #endif
     };
 
+    if (!isHeadless)
+    {
+        extensions.push_back("VK_KHR_surface");
+#ifdef ZE_PLATFORM_WINDOWS
+        extensions.push_back("VK_KHR_win32_surface");
+#endif
+    }
+
     const std::vector<const char*> validationLayers = {
 #ifdef ZE_DEBUG
         "VK_LAYER_KHRONOS_validation"
@@ -140,7 +217,23 @@ void RenderSystem::_DestroyVulkanInstance()
 
 void RenderSystem::Tick()
 {
-    _bufferManager->Tick();
+    // The frame just submitted signals the previous value
+    _frameValue++;
+
+    _deletionQueue->Tick(_frameValue);
+    _bufferManager->Tick(_frameValue);
+    _pipelineCache->Tick();
+    _framebufferCache->Tick();
+    _renderTargetPool->Tick();
+    _memoryDefragmenter->Tick();
+    _asyncUploader->Tick();
+
+    _tickCount++;
+    if (_tickCount % MemoryBudgetUpdateInterval == 0)
+        _device->GetMemoryAllocator()->UpdateBudget();
+
+    if (_tickCount % PipelineCacheSaveInterval == 0)
+        _driverPipelineCache->Save();
 }
 
 
@@ -158,9 +251,9 @@ TPtr<VulkanQueue> RenderSystem::GetQueue(VulkanQueue::EType type)
         return _queueArr[index];
 }
 
-TPtr<VulkanDescriptorPool> RenderSystem::GetDescriptorPool()
+TPtr<VulkanDescriptorAllocator> RenderSystem::GetDescriptorAllocator()
 {
-    return _descriptorPool;
+    return _descriptorAllocator;
 }
 
 TPtr<VulkanCommandBufferManager> RenderSystem::GetCommandBufferManager()
@@ -173,9 +266,69 @@ TPtr<VulkanCommandBufferManager> RenderSystem::GetCommandBufferManager()
     return _bufferManager;
  }
 
-TPtrSet<VulkanGraphicPipeline>& RenderSystem::GetPipelineCache()
- {
+TPtr<GraphicPipelineCache> RenderSystem::GetPipelineCache()
+{
     return _pipelineCache;
- }
+}
+
+TPtr<VulkanPipelineCache> RenderSystem::GetDriverPipelineCache()
+{
+    return _driverPipelineCache;
+}
+
+TPtr<RenderPassCache> RenderSystem::GetRenderPassCache()
+{
+    return _renderPassCache;
+}
+
+TPtr<FramebufferCache> RenderSystem::GetFramebufferCache()
+{
+    return _framebufferCache;
+}
+
+TPtr<RenderTargetPool> RenderSystem::GetRenderTargetPool()
+{
+    return _renderTargetPool;
+}
+
+TPtr<VulkanRingBuffer> RenderSystem::GetUniformRingBuffer()
+{
+    return _uniformRingBuffer;
+}
+
+TPtr<VulkanMemoryDefragmenter> RenderSystem::GetMemoryDefragmenter()
+{
+    return _memoryDefragmenter;
+}
+
+TPtr<VulkanAsyncUploader> RenderSystem::GetAsyncUploader()
+{
+    return _asyncUploader;
+}
+
+TPtr<VulkanDeletionQueue> RenderSystem::GetDeletionQueue()
+{
+    return _deletionQueue;
+}
+
+TPtr<VulkanTimelineSemaphore> RenderSystem::GetFrameTimeline()
+{
+    return _frameTimeline;
+}
+
+uint64_t RenderSystem::GetFrameValue()
+{
+    return _frameValue;
+}
+
+bool RenderSystem::IsHeadless()
+{
+    return _isHeadless;
+}
+
+uint32_t RenderSystem::GetFramesInFlight()
+{
+    return _framesInFlight;
+}
 
 } // namespace ZE
\ No newline at end of file
@@ -0,0 +1,98 @@
+#include "RenderTargetPool.h"
+#include "Graphic/VulkanDevice.h"
+#include "Graphic/VulkanImage.h"
+#include "Graphic/VulkanImageView.h"
+
+
+namespace ZE {
+
+RenderTargetPool::RenderTargetPool(TPtr<VulkanDevice> device, uint64_t evictAfterFrames)
+    : _device(device), _frame(0), _evictAfterFrames(evictAfterFrames), _allocationCount(0), _reuseCount(0)
+{
+}
+
+RenderTargetPool::~RenderTargetPool()
+{
+    Clear();
+}
+
+TPtr<VulkanImageView> RenderTargetPool::Acquire(const RenderTargetDesc& desc)
+{
+    HashWriter writer;
+    writer.Write(desc.extent);
+    writer.Write(desc.format);
+    writer.Write(desc.usage);
+    writer.Write(desc.aspect);
+    writer.Write(desc.isTransient);
+
+    std::vector<Entry>& entryArr = _entries[HashKey(writer)];
+    for (Entry& entry : entryArr)
+    {
+        // Only the pool holds it, the frame that used it last has been retired
+        if (entry.imageView.use_count() == 1)
+        {
+            _reuseCount++;
+            entry.lastUsedFrame = _frame;
+            entry.imageView->GetImage()->SetLayout(VK_IMAGE_LAYOUT_UNDEFINED);
+            return entry.imageView;
+        }
+    }
+
+    _allocationCount++;
+
+    VkImageUsageFlags usage = desc.usage;
+    VkMemoryPropertyFlags memoryProperties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+    if (desc.isTransient)
+    {
+        usage |= VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT;
+        memoryProperties |= VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT;
+    }
+
+    TPtr<VulkanImage> image = std::make_shared<VulkanImage>(_device, desc.extent, desc.format, usage, memoryProperties, EVulkanMemoryCategory::RenderTarget);
+    TPtr<VulkanImageView> imageView = std::make_shared<VulkanImageView>(image, desc.format, desc.aspect);
+    entryArr.push_back(Entry{imageView, _frame});
+
+    return imageView;
+}
+
+void RenderTargetPool::Tick()
+{
+    _frame++;
+
+    for (auto iter = _entries.begin(); iter != _entries.end();)
+    {
+        std::vector<Entry>& entryArr = iter->second;
+        std::erase_if(entryArr, [this](const Entry& entry) { return entry.imageView.use_count() == 1 && _frame - entry.lastUsedFrame > _evictAfterFrames; });
+
+        if (entryArr.empty())
+            iter = _entries.erase(iter);
+        else
+            iter++;
+    }
+}
+
+void RenderTargetPool::Clear()
+{
+    _entries.clear();
+}
+
+uint64_t RenderTargetPool::GetAllocationCount()
+{
+    return _allocationCount;
+}
+
+uint64_t RenderTargetPool::GetReuseCount()
+{
+    return _reuseCount;
+}
+
+size_t RenderTargetPool::GetSize()
+{
+    size_t size = 0;
+    for (auto& [key, entryArr] : _entries)
+        size += entryArr.size();
+
+    return size;
+}
+
+} // namespace ZE
\ No newline at end of file
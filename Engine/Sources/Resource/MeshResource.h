@@ -19,6 +19,15 @@ struct VertexData
     glm::vec2 texCoord;
 };
 
+// Object space bounds, the sphere shares the box's center and encloses every vertex
+struct MeshBounds
+{
+    glm::vec3 min;
+    glm::vec3 max;
+    glm::vec3 center;
+    float radius;
+};
+
 class MeshResource : BaseResource
 {
 public:
@@ -31,6 +40,7 @@ public:
 
     const std::vector<VertexData>& GetVertices(uint32_t meshIndex);
     const std::vector<uint32_t>& GetIndexes(uint32_t meshIndex);
+    const MeshBounds& GetBounds(uint32_t meshIndex);
 
     void SetMesh(TPtr<Mesh> mesh);
     TPtr<Mesh> GetMesh();
@@ -40,6 +50,7 @@ private:
 
     std::vector<std::vector<VertexData>> _meshVerticesData;
     std::vector<std::vector<uint32_t>> _meshIndexesData;
+    std::vector<MeshBounds> _meshBoundsArr;
 
     TPtr<Mesh> _mesh;
 };
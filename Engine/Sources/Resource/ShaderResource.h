@@ -13,7 +13,8 @@ namespace ZE {
 enum class EShaderStage : int
 {
     Vertex = 0,
-    Fragment
+    Fragment,
+    Compute
 };
 
 class ShaderResource : BaseResource
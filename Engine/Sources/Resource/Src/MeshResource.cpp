@@ -3,14 +3,48 @@
 #define TINYOBJLOADER_IMPLEMENTATION
 #include <tiny_obj_loader.h>
 
+#include <algorithm>
+#include <cmath>
+
 namespace ZE {
 
+MeshBounds ComputeBounds(const std::vector<VertexData>& verticesData)
+{
+    MeshBounds bounds{glm::vec3(0.0f), glm::vec3(0.0f), glm::vec3(0.0f), 0.0f};
+    if (verticesData.empty())
+        return bounds;
+
+    bounds.min = verticesData[0].position;
+    bounds.max = verticesData[0].position;
+    for (const VertexData& vertex : verticesData)
+    {
+        bounds.min = glm::min(bounds.min, vertex.position);
+        bounds.max = glm::max(bounds.max, vertex.position);
+    }
+
+    // Tighter than half the box diagonal unless the vertices reach into the corners
+    bounds.center = (bounds.min + bounds.max) * 0.5f;
+    float radiusSquared = 0.0f;
+    for (const VertexData& vertex : verticesData)
+    {
+        glm::vec3 offset = vertex.position - bounds.center;
+        radiusSquared = std::max(radiusSquared, glm::dot(offset, offset));
+    }
+    bounds.radius = std::sqrt(radiusSquared);
+
+    return bounds;
+}
+
 MeshResource::MeshResource(const std::filesystem::path& path) : _path(path), _mesh(nullptr)
 {
 }
 
 void MeshResource::Load()
 {
+    // Shared between every object using the mesh
+    if (_isLoaded)
+        return;
+
     tinyobj::ObjReaderConfig reader_config;
     tinyobj::ObjReader reader;
 
@@ -59,6 +93,7 @@ void MeshResource::Load()
             verticesData.push_back(vertex);
         }
 
+        _meshBoundsArr.push_back(ComputeBounds(verticesData));
         _meshVerticesData.push_back(verticesData);
         _meshIndexesData.push_back(indexesData);
     }
@@ -89,6 +124,13 @@ const std::vector<uint32_t>& MeshResource::GetIndexes(uint32_t meshIndex)
     return _meshIndexesData[meshIndex];
 }
 
+const MeshBounds& MeshResource::GetBounds(uint32_t meshIndex)
+{
+    assert(meshIndex < _meshBoundsArr.size());
+
+    return _meshBoundsArr[meshIndex];
+}
+
 void MeshResource::SetMesh(TPtr<Mesh> mesh)
 {
     _mesh = mesh;
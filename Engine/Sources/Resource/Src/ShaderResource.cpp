@@ -39,6 +39,21 @@ static std::vector<char> readFile(const std::string& filename)
     return buffer;
 }
 
+static std::string GetShaderStageName(EShaderStage stage)
+{
+    switch (stage)
+    {
+    case EShaderStage::Vertex:
+        return "vertex";
+    case EShaderStage::Fragment:
+        return "fragment";
+    case EShaderStage::Compute:
+        return "compute";
+    }
+
+    return "vertex";
+}
+
 void ShaderResource::Load()
 {
     const std::filesystem::path shaderDirectoryPath = "Engine/Shaders";
@@ -49,7 +64,8 @@ void ShaderResource::Load()
 
 #ifdef ZE_PLATFORM_WINDOWS
     std::wstring glslc = L"glslc";
-    std::wstring shaderStageDesc = _stage == EShaderStage::Vertex ? L"vertex" : L"fragment";
+    std::string shaderStageName = GetShaderStageName(_stage);
+    std::wstring shaderStageDesc(shaderStageName.begin(), shaderStageName.end());
     std::wstring arg = std::format(L" -fshader-stage={} -o {} {}", shaderStageDesc, byteCodePath.wstring(),
                                    absoluteShaderPath.wstring());
     std::wstring command = glslc + arg;
@@ -72,8 +88,8 @@ void ShaderResource::Load()
     }
 #else
     std::string glslc = "glslc";
-    std::string shaderStageDesc = _stage == EShaderStage::Vertex ? "vertex" : "fragment";
-    std::string arg = " -fshader-stage=" + shaderStageDesc + " -o " + byteCodePath.string() + " " + shaderAbsolutePath.string();
+    std::string shaderStageDesc = GetShaderStageName(_stage);
+    std::string arg = " -fshader-stage=" + shaderStageDesc + " -o " + byteCodePath.string() + " " + absoluteShaderPath.string();
     
     std::array<char, 128> buffer;
     std::string result;
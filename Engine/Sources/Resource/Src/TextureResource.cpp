@@ -15,6 +15,9 @@ TextureResource::~TextureResource()
 
 void TextureResource::Load()
 {
+    if (_isLoaded)
+        return;
+
     int width, height, channels;
     _data = stbi_load(_sourcePath.string().c_str(), &width, &height, &channels, STBI_rgb_alpha);
     _width = static_cast<uint32_t>(width);
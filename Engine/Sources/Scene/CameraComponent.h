@@ -9,6 +9,12 @@
 
 namespace ZE {
 
+// Planes as (normal, distance) with the normals facing inwards, p is inside a plane when dot(normal, p) + distance >= 0
+struct Frustum
+{
+    glm::vec4 planes[6];
+};
+
 class CameraComponent : public SceneComponent
 {
 public:
@@ -20,6 +26,9 @@ public:
     void SetProjectMatrix(const glm::mat4x4& matrix);
     const glm::mat4x4& GetProjectMatrix();
 
+    // World space, follows the render transform like the view matrix
+    Frustum GetFrustum();
+
 private:
     glm::mat4x4 _projectMatrix;
 };
@@ -8,12 +8,25 @@ namespace ZE {
 
 class SceneObject;
 class CameraComponent;
+class TransformComponent;
+class SceneUpdater;
+
+// Notified of every object entering or leaving the scene, observers have to unregister before they die
+class SceneObserver
+{
+public:
+    virtual void OnObjectAdded(TPtr<SceneObject> object) = 0;
+    virtual void OnObjectRemoved(TPtr<SceneObject> object) = 0;
+};
 
 class Scene
 {
 public:
     Scene();
 
+    void AddObserver(SceneObserver* observer);
+    void RemoveObserver(SceneObserver* observer);
+
     void AddObject(TPtr<SceneObject> object);
     void RemoveObject(TPtr<SceneObject> object);
     const TPtrArr<SceneObject>& GetObjects();
@@ -21,12 +34,33 @@ public:
     void SetCamera(TPtr<CameraComponent> cameraComponent);
     TPtr<CameraComponent> GetCamera();
 
+    // Objects added to a loaded scene are loaded right away
     void Load();
     void Unload();
 
+    // Advances the simulation by whole fixed steps, the remainder carries over to the next tick
+    void Tick(float deltaTime);
+    void SetFixedTimeStep(float fixedTimeStep);
+    float GetFixedTimeStep();
+    // How far the current time is between the last two steps, render transforms are blended by it
+    float GetInterpolationAlpha();
+
+private:
+    void LoadObject(TPtr<SceneObject> object);
+    void Invalidate();
+
 private:
     TPtrArr<SceneObject> _objects;
     TPtr<CameraComponent> _cameraComponent;
+    std::vector<SceneObserver*> _observerArr;
+    bool _isLoaded;
+
+    TPtr<SceneUpdater> _updater;
+    TPtrArr<TransformComponent> _transformArr;
+    bool _isTransformArrDirty;
+    float _fixedTimeStep;
+    float _accumulator;
+    float _interpolationAlpha;
 };
 
 }
\ No newline at end of file
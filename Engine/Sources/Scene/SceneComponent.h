@@ -17,6 +17,24 @@ enum class EComponentType : int
 
 class SceneObject;
 
+// Component types as bits, see GetComponentTypeBit
+typedef uint32_t ComponentTypeMask;
+
+constexpr ComponentTypeMask GetComponentTypeBit(EComponentType type)
+{
+    return 1u << static_cast<uint32_t>(type);
+}
+
+// What an Update touches besides the component's own state. Updates that only read and write components
+// of their own object run in parallel with every other object, and with components of the same object they
+// don't conflict with. Exclusive updates may touch anything and run alone on the main thread.
+struct ComponentAccess
+{
+    ComponentTypeMask readMask = 0;
+    ComponentTypeMask writeMask = 0;
+    bool isExclusive = true;
+};
+
 class SceneComponent
 {
 public:
@@ -34,6 +52,7 @@ public:
 
     virtual void OnAttached(){};
     virtual void Update(float deltaTime){};
+    virtual ComponentAccess GetUpdateAccess() const { return ComponentAccess{}; };
     virtual void OnDetached(){};
 
 private:
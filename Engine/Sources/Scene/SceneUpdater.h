@@ -0,0 +1,36 @@
+#pragma once
+
+#include "CoreDefines.h"
+#include "CoreTypes.h"
+#include "SceneComponent.h"
+
+
+namespace ZE {
+
+class SceneObject;
+
+// Runs the Update of every component of a scene for one step. Exclusive components run first, in scene order
+// on the calling thread. The others are sorted into stages by their declared access: within a stage no two
+// components of the same object conflict, so a stage is spread over the job system, one stage after the other.
+class SceneUpdater
+{
+public:
+    SceneUpdater();
+    ~SceneUpdater();
+
+    // The objects or their components changed, stages are rebuilt on the next Update
+    void Invalidate();
+    void Update(const TPtrArr<SceneObject>& objects, float deltaTime);
+
+    uint32_t GetStageCount();
+
+private:
+    void BuildStages(const TPtrArr<SceneObject>& objects);
+
+private:
+    bool _isDirty;
+    TPtrArr<SceneComponent> _exclusiveArr;
+    std::vector<TPtrArr<SceneComponent>> _stageArr;
+};
+
+} // namespace ZE
\ No newline at end of file
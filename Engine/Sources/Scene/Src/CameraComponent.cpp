@@ -22,7 +22,7 @@ glm::mat4x4 CameraComponent::GetViewMatrix()
     TPtr<TransformComponent> transformComponent = GetObject() ? GetObject()->GetComponent<TransformComponent>() : nullptr;
     if (transformComponent != nullptr)
     {
-        viewMatrix = glm::inverse(transformComponent->GetTransform());
+        viewMatrix = glm::inverse(transformComponent->GetRenderTransform());
     }
 
     return viewMatrix;
@@ -38,4 +38,27 @@ const glm::mat4x4& CameraComponent::GetProjectMatrix()
     return _projectMatrix;
 }
 
+Frustum CameraComponent::GetFrustum()
+{
+    // Rows of the view projection, clip space is -w <= x, y <= w and 0 <= z <= w
+    glm::mat4x4 rows = glm::transpose(_projectMatrix * GetViewMatrix());
+
+    Frustum frustum;
+    frustum.planes[0] = rows[3] + rows[0];
+    frustum.planes[1] = rows[3] - rows[0];
+    frustum.planes[2] = rows[3] + rows[1];
+    frustum.planes[3] = rows[3] - rows[1];
+    frustum.planes[4] = rows[2];
+    frustum.planes[5] = rows[3] - rows[2];
+
+    for (glm::vec4& plane : frustum.planes)
+    {
+        // An infinite far plane degenerates, it never rejects anything
+        float length = glm::length(glm::vec3(plane));
+        plane = length > 1e-6f ? plane / length : glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+    }
+
+    return frustum;
+}
+
 }
\ No newline at end of file
@@ -2,32 +2,66 @@
 #include "CameraComponent.h"
 #include "SceneObject.h"
 #include "ScriptComponent.h"
+#include "TransformComponent.h"
+#include "SceneUpdater.h"
+#include "Debug/CpuProfiler.h"
+#include "Job/JobSystem.h"
 
 #include <stdexcept>
+#include <algorithm>
 
 
 namespace ZE {
 
+const float DefaultFixedTimeStep = 1.0f / 60.0f;
+
+// A long hitch would otherwise be followed by a burst of steps that takes even longer
+const float MaxTickDeltaTime = 0.25f;
+
+const size_t MinTransformGrainSize = 256;
+
 Scene::Scene()
+    : _isLoaded(false), _isTransformArrDirty(true), _fixedTimeStep(DefaultFixedTimeStep), _accumulator(0.0f), _interpolationAlpha(0.0f)
+{
+}
+
+void Scene::AddObserver(SceneObserver* observer)
 {
+    _observerArr.push_back(observer);
+}
+
+void Scene::RemoveObserver(SceneObserver* observer)
+{
+    std::erase(_observerArr, observer);
 }
 
 void Scene::AddObject(TPtr<SceneObject> object)
 {
+    if (_isLoaded)
+        LoadObject(object);
+
     TPtrArr<ScriptComponent> scriptComponents = object->GetComponents<ScriptComponent>();
     for (const TPtr<ScriptComponent>& scriptComponent : scriptComponents)
         scriptComponent->OnAttached();
 
     _objects.push_back(object);
+    Invalidate();
+
+    for (SceneObserver* observer : _observerArr)
+        observer->OnObjectAdded(object);
 }
 
 void Scene::RemoveObject(TPtr<SceneObject> object)
 {
     _objects.erase(std::remove(_objects.begin(), _objects.end(), object));
+    Invalidate();
 
     TPtrArr<ScriptComponent> scriptComponents = object->GetComponents<ScriptComponent>();
     for (const TPtr<ScriptComponent>& scriptComponent : scriptComponents)
         scriptComponent->OnDetached();
+
+    for (SceneObserver* observer : _observerArr)
+        observer->OnObjectRemoved(object);
 }
 
 const TPtrArr<SceneObject>& Scene::GetObjects()
@@ -56,13 +90,79 @@ TPtr<CameraComponent> Scene::GetCamera()
 void Scene::Load()
 {
     for (TPtr<SceneObject>& object : _objects)
+        LoadObject(object);
+
+    _isLoaded = true;
+}
+
+void Scene::LoadObject(TPtr<SceneObject> object)
+{
+    TPtrArr<SceneComponent> components = object->GetComponents<SceneComponent>();
+    for (TPtr<SceneComponent>& component : components)
     {
-        TPtrArr<SceneComponent> components = object->GetComponents<SceneComponent>();
-        for (TPtr<SceneComponent>& component : components)
+        component->Load();
+    }
+}
+
+void Scene::Invalidate()
+{
+    _isTransformArrDirty = true;
+
+    if (_updater != nullptr)
+        _updater->Invalidate();
+}
+
+void Scene::Tick(float deltaTime)
+{
+    ZE_CPU_SCOPE("Scene::Tick");
+
+    if (_updater == nullptr)
+        _updater = std::make_shared<SceneUpdater>();
+
+    if (_isTransformArrDirty)
+    {
+        _transformArr.clear();
+        for (TPtr<SceneObject>& object : _objects)
         {
-            component->Load();
+            TPtr<TransformComponent> transformComponent = object->GetComponent<TransformComponent>();
+            if (transformComponent != nullptr)
+                _transformArr.push_back(transformComponent);
         }
+        _isTransformArrDirty = false;
+    }
+
+    _accumulator += std::min(deltaTime, MaxTickDeltaTime);
+    while (_accumulator >= _fixedTimeStep)
+    {
+        JobSystem::Get().ParallelFor(_transformArr.size(), [this](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++)
+                _transformArr[i]->BeginStep();
+        }, MinTransformGrainSize);
+
+        _updater->Update(_objects, _fixedTimeStep);
+        _accumulator -= _fixedTimeStep;
     }
+
+    _interpolationAlpha = _accumulator / _fixedTimeStep;
+    JobSystem::Get().ParallelFor(_transformArr.size(), [this](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++)
+            _transformArr[i]->UpdateRenderTransform(_interpolationAlpha);
+    }, MinTransformGrainSize);
+}
+
+void Scene::SetFixedTimeStep(float fixedTimeStep)
+{
+    _fixedTimeStep = fixedTimeStep;
+}
+
+float Scene::GetFixedTimeStep()
+{
+    return _fixedTimeStep;
+}
+
+float Scene::GetInterpolationAlpha()
+{
+    return _interpolationAlpha;
 }
 
 void Scene::Unload()
@@ -75,6 +175,8 @@ void Scene::Unload()
             component->Unload();
         }
     }
+
+    _isLoaded = false;
 }
 
 } // namespace ZE
\ No newline at end of file
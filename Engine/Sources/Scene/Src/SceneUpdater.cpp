@@ -0,0 +1,93 @@
+#include "SceneUpdater.h"
+#include "SceneObject.h"
+#include "Job/JobSystem.h"
+
+#include <algorithm>
+
+
+namespace ZE {
+
+// Fewer components per range than this cost more to hand out than to update
+const size_t MinUpdateGrainSize = 16;
+
+bool IsConflicting(const ComponentAccess& first, const ComponentAccess& second)
+{
+    return (first.writeMask & (second.readMask | second.writeMask)) != 0 || (second.writeMask & first.readMask) != 0;
+}
+
+SceneUpdater::SceneUpdater() : _isDirty(true)
+{
+}
+
+SceneUpdater::~SceneUpdater()
+{
+}
+
+void SceneUpdater::Invalidate()
+{
+    _isDirty = true;
+}
+
+void SceneUpdater::Update(const TPtrArr<SceneObject>& objects, float deltaTime)
+{
+    if (_isDirty)
+    {
+        BuildStages(objects);
+        _isDirty = false;
+    }
+
+    for (TPtr<SceneComponent>& component : _exclusiveArr)
+        component->Update(deltaTime);
+
+    for (TPtrArr<SceneComponent>& stage : _stageArr)
+    {
+        JobSystem::Get().ParallelFor(stage.size(), [&stage, deltaTime](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++)
+                stage[i]->Update(deltaTime);
+        }, MinUpdateGrainSize);
+    }
+}
+
+void SceneUpdater::BuildStages(const TPtrArr<SceneObject>& objects)
+{
+    _exclusiveArr.clear();
+    _stageArr.clear();
+
+    std::vector<std::pair<ComponentAccess, size_t>> placedArr;
+    for (const TPtr<SceneObject>& object : objects)
+    {
+        placedArr.clear();
+
+        TPtrArr<SceneComponent> components = object->GetComponents<SceneComponent>();
+        for (TPtr<SceneComponent>& component : components)
+        {
+            ComponentAccess access = component->GetUpdateAccess();
+            if (access.isExclusive)
+            {
+                _exclusiveArr.push_back(component);
+                continue;
+            }
+
+            // After every earlier component of the object it conflicts with, keeping their order
+            size_t stage = 0;
+            for (const std::pair<ComponentAccess, size_t>& placed : placedArr)
+            {
+                if (IsConflicting(placed.first, access))
+                    stage = std::max(stage, placed.second + 1);
+            }
+
+            if (stage >= _stageArr.size())
+                _stageArr.resize(stage + 1);
+
+            _stageArr[stage].push_back(component);
+            placedArr.push_back({access, stage});
+        }
+    }
+}
+
+uint32_t SceneUpdater::GetStageCount()
+{
+    return static_cast<uint32_t>(_stageArr.size());
+}
+
+} // namespace ZE
\ No newline at end of file
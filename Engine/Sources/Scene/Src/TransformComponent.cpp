@@ -1,9 +1,11 @@
 #include "TransformComponent.h"
 
+#include <glm/gtc/quaternion.hpp>
+
 
 namespace ZE {
 
-TransformComponent::TransformComponent() : SceneComponent(EComponentType::Transform), _transform(1)
+TransformComponent::TransformComponent() : SceneComponent(EComponentType::Transform), _transform(1), _previousTransform(1), _renderTransform(1), _hasStepped(false)
 {
 }
 
@@ -14,6 +16,13 @@ TransformComponent::~TransformComponent()
 void TransformComponent::SetTransform(const glm::mat4x4& transform)
 {
     _transform = transform;
+
+    // Placed before the object ever stepped, there is nothing to blend from
+    if (!_hasStepped)
+    {
+        _previousTransform = transform;
+        _renderTransform = transform;
+    }
 }
 
 const glm::mat4x4& TransformComponent::GetTransform()
@@ -21,4 +30,38 @@ const glm::mat4x4& TransformComponent::GetTransform()
     return _transform;
 }
 
+void TransformComponent::BeginStep()
+{
+    _previousTransform = _transform;
+    _hasStepped = true;
+}
+
+void TransformComponent::UpdateRenderTransform(float alpha)
+{
+    // Most objects don't move
+    if (_previousTransform == _transform)
+    {
+        _renderTransform = _transform;
+        return;
+    }
+
+    // Blending matrices would shear, translation, rotation and scale are blended apart
+    glm::vec3 previousScale{glm::length(glm::vec3(_previousTransform[0])), glm::length(glm::vec3(_previousTransform[1])), glm::length(glm::vec3(_previousTransform[2]))};
+    glm::vec3 scale{glm::length(glm::vec3(_transform[0])), glm::length(glm::vec3(_transform[1])), glm::length(glm::vec3(_transform[2]))};
+
+    glm::quat previousRotation = glm::quat_cast(glm::mat3(glm::vec3(_previousTransform[0]) / previousScale.x, glm::vec3(_previousTransform[1]) / previousScale.y, glm::vec3(_previousTransform[2]) / previousScale.z));
+    glm::quat rotation = glm::quat_cast(glm::mat3(glm::vec3(_transform[0]) / scale.x, glm::vec3(_transform[1]) / scale.y, glm::vec3(_transform[2]) / scale.z));
+
+    glm::mat3 blendedRotation = glm::mat3_cast(glm::slerp(previousRotation, rotation, alpha));
+    glm::vec3 blendedScale = glm::mix(previousScale, scale, alpha);
+
+    _renderTransform = glm::mat4x4(glm::vec4(blendedRotation[0] * blendedScale.x, 0.0f), glm::vec4(blendedRotation[1] * blendedScale.y, 0.0f), glm::vec4(blendedRotation[2] * blendedScale.z, 0.0f),
+                                   glm::mix(_previousTransform[3], _transform[3], alpha));
+}
+
+const glm::mat4x4& TransformComponent::GetRenderTransform()
+{
+    return _renderTransform;
+}
+
 }
\ No newline at end of file
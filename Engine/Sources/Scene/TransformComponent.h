@@ -18,8 +18,16 @@ public:
     void SetTransform(const glm::mat4x4& transform);
     const glm::mat4x4& GetTransform();
 
+    // Called by the scene around each fixed step, the render transform sits between the last two steps
+    void BeginStep();
+    void UpdateRenderTransform(float alpha);
+    const glm::mat4x4& GetRenderTransform();
+
 private:
     glm::mat4x4 _transform;
+    glm::mat4x4 _previousTransform;
+    glm::mat4x4 _renderTransform;
+    bool _hasStepped;
 };
 
 }
\ No newline at end of file
@@ -9,7 +9,10 @@
 #include <functional>
 
 
-CameraControlComponent::CameraControlComponent() : cachedMousePosition(glm::zero<glm::vec2>())
+// Units per second
+const float MoveSpeed = 10.0f;
+
+CameraControlComponent::CameraControlComponent() : cachedMousePosition(glm::zero<glm::vec2>()), cachedMouseDelta(glm::zero<glm::vec2>())
 {
 }
 
@@ -33,38 +36,41 @@ void CameraControlComponent::OnDetached()
     ZE::InputSystem::Get().UnregisterKeyboardAction(_keyboardActionKey);
 }
 
-void CameraControlComponent::OnMouseInput(const glm::vec2& position)
+ZE::ComponentAccess CameraControlComponent::GetUpdateAccess() const
 {
-    ZE::TPtr<ZE::TransformComponent> transformComponent = GetObject()->GetComponent<ZE::TransformComponent>();
-    if (transformComponent == nullptr)
-        return;
+    return ZE::ComponentAccess{0, ZE::GetComponentTypeBit(ZE::EComponentType::Transform), false};
+}
 
+void CameraControlComponent::OnMouseInput(const glm::vec2& position)
+{
     if (cachedMousePosition != glm::zero<glm::vec2>())
-    {
-        glm::vec2 delta = position - cachedMousePosition;
-        glm::vec2 rotate = delta * 0.1f;
-
-        glm::mat4 transform = transformComponent->GetTransform();
-
-        transform = glm::rotate(transform, glm::radians(rotate.y), glm::vec3(1.0f, 0.0f, 0.0f));
-        transform = glm::rotate(transform, glm::radians(rotate.x), glm::vec3(0.0f, -1.0f, 0.0f));
-
-        transformComponent->SetTransform(transform);
-    }
+        cachedMouseDelta += position - cachedMousePosition;
 
     cachedMousePosition = position;
 }
 
 void CameraControlComponent::OnKeyboardInput(int key, int action)
 {
-    ZE::TPtr<ZE::TransformComponent> transformComponent = GetObject()->GetComponent<ZE::TransformComponent>();
-    if (transformComponent == nullptr)
-        return;
-
     if (action == GLFW_PRESS || action == GLFW_REPEAT)
         cachedPressedKey.insert(key);
     else if (action == GLFW_RELEASE)
         cachedPressedKey.erase(key);
+}
+
+void CameraControlComponent::Update(float deltaTime)
+{
+    ZE::TPtr<ZE::TransformComponent> transformComponent = GetObject()->GetComponent<ZE::TransformComponent>();
+    if (transformComponent == nullptr)
+        return;
+
+    glm::mat4 transform = transformComponent->GetTransform();
+
+    // The mouse delta is consumed by the first step, later steps of the same frame only move
+    glm::vec2 rotate = cachedMouseDelta * 0.1f;
+    cachedMouseDelta = glm::zero<glm::vec2>();
+
+    transform = glm::rotate(transform, glm::radians(rotate.y), glm::vec3(1.0f, 0.0f, 0.0f));
+    transform = glm::rotate(transform, glm::radians(rotate.x), glm::vec3(0.0f, -1.0f, 0.0f));
 
     glm::vec3 translation{ 0 };
     for (const int key : cachedPressedKey)
@@ -87,10 +93,9 @@ void CameraControlComponent::OnKeyboardInput(int key, int action)
             break;
         }
 
-        translation = translation + delta * 1.0f;
+        translation = translation + delta * MoveSpeed * deltaTime;
     }
 
-    glm::mat4 transform = transformComponent->GetTransform();
     transform = glm::translate(transform, translation);
     transformComponent->SetTransform(transform);
 }
\ No newline at end of file
@@ -14,6 +14,8 @@ public:
 
     virtual void OnAttached() override;
     virtual void OnDetached() override;
+    virtual void Update(float deltaTime) override;
+    virtual ZE::ComponentAccess GetUpdateAccess() const override;
 
     void OnMouseInput(const glm::vec2& position);
     void OnKeyboardInput(int key, int action);
@@ -22,5 +24,7 @@ private:
     size_t _mouseActionKey, _keyboardActionKey;
 
     glm::vec2 cachedMousePosition;
+    // Input arrives between steps, Update applies it
+    glm::vec2 cachedMouseDelta;
     std::set<int> cachedPressedKey;
 };
\ No newline at end of file
@@ -16,28 +16,34 @@
 #include <glm/ext/matrix_clip_space.hpp>
 #include <glm/ext/matrix_transform.hpp>
 
-ZE::TPtr<ZE::Scene> CreateSampleScene()
-{
-    ZE::TPtr<ZE::Scene> scene = std::make_shared<ZE::Scene>();
+#include <iostream>
+#include <string>
 
-    ZE::TPtr<ZE::SceneObject> meshObject = std::make_shared<ZE::SceneObject>();
-    ZE::TPtr<ZE::TransformComponent> meshTransformComponent = std::make_shared<ZE::TransformComponent>();
-    meshObject->AddComponent(meshTransformComponent);
+struct SampleResources
+{
+    ZE::TPtr<ZE::MeshResource> mesh;
+    ZE::TPtr<ZE::ShaderResource> vertexShader;
+    ZE::TPtr<ZE::ShaderResource> fragmentShader;
+    ZE::TPtr<ZE::TextureResource> texture;
+};
 
+SampleResources LoadSampleResources()
+{
+    SampleResources resources;
+    resources.mesh = std::make_shared<ZE::MeshResource>("./Samples/Resources/Meshes/viking_room.obj");
+    resources.vertexShader = std::make_shared<ZE::ShaderResource>(ZE::EShaderStage::Vertex, "LocalToClipSpaceVertexShader.glsl");
+    resources.fragmentShader = std::make_shared<ZE::ShaderResource>(ZE::EShaderStage::Fragment, "LambertBlinnPhoneFragmentShader.glsl");
+    resources.texture = std::make_shared<ZE::TextureResource>("./Samples/Resources/Textures/viking_room.png");
 
-    ZE::TPtr<ZE::MeshResource> meshResource =
-        std::make_shared<ZE::MeshResource>("./Samples/Resources/Meshes/viking_room.obj");
-    ZE::TPtr<ZE::ShaderResource> vertexShaderResource =
-        std::make_shared<ZE::ShaderResource>(ZE::EShaderStage::Vertex, "LocalToClipSpaceVertexShader.glsl");
-    ZE::TPtr<ZE::ShaderResource> fragmentShaderResource =
-        std::make_shared<ZE::ShaderResource>(ZE::EShaderStage::Fragment, "LambertBlinnPhoneFragmentShader.glsl");
-    ZE::TPtr<ZE::TextureResource> texture =
-        std::make_shared<ZE::TextureResource>("./Samples/Resources/Textures/viking_room.png");
+    return resources;
+}
 
+ZE::TPtr<ZE::MaterialResource> CreateSampleMaterial(const SampleResources& resources)
+{
     ZE::TPtr<ZE::PassResource> depthPass = std::make_shared<ZE::PassResource>();
     {
-        depthPass->SetShader(ZE::EShaderStage::Vertex, vertexShaderResource);
-        depthPass->SetTexture(ZE::EShaderStage::Fragment, 0, texture);
+        depthPass->SetShader(ZE::EShaderStage::Vertex, resources.vertexShader);
+        depthPass->SetTexture(ZE::EShaderStage::Fragment, 0, resources.texture);
 
         ZE::DepthStencilState depthStencilState;
         depthStencilState.zTestType = ZE::ECompareOperation::Greater;
@@ -47,9 +53,9 @@ ZE::TPtr<ZE::Scene> CreateSampleScene()
 
     ZE::TPtr<ZE::PassResource> pass = std::make_shared<ZE::PassResource>();
     {
-        pass->SetShader(ZE::EShaderStage::Vertex, vertexShaderResource);
-        pass->SetShader(ZE::EShaderStage::Fragment, fragmentShaderResource);
-        pass->SetTexture(ZE::EShaderStage::Fragment, 0, texture);
+        pass->SetShader(ZE::EShaderStage::Vertex, resources.vertexShader);
+        pass->SetShader(ZE::EShaderStage::Fragment, resources.fragmentShader);
+        pass->SetTexture(ZE::EShaderStage::Fragment, 0, resources.texture);
 
         ZE::DepthStencilState depthStencilState;
         depthStencilState.zTestType = ZE::ECompareOperation::Equal;
@@ -61,12 +67,29 @@ ZE::TPtr<ZE::Scene> CreateSampleScene()
     materialResource->SetPass(ZE::EPassType::DepthPass, depthPass);
     materialResource->SetPass(ZE::EPassType::BasePass, pass);
 
+    return materialResource;
+}
+
+ZE::TPtr<ZE::SceneObject> CreateMeshObject(const SampleResources& resources, ZE::TPtr<ZE::MaterialResource> materialResource, const glm::mat4& transform)
+{
+    ZE::TPtr<ZE::SceneObject> meshObject = std::make_shared<ZE::SceneObject>();
+    ZE::TPtr<ZE::TransformComponent> meshTransformComponent = std::make_shared<ZE::TransformComponent>();
+    meshTransformComponent->SetTransform(transform);
+    meshObject->AddComponent(meshTransformComponent);
+
     ZE::TPtr<ZE::MeshComponent> meshComponent = std::make_shared<ZE::MeshComponent>();
-    meshComponent->SetMesh(meshResource);
+    meshComponent->SetMesh(resources.mesh);
     meshComponent->SetMaterial(0, materialResource);
     meshObject->AddComponent(meshComponent);
 
-    scene->AddObject(meshObject);
+    return meshObject;
+}
+
+ZE::TPtr<ZE::Scene> CreateSampleScene(const SampleResources& resources)
+{
+    ZE::TPtr<ZE::Scene> scene = std::make_shared<ZE::Scene>();
+
+    scene->AddObject(CreateMeshObject(resources, CreateSampleMaterial(resources), glm::identity<glm::mat4>()));
 
     ZE::TPtr<ZE::SceneObject> cameraObject = std::make_shared<ZE::SceneObject>();
 
@@ -88,12 +111,85 @@ ZE::TPtr<ZE::Scene> CreateSampleScene()
     return scene;
 }
 
-int main()
+// Churned objects are removed and re-added every period, each with a material of its own. The descriptor sets
+// of removed materials are only freed once the frames in flight are done, so the descriptor pools have to grow
+const uint64_t ChurnPeriod = 30;
+const uint32_t ChurnObjectCount = 200;
+const uint32_t ChurnObjectsPerRow = 20;
+
+ZE::FrameCallback CreateChurnCallback(const SampleResources& resources)
 {
-    ZE::Application app;
+    ZE::TPtrArr<ZE::SceneObject> churnObjects;
+    for (uint32_t i = 0; i < ChurnObjectCount; i++)
+    {
+        glm::vec3 position(static_cast<float>(i % ChurnObjectsPerRow) * 3.0f - 30.0f, static_cast<float>(i / ChurnObjectsPerRow) * 3.0f - 15.0f, -20.0f);
+        churnObjects.push_back(CreateMeshObject(resources, CreateSampleMaterial(resources), glm::translate(glm::identity<glm::mat4>(), position)));
+    }
+
+    // A skipped frame calls again with the same frame number
+    uint64_t lastPeriod = UINT64_MAX;
+    return [churnObjects, lastPeriod](ZE::TPtr<ZE::Scene> scene, uint64_t frameNumber) mutable {
+        uint64_t period = frameNumber / ChurnPeriod;
+        if (period == lastPeriod)
+            return;
+        lastPeriod = period;
+
+        for (const ZE::TPtr<ZE::SceneObject>& object : churnObjects)
+        {
+            if (period % 2 == 0)
+                scene->AddObject(object);
+            else
+                scene->RemoveObject(object);
+        }
+    };
+}
 
-    ZE::TPtr<ZE::Scene> scene = CreateSampleScene();
+int main(int argc, char* argv[])
+{
+    // --headless renders offscreen without a window, --frames N stops after N frames,
+    // --gpu-log prints the GPU pass timings of every frame, --gpu-draw-scopes times every draw,
+    // --cpu-hitches prints the CPU scopes of every hitch,
+    // --gpu-culling culls and generates the draws in a compute dispatch, the lighting pass also skips occluded objects,
+    // --stats prints the engine's counters and profiler reports once the run is over,
+    // --churn keeps removing and re-adding a grid of objects with materials of their own
+    ZE::ApplicationConfig config;
+    bool printStats = false;
+    bool churn = false;
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg(argv[i]);
+        if (arg == "--headless")
+            config.headless = true;
+        else if (arg == "--frames" && i + 1 < argc)
+            config.maxFrames = std::stoull(argv[++i]);
+        else if (arg == "--gpu-log")
+            config.logGpuTimings = true;
+        else if (arg == "--cpu-hitches")
+            config.logCpuHitches = true;
+        else if (arg == "--gpu-draw-scopes")
+            config.gpuDrawScopes = true;
+        else if (arg == "--gpu-culling")
+            config.gpuCulling = true;
+        else if (arg == "--stats")
+            printStats = true;
+        else if (arg == "--churn")
+            churn = true;
+    }
+
+    if (config.headless && config.maxFrames == 0)
+        config.maxFrames = 1000;
+
+    SampleResources resources = LoadSampleResources();
+    if (churn)
+        config.beginFrame = CreateChurnCallback(resources);
+
+    ZE::Application app(config);
+
+    ZE::TPtr<ZE::Scene> scene = CreateSampleScene(resources);
     app.Run(scene);
 
+    if (printStats)
+        app.ReportStats(std::cout);
+
     return 0;
 }
\ No newline at end of file